@@ -2,10 +2,12 @@
 #include <stdlib.h>
 #include <math.h>
 #include <complex>
+#include <vector>
 
 #include <util_quda.h>
 #include <host_utils.h>
 #include <wilson_dslash_reference.h>
+#include <dslash_reference.h>
 
 /**
    @brief Apply the clover matrix field
@@ -76,98 +78,133 @@ void apply_clover(void *out, void *clover, void *in, int parity, QudaPrecision p
 
 }
 
+// Multi-source versions of the site-local terms, applied source by source
+static void apply_clover_msrc(void **out, void *clover, void **in, int nSrc, int parity, QudaPrecision precision)
+{
+  for (int s = 0; s < nSrc; s++) apply_clover(out[s], clover, in[s], parity, precision);
+}
+
+static void xpay_msrc(void **x, double a, void **y, int nSrc, int len, QudaPrecision precision)
+{
+  for (int s = 0; s < nSrc; s++) xpay(x[s], a, y[s], len, precision);
+}
+
 void clover_dslash(void *out, void **gauge, void *clover, void *in, int parity,
 		   int dagger, QudaPrecision precision, QudaGaugeParam &param) {
-  void *tmp = malloc(Vh * spinor_site_size * precision);
+  clover_dslash_msrc(&out, gauge, clover, &in, 1, parity, dagger, precision, param);
+}
+
+void clover_dslash_msrc(void **out, void **gauge, void *clover, void **in, int nSrc, int parity, int dagger,
+                        QudaPrecision precision, QudaGaugeParam &param)
+{
+  const size_t parity_bytes = Vh * spinor_site_size * precision;
+  void *tmp_buffer = malloc(nSrc * parity_bytes);
+  std::vector<void *> tmp_set = fieldSplit(tmp_buffer, nSrc, parity_bytes);
+  void **tmp = tmp_set.data();
 
-  wil_dslash(tmp, gauge, in, parity, dagger, precision, param);
-  apply_clover(out, clover, tmp, parity, precision);
+  wil_dslash_msrc(tmp, gauge, in, nSrc, parity, dagger, precision, param);
+  apply_clover_msrc(out, clover, tmp, nSrc, parity, precision);
 
-  free(tmp);
+  free(tmp_buffer);
 }
 
 // Apply the even-odd preconditioned Wilson-clover operator
 void clover_matpc(void *out, void **gauge, void *clover, void *clover_inv, void *in, double kappa, 
 		  QudaMatPCType matpc_type, int dagger, QudaPrecision precision, QudaGaugeParam &gauge_param) {
+  clover_matpc_msrc(&out, gauge, clover, clover_inv, &in, 1, kappa, matpc_type, dagger, precision, gauge_param);
+}
 
+void clover_matpc_msrc(void **out, void **gauge, void *clover, void *clover_inv, void **in, int nSrc, double kappa,
+                       QudaMatPCType matpc_type, int dagger, QudaPrecision precision, QudaGaugeParam &gauge_param)
+{
   double kappa2 = -kappa*kappa;
-  void *tmp = malloc(Vh * spinor_site_size * precision);
+  const size_t parity_bytes = Vh * spinor_site_size * precision;
+  void *tmp_buffer = malloc(nSrc * parity_bytes);
+  std::vector<void *> tmp_set = fieldSplit(tmp_buffer, nSrc, parity_bytes);
+  void **tmp = tmp_set.data();
 
   switch(matpc_type) {
   case QUDA_MATPC_EVEN_EVEN:
     if (!dagger) {
-      wil_dslash(tmp, gauge, in, 1, dagger, precision, gauge_param);
-      apply_clover(out, clover_inv, tmp, 1, precision);
-      wil_dslash(tmp, gauge, out, 0, dagger, precision, gauge_param);
-      apply_clover(out, clover_inv, tmp, 0, precision);
+      wil_dslash_msrc(tmp, gauge, in, nSrc, 1, dagger, precision, gauge_param);
+      apply_clover_msrc(out, clover_inv, tmp, nSrc, 1, precision);
+      wil_dslash_msrc(tmp, gauge, out, nSrc, 0, dagger, precision, gauge_param);
+      apply_clover_msrc(out, clover_inv, tmp, nSrc, 0, precision);
     } else {
-      apply_clover(tmp, clover_inv, in, 0, precision);
-      wil_dslash(out, gauge, tmp, 1, dagger, precision, gauge_param);
-      apply_clover(tmp, clover_inv, out, 1, precision);
-      wil_dslash(out, gauge, tmp, 0, dagger, precision, gauge_param);
+      apply_clover_msrc(tmp, clover_inv, in, nSrc, 0, precision);
+      wil_dslash_msrc(out, gauge, tmp, nSrc, 1, dagger, precision, gauge_param);
+      apply_clover_msrc(tmp, clover_inv, out, nSrc, 1, precision);
+      wil_dslash_msrc(out, gauge, tmp, nSrc, 0, dagger, precision, gauge_param);
     }
-    xpay(in, kappa2, out, Vh * spinor_site_size, precision);
+    xpay_msrc(in, kappa2, out, nSrc, Vh * spinor_site_size, precision);
     break;
   case QUDA_MATPC_EVEN_EVEN_ASYMMETRIC:
-    wil_dslash(out, gauge, in, 1, dagger, precision, gauge_param);
-    apply_clover(tmp, clover_inv, out, 1, precision);
-    wil_dslash(out, gauge, tmp, 0, dagger, precision, gauge_param);
-    apply_clover(tmp, clover, in, 0, precision);
-    xpay(tmp, kappa2, out, Vh * spinor_site_size, precision);
+    wil_dslash_msrc(out, gauge, in, nSrc, 1, dagger, precision, gauge_param);
+    apply_clover_msrc(tmp, clover_inv, out, nSrc, 1, precision);
+    wil_dslash_msrc(out, gauge, tmp, nSrc, 0, dagger, precision, gauge_param);
+    apply_clover_msrc(tmp, clover, in, nSrc, 0, precision);
+    xpay_msrc(tmp, kappa2, out, nSrc, Vh * spinor_site_size, precision);
     break;
   case QUDA_MATPC_ODD_ODD:
     if (!dagger) {
-      wil_dslash(tmp, gauge, in, 0, dagger, precision, gauge_param);
-      apply_clover(out, clover_inv, tmp, 0, precision);
-      wil_dslash(tmp, gauge, out, 1, dagger, precision, gauge_param);
-      apply_clover(out, clover_inv, tmp, 1, precision);
+      wil_dslash_msrc(tmp, gauge, in, nSrc, 0, dagger, precision, gauge_param);
+      apply_clover_msrc(out, clover_inv, tmp, nSrc, 0, precision);
+      wil_dslash_msrc(tmp, gauge, out, nSrc, 1, dagger, precision, gauge_param);
+      apply_clover_msrc(out, clover_inv, tmp, nSrc, 1, precision);
     } else {
-      apply_clover(tmp, clover_inv, in, 1, precision);
-      wil_dslash(out, gauge, tmp, 0, dagger, precision, gauge_param);
-      apply_clover(tmp, clover_inv, out, 0, precision);
-      wil_dslash(out, gauge, tmp, 1, dagger, precision, gauge_param);
+      apply_clover_msrc(tmp, clover_inv, in, nSrc, 1, precision);
+      wil_dslash_msrc(out, gauge, tmp, nSrc, 0, dagger, precision, gauge_param);
+      apply_clover_msrc(tmp, clover_inv, out, nSrc, 0, precision);
+      wil_dslash_msrc(out, gauge, tmp, nSrc, 1, dagger, precision, gauge_param);
     }
-    xpay(in, kappa2, out, Vh * spinor_site_size, precision);
+    xpay_msrc(in, kappa2, out, nSrc, Vh * spinor_site_size, precision);
     break;
   case QUDA_MATPC_ODD_ODD_ASYMMETRIC:
-    wil_dslash(out, gauge, in, 0, dagger, precision, gauge_param);
-    apply_clover(tmp, clover_inv, out, 0, precision);
-    wil_dslash(out, gauge, tmp, 1, dagger, precision, gauge_param);
-    apply_clover(tmp, clover, in, 1, precision);
-    xpay(tmp, kappa2, out, Vh * spinor_site_size, precision);
+    wil_dslash_msrc(out, gauge, in, nSrc, 0, dagger, precision, gauge_param);
+    apply_clover_msrc(tmp, clover_inv, out, nSrc, 0, precision);
+    wil_dslash_msrc(out, gauge, tmp, nSrc, 1, dagger, precision, gauge_param);
+    apply_clover_msrc(tmp, clover, in, nSrc, 1, precision);
+    xpay_msrc(tmp, kappa2, out, nSrc, Vh * spinor_site_size, precision);
     break;
   default:
     errorQuda("Unsupoorted matpc=%d", matpc_type);
   }
 
-  free(tmp);
+  free(tmp_buffer);
 }
 
 // Apply the full Wilson-clover operator
 void clover_mat(void *out, void **gauge, void *clover, void *in, double kappa, 
 		int dagger, QudaPrecision precision, QudaGaugeParam &gauge_param) {
+  clover_mat_msrc(&out, gauge, clover, &in, 1, kappa, dagger, precision, gauge_param);
+}
 
-  void *tmp = malloc(V * spinor_site_size * precision);
+void clover_mat_msrc(void **out, void **gauge, void *clover, void **in, int nSrc, double kappa, int dagger,
+                     QudaPrecision precision, QudaGaugeParam &gauge_param)
+{
+  const size_t parity_bytes = Vh * spinor_site_size * precision;
+  void *tmp_buffer = malloc(nSrc * 2 * parity_bytes);
+  std::vector<void *> tmp = fieldSplit(tmp_buffer, nSrc, 2 * parity_bytes);
 
-  void *inEven = in;
-  void *inOdd = (char *)in + Vh * spinor_site_size * precision;
-  void *outEven = out;
-  void *outOdd = (char *)out + Vh * spinor_site_size * precision;
-  void *tmpEven = tmp;
-  void *tmpOdd = (char *)tmp + Vh * spinor_site_size * precision;
+  void **inEven = in;
+  std::vector<void *> inOdd = fieldOffset(in, nSrc, parity_bytes);
+  void **outEven = out;
+  std::vector<void *> outOdd = fieldOffset(out, nSrc, parity_bytes);
+  void **tmpEven = tmp.data();
+  std::vector<void *> tmpOdd = fieldOffset(tmp.data(), nSrc, parity_bytes);
 
   // Odd part
-  wil_dslash(outOdd, gauge, inEven, 1, dagger, precision, gauge_param);
-  apply_clover(tmpOdd, clover, inOdd, 1, precision);
+  wil_dslash_msrc(outOdd.data(), gauge, inEven, nSrc, 1, dagger, precision, gauge_param);
+  apply_clover_msrc(tmpOdd.data(), clover, inOdd.data(), nSrc, 1, precision);
 
   // Even part
-  wil_dslash(outEven, gauge, inOdd, 0, dagger, precision, gauge_param);
-  apply_clover(tmpEven, clover, inEven, 0, precision);
+  wil_dslash_msrc(outEven, gauge, inOdd.data(), nSrc, 0, dagger, precision, gauge_param);
+  apply_clover_msrc(tmpEven, clover, inEven, nSrc, 0, precision);
 
   // lastly apply the kappa term
-  xpay(tmp, -kappa, out, V * spinor_site_size, precision);
+  xpay_msrc(tmp.data(), -kappa, out, nSrc, V * spinor_site_size, precision);
 
-  free(tmp);
+  free(tmp_buffer);
 }
 
 void applyTwist(void *out, void *in, void *tmpH, double a, QudaPrecision precision) {
@@ -241,113 +278,147 @@ void twistCloverGamma5(void *out, void *in, void *clover, void *cInv, const int
   free(tmp1);
 }
 
+static void twistCloverGamma5_msrc(void **out, void **in, int nSrc, void *clover, void *cInv, const int dagger,
+                                   const double kappa, const double mu, const QudaTwistFlavorType flavor,
+                                   const int parity, QudaTwistGamma5Type twist, QudaPrecision precision)
+{
+  for (int s = 0; s < nSrc; s++)
+    twistCloverGamma5(out[s], in[s], clover, cInv, dagger, kappa, mu, flavor, parity, twist, precision);
+}
+
 void tmc_dslash(void *out, void **gauge, void *in, void *clover, void *cInv, double kappa, double mu, QudaTwistFlavorType flavor,
 		int parity, QudaMatPCType matpc_type, int dagger, QudaPrecision precision, QudaGaugeParam &param) {
-  void *tmp1 = malloc(Vh * spinor_site_size * precision);
-  void *tmp2 = malloc(Vh * spinor_site_size * precision);
+  tmc_dslash_msrc(&out, gauge, &in, 1, clover, cInv, kappa, mu, flavor, parity, matpc_type, dagger, precision, param);
+}
+
+void tmc_dslash_msrc(void **out, void **gauge, void **in, int nSrc, void *clover, void *cInv, double kappa, double mu,
+                     QudaTwistFlavorType flavor, int parity, QudaMatPCType matpc_type, int dagger,
+                     QudaPrecision precision, QudaGaugeParam &param)
+{
+  const size_t parity_bytes = Vh * spinor_site_size * precision;
+  void *tmp_buffer = malloc(2 * nSrc * parity_bytes);
+  std::vector<void *> tmp1_set = fieldSplit(tmp_buffer, nSrc, parity_bytes);
+  std::vector<void *> tmp2_set = fieldOffset(tmp1_set.data(), nSrc, nSrc * parity_bytes);
+  void **tmp1 = tmp1_set.data();
+  void **tmp2 = tmp2_set.data();
 
   if (dagger) {
-    twistCloverGamma5(tmp1, in, clover, cInv, dagger, kappa, mu, flavor, 1-parity, QUDA_TWIST_GAMMA5_INVERSE, precision);
+    twistCloverGamma5_msrc(tmp1, in, nSrc, clover, cInv, dagger, kappa, mu, flavor, 1-parity, QUDA_TWIST_GAMMA5_INVERSE, precision);
     if (matpc_type == QUDA_MATPC_EVEN_EVEN_ASYMMETRIC || matpc_type == QUDA_MATPC_ODD_ODD_ASYMMETRIC) {
-      wil_dslash(tmp2, gauge, tmp1, parity, dagger, precision, param);
-      twistCloverGamma5(out, tmp2, clover, cInv, dagger, kappa, mu, flavor, parity, QUDA_TWIST_GAMMA5_INVERSE, precision);
+      wil_dslash_msrc(tmp2, gauge, tmp1, nSrc, parity, dagger, precision, param);
+      twistCloverGamma5_msrc(out, tmp2, nSrc, clover, cInv, dagger, kappa, mu, flavor, parity, QUDA_TWIST_GAMMA5_INVERSE, precision);
     } else {
-      wil_dslash(out, gauge, tmp1, parity, dagger, precision, param);
+      wil_dslash_msrc(out, gauge, tmp1, nSrc, parity, dagger, precision, param);
     } 
   } else {
-    wil_dslash(tmp1, gauge, in, parity, dagger, precision, param);
-    twistCloverGamma5(out, tmp1, clover, cInv, dagger, kappa, mu, flavor, parity, QUDA_TWIST_GAMMA5_INVERSE, precision);
+    wil_dslash_msrc(tmp1, gauge, in, nSrc, parity, dagger, precision, param);
+    twistCloverGamma5_msrc(out, tmp1, nSrc, clover, cInv, dagger, kappa, mu, flavor, parity, QUDA_TWIST_GAMMA5_INVERSE, precision);
   }
 
-  free(tmp2);
-  free(tmp1);
+  free(tmp_buffer);
 }
 
 // Apply the full twisted-clover operator
 void tmc_mat(void *out, void **gauge, void *clover, void *in, double kappa, double mu,
 	     QudaTwistFlavorType flavor, int dagger, QudaPrecision precision, QudaGaugeParam &gauge_param) {
+  tmc_mat_msrc(&out, gauge, clover, &in, 1, kappa, mu, flavor, dagger, precision, gauge_param);
+}
 
-  void *tmp = malloc(V * spinor_site_size * precision);
+void tmc_mat_msrc(void **out, void **gauge, void *clover, void **in, int nSrc, double kappa, double mu,
+                  QudaTwistFlavorType flavor, int dagger, QudaPrecision precision, QudaGaugeParam &gauge_param)
+{
+  const size_t parity_bytes = Vh * spinor_site_size * precision;
+  void *tmp_buffer = malloc(nSrc * 2 * parity_bytes);
+  std::vector<void *> tmp = fieldSplit(tmp_buffer, nSrc, 2 * parity_bytes);
 
-  void *inEven = in;
-  void *inOdd = (char *)in + Vh * spinor_site_size * precision;
-  void *outEven = out;
-  void *outOdd = (char *)out + Vh * spinor_site_size * precision;
-  void *tmpEven = tmp;
-  void *tmpOdd = (char *)tmp + Vh * spinor_site_size * precision;
+  void **inEven = in;
+  std::vector<void *> inOdd = fieldOffset(in, nSrc, parity_bytes);
+  void **outEven = out;
+  std::vector<void *> outOdd = fieldOffset(out, nSrc, parity_bytes);
+  void **tmpEven = tmp.data();
+  std::vector<void *> tmpOdd = fieldOffset(tmp.data(), nSrc, parity_bytes);
 
   // Odd part
-  wil_dslash(outOdd, gauge, inEven, 1, dagger, precision, gauge_param);
-  twistCloverGamma5(tmpOdd, inOdd, clover, NULL, dagger, kappa, mu, flavor, 1, QUDA_TWIST_GAMMA5_DIRECT, precision);
+  wil_dslash_msrc(outOdd.data(), gauge, inEven, nSrc, 1, dagger, precision, gauge_param);
+  twistCloverGamma5_msrc(tmpOdd.data(), inOdd.data(), nSrc, clover, NULL, dagger, kappa, mu, flavor, 1, QUDA_TWIST_GAMMA5_DIRECT, precision);
 
   // Even part
-  wil_dslash(outEven, gauge, inOdd, 0, dagger, precision, gauge_param);
-  twistCloverGamma5(tmpEven, inEven, clover, NULL, dagger, kappa, mu, flavor, 0, QUDA_TWIST_GAMMA5_DIRECT, precision);
+  wil_dslash_msrc(outEven, gauge, inOdd.data(), nSrc, 0, dagger, precision, gauge_param);
+  twistCloverGamma5_msrc(tmpEven, inEven, nSrc, clover, NULL, dagger, kappa, mu, flavor, 0, QUDA_TWIST_GAMMA5_DIRECT, precision);
 
   // lastly apply the kappa term
-  xpay(tmp, -kappa, out, V * spinor_site_size, precision);
+  xpay_msrc(tmp.data(), -kappa, out, nSrc, V * spinor_site_size, precision);
 
-  free(tmp);
+  free(tmp_buffer);
 }
 
 // Apply the even-odd preconditioned Dirac operator
 void tmc_matpc(void *out, void **gauge, void *in, void *clover, void *cInv, double kappa, double mu, QudaTwistFlavorType flavor,
               QudaMatPCType matpc_type, int dagger, QudaPrecision precision, QudaGaugeParam &gauge_param) {
+  tmc_matpc_msrc(&out, gauge, &in, 1, clover, cInv, kappa, mu, flavor, matpc_type, dagger, precision, gauge_param);
+}
 
+void tmc_matpc_msrc(void **out, void **gauge, void **in, int nSrc, void *clover, void *cInv, double kappa, double mu,
+                    QudaTwistFlavorType flavor, QudaMatPCType matpc_type, int dagger, QudaPrecision precision,
+                    QudaGaugeParam &gauge_param)
+{
   double kappa2 = -kappa*kappa;
 
-  void *tmp1 = malloc(Vh * spinor_site_size * precision);
-  void *tmp2 = malloc(Vh * spinor_site_size * precision);
+  const size_t parity_bytes = Vh * spinor_site_size * precision;
+  void *tmp_buffer = malloc(2 * nSrc * parity_bytes);
+  std::vector<void *> tmp1_set = fieldSplit(tmp_buffer, nSrc, parity_bytes);
+  std::vector<void *> tmp2_set = fieldOffset(tmp1_set.data(), nSrc, nSrc * parity_bytes);
+  void **tmp1 = tmp1_set.data();
+  void **tmp2 = tmp2_set.data();
 
   switch(matpc_type) {
   case QUDA_MATPC_EVEN_EVEN:
     if (!dagger) {
-      wil_dslash(out, gauge, in, 1, dagger, precision, gauge_param);
-      twistCloverGamma5(tmp1, out, clover, cInv, dagger, kappa, mu, flavor, 1, QUDA_TWIST_GAMMA5_INVERSE, precision);
-      wil_dslash(tmp2, gauge, tmp1, 0, dagger, precision, gauge_param);
-      twistCloverGamma5(out, tmp2, clover, cInv, dagger, kappa, mu, flavor, 0, QUDA_TWIST_GAMMA5_INVERSE, precision);
+      wil_dslash_msrc(out, gauge, in, nSrc, 1, dagger, precision, gauge_param);
+      twistCloverGamma5_msrc(tmp1, out, nSrc, clover, cInv, dagger, kappa, mu, flavor, 1, QUDA_TWIST_GAMMA5_INVERSE, precision);
+      wil_dslash_msrc(tmp2, gauge, tmp1, nSrc, 0, dagger, precision, gauge_param);
+      twistCloverGamma5_msrc(out, tmp2, nSrc, clover, cInv, dagger, kappa, mu, flavor, 0, QUDA_TWIST_GAMMA5_INVERSE, precision);
     } else {
-      twistCloverGamma5(out, in, clover, cInv, dagger, kappa, mu, flavor, 0, QUDA_TWIST_GAMMA5_INVERSE, precision);
-      wil_dslash(tmp1, gauge, out, 1, dagger, precision, gauge_param);
-      twistCloverGamma5(tmp2, tmp1, clover, cInv, dagger, kappa, mu, flavor, 1, QUDA_TWIST_GAMMA5_INVERSE, precision);
-      wil_dslash(out, gauge, tmp2, 0, dagger, precision, gauge_param);
+      twistCloverGamma5_msrc(out, in, nSrc, clover, cInv, dagger, kappa, mu, flavor, 0, QUDA_TWIST_GAMMA5_INVERSE, precision);
+      wil_dslash_msrc(tmp1, gauge, out, nSrc, 1, dagger, precision, gauge_param);
+      twistCloverGamma5_msrc(tmp2, tmp1, nSrc, clover, cInv, dagger, kappa, mu, flavor, 1, QUDA_TWIST_GAMMA5_INVERSE, precision);
+      wil_dslash_msrc(out, gauge, tmp2, nSrc, 0, dagger, precision, gauge_param);
     }
-    xpay(in, kappa2, out, Vh * spinor_site_size, precision);
+    xpay_msrc(in, kappa2, out, nSrc, Vh * spinor_site_size, precision);
     break;
   case QUDA_MATPC_EVEN_EVEN_ASYMMETRIC:
-    wil_dslash(tmp1, gauge, in, 1, dagger, precision, gauge_param);
-    twistCloverGamma5(tmp2, tmp1, clover, cInv, dagger, kappa, mu, flavor, 1, QUDA_TWIST_GAMMA5_INVERSE, precision);
-    wil_dslash(out, gauge, tmp2, 0, dagger, precision, gauge_param);
-    twistCloverGamma5(tmp2, in, clover, cInv, dagger, kappa, mu, flavor, 0, QUDA_TWIST_GAMMA5_DIRECT, precision);
-    xpay(tmp2, kappa2, out, Vh * spinor_site_size, precision);
+    wil_dslash_msrc(tmp1, gauge, in, nSrc, 1, dagger, precision, gauge_param);
+    twistCloverGamma5_msrc(tmp2, tmp1, nSrc, clover, cInv, dagger, kappa, mu, flavor, 1, QUDA_TWIST_GAMMA5_INVERSE, precision);
+    wil_dslash_msrc(out, gauge, tmp2, nSrc, 0, dagger, precision, gauge_param);
+    twistCloverGamma5_msrc(tmp2, in, nSrc, clover, cInv, dagger, kappa, mu, flavor, 0, QUDA_TWIST_GAMMA5_DIRECT, precision);
+    xpay_msrc(tmp2, kappa2, out, nSrc, Vh * spinor_site_size, precision);
     break;
   case QUDA_MATPC_ODD_ODD:
     if (!dagger) {
-      wil_dslash(out, gauge, in, 0, dagger, precision, gauge_param);
-      twistCloverGamma5(tmp1, out, clover, cInv, dagger, kappa, mu, flavor, 0, QUDA_TWIST_GAMMA5_INVERSE, precision);
-      wil_dslash(tmp2, gauge, tmp1, 1, dagger, precision, gauge_param);
-      twistCloverGamma5(out, tmp2, clover, cInv, dagger, kappa, mu, flavor, 1, QUDA_TWIST_GAMMA5_INVERSE, precision);
+      wil_dslash_msrc(out, gauge, in, nSrc, 0, dagger, precision, gauge_param);
+      twistCloverGamma5_msrc(tmp1, out, nSrc, clover, cInv, dagger, kappa, mu, flavor, 0, QUDA_TWIST_GAMMA5_INVERSE, precision);
+      wil_dslash_msrc(tmp2, gauge, tmp1, nSrc, 1, dagger, precision, gauge_param);
+      twistCloverGamma5_msrc(out, tmp2, nSrc, clover, cInv, dagger, kappa, mu, flavor, 1, QUDA_TWIST_GAMMA5_INVERSE, precision);
     } else {
-      twistCloverGamma5(out, in, clover, cInv, dagger, kappa, mu, flavor, 1, QUDA_TWIST_GAMMA5_INVERSE, precision);
-      wil_dslash(tmp1, gauge, out, 0, dagger, precision, gauge_param);
-      twistCloverGamma5(tmp2, tmp1, clover, cInv, dagger, kappa, mu, flavor, 0, QUDA_TWIST_GAMMA5_INVERSE, precision);
-      wil_dslash(out, gauge, tmp2, 1, dagger, precision, gauge_param);
+      twistCloverGamma5_msrc(out, in, nSrc, clover, cInv, dagger, kappa, mu, flavor, 1, QUDA_TWIST_GAMMA5_INVERSE, precision);
+      wil_dslash_msrc(tmp1, gauge, out, nSrc, 0, dagger, precision, gauge_param);
+      twistCloverGamma5_msrc(tmp2, tmp1, nSrc, clover, cInv, dagger, kappa, mu, flavor, 0, QUDA_TWIST_GAMMA5_INVERSE, precision);
+      wil_dslash_msrc(out, gauge, tmp2, nSrc, 1, dagger, precision, gauge_param);
     }
-    xpay(in, kappa2, out, Vh * spinor_site_size, precision);
+    xpay_msrc(in, kappa2, out, nSrc, Vh * spinor_site_size, precision);
     break;
   case QUDA_MATPC_ODD_ODD_ASYMMETRIC:
-    wil_dslash(tmp1, gauge, in, 0, dagger, precision, gauge_param);
-    twistCloverGamma5(tmp2, tmp1, clover, cInv, dagger, kappa, mu, flavor, 0, QUDA_TWIST_GAMMA5_INVERSE, precision);
-    wil_dslash(out, gauge, tmp2, 1, dagger, precision, gauge_param);
-    twistCloverGamma5(tmp1, in, clover, cInv, dagger, kappa, mu, flavor, 1, QUDA_TWIST_GAMMA5_DIRECT, precision);
-    xpay(tmp1, kappa2, out, Vh * spinor_site_size, precision);
+    wil_dslash_msrc(tmp1, gauge, in, nSrc, 0, dagger, precision, gauge_param);
+    twistCloverGamma5_msrc(tmp2, tmp1, nSrc, clover, cInv, dagger, kappa, mu, flavor, 0, QUDA_TWIST_GAMMA5_INVERSE, precision);
+    wil_dslash_msrc(out, gauge, tmp2, nSrc, 1, dagger, precision, gauge_param);
+    twistCloverGamma5_msrc(tmp1, in, nSrc, clover, cInv, dagger, kappa, mu, flavor, 1, QUDA_TWIST_GAMMA5_DIRECT, precision);
+    xpay_msrc(tmp1, kappa2, out, nSrc, Vh * spinor_site_size, precision);
     break;
   default:
     errorQuda("Unsupported matpc=%d", matpc_type);
   }
 
-  free(tmp2);
-  free(tmp1);
+  free(tmp_buffer);
 }
 
 // Apply the full twisted-clover operator
@@ -52,20 +52,27 @@ void covdevReference(sFloat *res, gFloat **link, sFloat *spinorField,
     linkOdd[dir] = link[dir] + Vh * gauge_site_size;
   }
 
+  const NeighborTable &neighbor = getNeighborTable(Z, oddBit, 1, false);
+  // backwards links live on the other parity
+  gFloat **linkThis = oddBit ? linkOdd : linkEven;
+  gFloat **linkOther = oddBit ? linkEven : linkOdd;
+
   for (int sid = 0; sid < Vh; sid++) {
     int offset = my_spinor_site_size * sid;
 
     sFloat gaugedSpinor[my_spinor_site_size];
 
-    gFloat *lnk    = gaugeLink(sid, mu, oddBit, linkEven, linkOdd, 1);
-    sFloat *spinor = spinorNeighbor(sid, mu, oddBit, spinorField, 1);
+    const NeighborTable::Neighbor &nbr = neighbor.neighbor(sid, mu);
+    gFloat *lnk = mu % 2 == 0 ? &linkThis[mu / 2][sid * gauge_site_size] :
+                                &linkOther[mu / 2][nbr.idx * gauge_site_size];
+    sFloat *spinor = &spinorField[nbr.idx * my_spinor_site_size];
 
     if (daggerBit) {
       for (int s = 0; s < 4; s++)
-        su3Tmul(&gaugedSpinor[s*6], lnk, &spinor[s*6]);
+        su3AdjMatVec(&gaugedSpinor[s*6], lnk, &spinor[s*6]);
     } else {
       for (int s = 0; s < 4; s++)
-        su3Mul (&gaugedSpinor[s*6], lnk, &spinor[s*6]);
+        su3MatVec(&gaugedSpinor[s*6], lnk, &spinor[s*6]);
     }
 
     sum(&res[offset], &res[offset], gaugedSpinor, my_spinor_site_size);
@@ -194,20 +201,37 @@ void covdevReference_mg4dir(sFloat *res, gFloat **link, gFloat **ghostLink, sFlo
     ghostLinkOdd[dir] = ghostLink[dir] + (faceVolume[dir] / 2) * gauge_site_size;
   }
 
+  const NeighborTable &neighbor = getNeighborTable(Z, oddBit);
+  gFloat **linkThis = oddBit ? linkOdd : linkEven;
+  gFloat **linkOther = oddBit ? linkEven : linkOdd;
+  gFloat **ghostLinkOther = oddBit ? ghostLinkEven : ghostLinkOdd;
+  sFloat **ghostSpinor = mu % 2 == 0 ? fwd_nbr_spinor : back_nbr_spinor;
+
   for (int sid = 0; sid < Vh; sid++) {
     int offset = my_spinor_site_size * sid;
 
-    gFloat *lnk    = gaugeLink_mg4dir(sid, mu, oddBit, linkEven, linkOdd, ghostLinkEven, ghostLinkOdd, 1, 1);
-    sFloat *spinor = spinorNeighbor_mg4dir(sid, mu, oddBit, spinorField, fwd_nbr_spinor, back_nbr_spinor, 1, 1);
+    const NeighborTable::Neighbor &nbr = neighbor.neighbor(sid, mu);
+    const bool ghost = nbr.depth >= 0;
+
+    gFloat *lnk;
+    if (mu % 2 == 0)
+      lnk = &linkThis[mu / 2][sid * gauge_site_size];
+    else if (ghost)
+      lnk = &ghostLinkOther[mu / 2][neighbor.ghostOffset(nbr, mu, 1) * gauge_site_size];
+    else
+      lnk = &linkOther[mu / 2][nbr.idx * gauge_site_size];
+
+    sFloat *spinor = ghost ? &ghostSpinor[mu / 2][neighbor.ghostOffset(nbr, mu, 1) * my_spinor_site_size] :
+                             &spinorField[nbr.idx * my_spinor_site_size];
 
     sFloat gaugedSpinor[my_spinor_site_size];
 
     if (daggerBit) {
       for (int s = 0; s < 4; s++)
-        su3Tmul(&gaugedSpinor[s*6], lnk, &spinor[s*6]);
+        su3AdjMatVec(&gaugedSpinor[s*6], lnk, &spinor[s*6]);
     } else {
       for (int s = 0; s < 4; s++)
-        su3Mul (&gaugedSpinor[s*6], lnk, &spinor[s*6]);
+        su3MatVec(&gaugedSpinor[s*6], lnk, &spinor[s*6]);
     }
     sum(&res[offset], &res[offset], gaugedSpinor, my_spinor_site_size);
   } // 4-d volume
@@ -4,6 +4,9 @@
 #include <string.h>
 #include <math.h>
 #include <complex.h>
+#include <memory>
+#include <type_traits>
+#include <vector>
 
 #include <quda.h>
 #include <host_utils.h>
@@ -15,244 +18,6 @@
 
 using namespace quda;
 
-// i represents a "half index" into an even or odd "half lattice".
-// when oddBit={0,1} the half lattice is {even,odd}.
-// 
-// the displacements, such as dx, refer to the full lattice coordinates. 
-//
-// neighborIndex() takes a "half index", displaces it, and returns the
-// new "half index", which can be an index into either the even or odd lattices.
-// displacements of magnitude one always interchange odd and even lattices.
-//
-//
-int neighborIndex_4d(int i, int oddBit, int dx4, int dx3, int dx2, int dx1) {
-  // On input i should be in the range [0 , ... , Z[0]*Z[1]*Z[2]*Z[3]/2-1].
-  if (i < 0 || i >= (Z[0]*Z[1]*Z[2]*Z[3]/2))
-    { printf("i out of range in neighborIndex_4d\n"); exit(-1); }
-  // Compute the linear index.  Then dissect.
-  // fullLatticeIndex_4d is in util_quda.cpp.
-  // The gauge fields live on a 4d sublattice.
-  int X = fullLatticeIndex_4d(i, oddBit);
-  int x4 = X/(Z[2]*Z[1]*Z[0]);
-  int x3 = (X/(Z[1]*Z[0])) % Z[2];
-  int x2 = (X/Z[0]) % Z[1];
-  int x1 = X % Z[0];
-
-  x4 = (x4+dx4+Z[3]) % Z[3];
-  x3 = (x3+dx3+Z[2]) % Z[2];
-  x2 = (x2+dx2+Z[1]) % Z[1];
-  x1 = (x1+dx1+Z[0]) % Z[0];
-
-  return (x4*(Z[2]*Z[1]*Z[0]) + x3*(Z[1]*Z[0]) + x2*(Z[0]) + x1) / 2;
-}
-
-
-
-//#ifndef MULTI_GPU
-// This is just a copy of gaugeLink() from the quda code, except
-// that neighborIndex() is replaced by the renamed version
-// neighborIndex_4d().
-//ok
-template <typename Float>
-Float *gaugeLink_sgpu(int i, int dir, int oddBit, Float **gaugeEven,
-                Float **gaugeOdd) {
-  Float **gaugeField;
-  int j;
-  
-  // If going forward, just grab link at site, U_\mu(x).
-  if (dir % 2 == 0) {
-    j = i;
-    // j will get used in the return statement below.
-    gaugeField = (oddBit ? gaugeOdd : gaugeEven);
-  } else {
-    // If going backward, a shift must occur, U_\mu(x-\muhat)^\dagger;
-    // dagger happens elsewhere, here we're just doing index gymnastics.
-    switch (dir) {
-    case 1: j = neighborIndex_4d(i, oddBit, 0, 0, 0, -1); break;
-    case 3: j = neighborIndex_4d(i, oddBit, 0, 0, -1, 0); break;
-    case 5: j = neighborIndex_4d(i, oddBit, 0, -1, 0, 0); break;
-    case 7: j = neighborIndex_4d(i, oddBit, -1, 0, 0, 0); break;
-    default: j = -1; break;
-    }
-    gaugeField = (oddBit ? gaugeEven : gaugeOdd);
-  }
-  
-  return &gaugeField[dir/2][j*(3*3*2)];
-}
-
-
-//#else
-
-//Standard 4d version (nothing to change)
-template <typename Float>
-Float *gaugeLink_mgpu(int i, int dir, int oddBit, Float **gaugeEven, Float **gaugeOdd, Float** ghostGaugeEven, Float** ghostGaugeOdd, int n_ghost_faces, int nbr_distance) {
-  Float **gaugeField;
-  int j;
-  int d = nbr_distance;
-  if (dir % 2 == 0) {
-    j = i;
-    gaugeField = (oddBit ? gaugeOdd : gaugeEven);
-  }
-  else {
-
-    int Y = fullLatticeIndex(i, oddBit);
-    int x4 = Y/(Z[2]*Z[1]*Z[0]);
-    int x3 = (Y/(Z[1]*Z[0])) % Z[2];
-    int x2 = (Y/Z[0]) % Z[1];
-    int x1 = Y % Z[0];
-    int X1= Z[0];
-    int X2= Z[1];
-    int X3= Z[2];
-    int X4= Z[3];
-    Float* ghostGaugeField;
-
-    switch (dir) {
-    case 1:
-      { //-X direction
-        int new_x1 = (x1 - d + X1 )% X1;
-        if (x1 -d < 0 && comm_dim_partitioned(0)){
-	  ghostGaugeField = (oddBit?ghostGaugeEven[0]: ghostGaugeOdd[0]);
-	  int offset = (n_ghost_faces + x1 -d)*X4*X3*X2/2 + (x4*X3*X2 + x3*X2+x2)/2;
-	  return &ghostGaugeField[offset*(3*3*2)];
-        }
-        j = (x4*X3*X2*X1 + x3*X2*X1 + x2*X1 + new_x1) / 2;
-        break;
-      }
-    case 3:
-      { //-Y direction
-        int new_x2 = (x2 - d + X2 )% X2;
-        if (x2 -d < 0 && comm_dim_partitioned(1)){
-          ghostGaugeField = (oddBit?ghostGaugeEven[1]: ghostGaugeOdd[1]);
-          int offset = (n_ghost_faces + x2 -d)*X4*X3*X1/2 + (x4*X3*X1 + x3*X1+x1)/2;
-          return &ghostGaugeField[offset*(3*3*2)];
-        }
-        j = (x4*X3*X2*X1 + x3*X2*X1 + new_x2*X1 + x1) / 2;
-        break;
-
-      }
-    case 5:
-      { //-Z direction
-        int new_x3 = (x3 - d + X3 )% X3;
-        if (x3 -d < 0 && comm_dim_partitioned(2)){
-          ghostGaugeField = (oddBit?ghostGaugeEven[2]: ghostGaugeOdd[2]);
-          int offset = (n_ghost_faces + x3 -d)*X4*X2*X1/2 + (x4*X2*X1 + x2*X1+x1)/2;
-          return &ghostGaugeField[offset*(3*3*2)];
-        }
-        j = (x4*X3*X2*X1 + new_x3*X2*X1 + x2*X1 + x1) / 2;
-        break;
-      }
-    case 7:
-      { //-T direction
-        int new_x4 = (x4 - d + X4)% X4;
-        if (x4 -d < 0 && comm_dim_partitioned(3)){
-          ghostGaugeField = (oddBit?ghostGaugeEven[3]: ghostGaugeOdd[3]);
-          int offset = (n_ghost_faces + x4 -d)*X1*X2*X3/2 + (x3*X2*X1 + x2*X1+x1)/2;
-          return &ghostGaugeField[offset*(3*3*2)];
-        }
-        j = (new_x4*(X3*X2*X1) + x3*(X2*X1) + x2*(X1) + x1) / 2;
-        break;
-      }//7
-
-    default: j = -1; printf("ERROR: wrong dir \n"); exit(1);
-    }
-    gaugeField = (oddBit ? gaugeEven : gaugeOdd);
-
-  }
-
-  return &gaugeField[dir/2][j*(3*3*2)];
-}
-
-
-//J  Directions 0..7 were used in the 4d code.
-//J  Directions 8,9 will be for P_- and P_+, chiral
-//J  projectors.
-const double projector[10][4][4][2] = {
-  {
-    {{1,0}, {0,0}, {0,0}, {0,-1}},
-    {{0,0}, {1,0}, {0,-1}, {0,0}},
-    {{0,0}, {0,1}, {1,0}, {0,0}},
-    {{0,1}, {0,0}, {0,0}, {1,0}}
-  },
-  {
-    {{1,0}, {0,0}, {0,0}, {0,1}},
-    {{0,0}, {1,0}, {0,1}, {0,0}},
-    {{0,0}, {0,-1}, {1,0}, {0,0}},
-    {{0,-1}, {0,0}, {0,0}, {1,0}}
-  },
-  {
-    {{1,0}, {0,0}, {0,0}, {1,0}},
-    {{0,0}, {1,0}, {-1,0}, {0,0}},
-    {{0,0}, {-1,0}, {1,0}, {0,0}},
-    {{1,0}, {0,0}, {0,0}, {1,0}}
-  },
-  {
-    {{1,0}, {0,0}, {0,0}, {-1,0}},
-    {{0,0}, {1,0}, {1,0}, {0,0}},
-    {{0,0}, {1,0}, {1,0}, {0,0}},
-    {{-1,0}, {0,0}, {0,0}, {1,0}}
-  },
-  {
-    {{1,0}, {0,0}, {0,-1}, {0,0}},
-    {{0,0}, {1,0}, {0,0}, {0,1}},
-    {{0,1}, {0,0}, {1,0}, {0,0}},
-    {{0,0}, {0,-1}, {0,0}, {1,0}}
-  },
-  {
-    {{1,0}, {0,0}, {0,1}, {0,0}},
-    {{0,0}, {1,0}, {0,0}, {0,-1}},
-    {{0,-1}, {0,0}, {1,0}, {0,0}},
-    {{0,0}, {0,1}, {0,0}, {1,0}}
-  },
-  {
-    {{1,0}, {0,0}, {-1,0}, {0,0}},
-    {{0,0}, {1,0}, {0,0}, {-1,0}},
-    {{-1,0}, {0,0}, {1,0}, {0,0}},
-    {{0,0}, {-1,0}, {0,0}, {1,0}}
-  },
-  {
-    {{1,0}, {0,0}, {1,0}, {0,0}},
-    {{0,0}, {1,0}, {0,0}, {1,0}},
-    {{1,0}, {0,0}, {1,0}, {0,0}},
-    {{0,0}, {1,0}, {0,0}, {1,0}}
-  },
-  // P_+ = P_R
-  {
-    {{0,0}, {0,0}, {0,0}, {0,0}},
-    {{0,0}, {0,0}, {0,0}, {0,0}},
-    {{0,0}, {0,0}, {2,0}, {0,0}},
-    {{0,0}, {0,0}, {0,0}, {2,0}}
-  },
-  // P_- = P_L
-  {
-    {{2,0}, {0,0}, {0,0}, {0,0}},
-    {{0,0}, {2,0}, {0,0}, {0,0}},
-    {{0,0}, {0,0}, {0,0}, {0,0}},
-    {{0,0}, {0,0}, {0,0}, {0,0}}
-  }
-};
-
-
-// todo pass projector
-template <typename Float>
-void multiplySpinorByDiracProjector5(Float *res, int projIdx, Float *spinorIn) {
-  for (int i=0; i<4*3*2; i++) res[i] = 0.0;
-
-  for (int s = 0; s < 4; s++) {
-    for (int t = 0; t < 4; t++) {
-      Float projRe = projector[projIdx][s][t][0];
-      Float projIm = projector[projIdx][s][t][1];
-
-      for (int m = 0; m < 3; m++) {
-	Float spinorRe = spinorIn[t*(3*2) + m*(2) + 0];
-	Float spinorIm = spinorIn[t*(3*2) + m*(2) + 1];
-	res[s*(3*2) + m*(2) + 0] += projRe*spinorRe - projIm*spinorIm;
-	res[s*(3*2) + m*(2) + 1] += projRe*spinorIm + projIm*spinorRe;
-      }
-    }
-  }
-}
-
-
 //#ifndef MULTI_GPU
 // dslashReference_4d()
 //J  This is just the 4d wilson dslash of quda code, with a
@@ -267,58 +32,56 @@ void multiplySpinorByDiracProjector5(Float *res, int projIdx, Float *spinorIn) {
 //
 //An "ok" will only be granted once check2.tex is deemed complete,
 //since the logic in this function is important and nontrivial.
+//
+// The gauge field is four dimensional, so the fifth dimension is the
+// inner loop: sites are distributed over threads and the link of each
+// site and direction is loaded once and applied to every slice that
+// shares it.  With 4-d preconditioning that is all Ls slices; with 5-d
+// preconditioning the gauge parity alternates with the slice, so the
+// even and odd slices are visited as two sets with their own neighbor
+// table.
 template <QudaPCType type, typename sFloat, typename gFloat>
 void dslashReference_4d_sgpu(sFloat *res, gFloat **gaugeFull, sFloat *spinorField, int oddBit, int daggerBit)
 {
-
-  // Initialize the return half-spinor to zero.  Note that it is a
-  // 5d spinor, hence the use of V5h.
-  for (int i=0; i<V5h*4*3*2; i++) res[i] = 0.0;
-  
   // Some pointers that we use to march through arrays.
   gFloat *gaugeEven[4], *gaugeOdd[4];
   // Initialize to beginning of even and odd parts of
   // gauge array.
-  for (int dir = 0; dir < 4; dir++) {  
+  for (int dir = 0; dir < 4; dir++) {
     gaugeEven[dir] = gaugeFull[dir];
     // Note the use of Vh here, since the gauge fields
     // are 4-dim'l.
     gaugeOdd[dir] = gaugeFull[dir] + Vh * gauge_site_size;
   }
-  int sp_idx,gaugeOddBit;
-  for (int xs=0;xs<Ls;xs++) {
-    for (int gge_idx = 0; gge_idx < Vh; gge_idx++) {
-      for (int dir = 0; dir < 8; dir++) {
-        sp_idx=gge_idx+Vh*xs;
-        // Here is a function call to study.  It is defined near
-        // Line 90 of this file.
-        // Here we have to switch oddBit depending on the value of xs.  E.g., suppose
-        // xs=1.  Then the odd spinor site x1=x2=x3=x4=0 wants the even gauge array
-        // element 0, so that we get U_\mu(0).
-	gaugeOddBit = (xs%2 == 0 || type == QUDA_4D_PC) ? oddBit : (oddBit+1) % 2;
-        gFloat *gauge = gaugeLink_sgpu(gge_idx, dir, gaugeOddBit, gaugeEven, gaugeOdd);
-        
-        // Even though we're doing the 4d part of the dslash, we need
-        // to use a 5d neighbor function, to get the offsets right.
-        sFloat *spinor = spinorNeighbor_5d<type>(sp_idx, dir, oddBit, spinorField);
-        sFloat projectedSpinor[4*3*2], gaugedSpinor[4*3*2];
-        int projIdx = 2*(dir/2)+(dir+daggerBit)%2;
-        multiplySpinorByDiracProjector5(projectedSpinor, projIdx, spinor);
-      
-        for (int s = 0; s < 4; s++) {
-	  if (dir % 2 == 0) {
-	    su3Mul(&gaugedSpinor[s*(3*2)], gauge, &projectedSpinor[s*(3*2)]);
-#ifdef DBUG_VERBOSE            
-	    std::cout << "spinor:" << std::endl;
-	    printSpinorElement(&projectedSpinor[s*(3*2)],0,QUDA_DOUBLE_PRECISION);
-	    std::cout << "gauge:" << std::endl;
+
+  // Here we have to switch oddBit depending on the slice.  E.g., suppose
+  // xs=1.  Then the odd spinor site x1=x2=x3=x4=0 wants the even gauge array
+  // element 0, so that we get U_\mu(0).
+  const int nSet = type == QUDA_4D_PC ? 1 : 2;
+  const NeighborTable *neighbor[2];
+  for (int set = 0; set < nSet; set++) neighbor[set] = &getNeighborTable(Z, (oddBit + set) % 2, 1, false);
+
+#ifdef _OPENMP
+#pragma omp parallel for
 #endif
-          } else {
-	    su3Tmul(&gaugedSpinor[s*(3*2)], gauge, &projectedSpinor[s*(3*2)]);
-          }
+  for (int gge_idx = 0; gge_idx < Vh; gge_idx++) {
+    // the 5-d checkerboard index of a site is that of its 4-d site offset by the slice
+    for (int xs = 0; xs < Ls; xs++)
+      for (int c = 0; c < spinor_site_size; c++) res[(gge_idx + Vh * xs) * spinor_site_size + c] = 0.0;
+
+    for (int set = 0; set < nSet; set++) {
+      const int gaugeOddBit = (oddBit + set) % 2;
+      gFloat **gaugeThis = gaugeOddBit ? gaugeOdd : gaugeEven;
+      gFloat **gaugeOther = gaugeOddBit ? gaugeEven : gaugeOdd;
+
+      for (int dir = 0; dir < 8; dir++) {
+        const NeighborTable::Neighbor &nbr = neighbor[set]->neighbor(gge_idx, dir);
+        gFloat *gauge = dir % 2 == 0 ? &gaugeThis[dir / 2][gge_idx * gauge_site_size] :
+                                       &gaugeOther[dir / 2][nbr.idx * gauge_site_size];
+        for (int xs = set; xs < Ls; xs += nSet) {
+          sFloat *spinor = &spinorField[(nbr.idx + Vh * xs) * spinor_site_size];
+          wilsonHop(&res[(gge_idx + Vh * xs) * spinor_site_size], gauge, spinor, dir, daggerBit);
         }
-      
-        sum(&res[sp_idx*(4*3*2)], &res[sp_idx*(4*3*2)], gaugedSpinor, 4*3*2);
       }
     }
   }
@@ -329,50 +92,79 @@ template <QudaPCType type, typename sFloat, typename gFloat>
 void dslashReference_4d_mgpu(sFloat *res, gFloat **gaugeFull, gFloat **ghostGauge, sFloat *spinorField,
     sFloat **fwdSpinor, sFloat **backSpinor, int oddBit, int daggerBit)
 {
-  // int my_spinor_site_size = 24;
-  for (int i = 0; i < V5h * spinor_site_size; i++) res[i] = 0.0;
-
   gFloat *gaugeEven[4], *gaugeOdd[4];
   gFloat *ghostGaugeEven[4], *ghostGaugeOdd[4];
-  
-  for (int dir = 0; dir < 4; dir++) 
-  {  
+
+  for (int dir = 0; dir < 4; dir++)
+  {
     gaugeEven[dir] = gaugeFull[dir];
     gaugeOdd[dir] = gaugeFull[dir] + Vh * gauge_site_size;
 
     ghostGaugeEven[dir] = ghostGauge[dir];
     ghostGaugeOdd[dir] = ghostGauge[dir] + (faceVolume[dir] / 2) * gauge_site_size;
   }
-  for (int xs=0;xs<Ls;xs++) 
-  {  
-    int sp_idx;
-    for (int i = 0; i < Vh; i++) 
-    {
-      sp_idx = i + Vh*xs;
-      for (int dir = 0; dir < 8; dir++) 
-      {
-	int gaugeOddBit = (xs%2 == 0 || type == QUDA_4D_PC) ? oddBit : (oddBit + 1) % 2;
-	
-	gFloat *gauge = gaugeLink_mgpu(i, dir, gaugeOddBit, gaugeEven, gaugeOdd, ghostGaugeEven, ghostGaugeOdd, 1, 1);//this is unchanged from MPi version
-	sFloat *spinor = spinorNeighbor_5d_mgpu<type>(sp_idx, dir, oddBit, spinorField, fwdSpinor, backSpinor, 1, 1);
-
-        sFloat projectedSpinor[spinor_site_size], gaugedSpinor[spinor_site_size];
-        int projIdx = 2 * (dir / 2) + (dir + daggerBit) % 2;
-        multiplySpinorByDiracProjector5(projectedSpinor, projIdx, spinor);
-
-        for (int s = 0; s < 4; s++) {
-          if (dir % 2 == 0)
-            su3Mul(&gaugedSpinor[s * (3 * 2)], gauge, &projectedSpinor[s * (3 * 2)]);
-          else
-            su3Tmul(&gaugedSpinor[s * (3 * 2)], gauge, &projectedSpinor[s * (3 * 2)]);
+
+  const int nSet = type == QUDA_4D_PC ? 1 : 2;
+  const NeighborTable *neighbor[2];
+  for (int set = 0; set < nSet; set++) neighbor[set] = &getNeighborTable(Z, (oddBit + set) % 2);
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (int i = 0; i < Vh; i++) {
+    for (int xs = 0; xs < Ls; xs++)
+      for (int c = 0; c < spinor_site_size; c++) res[(i + Vh * xs) * spinor_site_size + c] = 0.0;
+
+    for (int set = 0; set < nSet; set++) {
+      const int gaugeOddBit = (oddBit + set) % 2;
+      gFloat **gaugeThis = gaugeOddBit ? gaugeOdd : gaugeEven;
+      gFloat **gaugeOther = gaugeOddBit ? gaugeEven : gaugeOdd;
+      gFloat **ghostGaugeOther = gaugeOddBit ? ghostGaugeEven : ghostGaugeOdd;
+
+      for (int dir = 0; dir < 8; dir++) {
+        const NeighborTable::Neighbor &nbr = neighbor[set]->neighbor(i, dir);
+        const bool ghost = nbr.depth >= 0;
+
+        gFloat *gauge;
+        if (dir % 2 == 0)
+          gauge = &gaugeThis[dir / 2][i * gauge_site_size];
+        else if (ghost)
+          gauge = &ghostGaugeOther[dir / 2][neighbor[set]->ghostOffset(nbr, dir, 1) * gauge_site_size];
+        else
+          gauge = &gaugeOther[dir / 2][nbr.idx * gauge_site_size];
+
+        for (int xs = set; xs < Ls; xs += nSet) {
+          // the ghost spinor holds one face of Ls slices
+          sFloat *spinor;
+          if (ghost) {
+            sFloat **ghostSpinor = dir % 2 == 0 ? fwdSpinor : backSpinor;
+            spinor = &ghostSpinor[dir / 2][neighbor[set]->ghostOffset(nbr, dir, 1, Ls, xs) * spinor_site_size];
+          } else {
+            spinor = &spinorField[(nbr.idx + Vh * xs) * spinor_site_size];
+          }
+
+          wilsonHop(&res[(i + Vh * xs) * spinor_site_size], gauge, spinor, dir, daggerBit);
         }
-        sum(&res[sp_idx * (4 * 3 * 2)], &res[sp_idx * (4 * 3 * 2)], gaugedSpinor, 4 * 3 * 2);
       }
     }
   }
 }
 #endif
 
+/**
+   @brief Checkerboard index of the neighbor of the 5-d site i in the
+   fifth dimension (dir = 8 forwards, 9 backwards).  With either 4-d or
+   5-d even-odd preconditioning the checkerboard index of a site is
+   its 4-d checkerboard index plus Vh times its slice, so this is a
+   shift of one slice.
+ */
+static inline int fifthDimNeighbor(int i, int dir)
+{
+  int xs = i / Vh;
+  int nxs = (dir == 8) ? (xs + 1) % Ls : (xs - 1 + Ls) % Ls;
+  return i + (nxs - xs) * Vh;
+}
+
 template <bool plus, class sFloat> // plus = true -> gamma_+; plus = false -> gamma_-
 void axpby_ssp_project(sFloat *z, sFloat a, sFloat *x, sFloat b, sFloat *y, int idx_cb_4d, int s, int sp)
 {
@@ -393,6 +185,111 @@ void axpby_ssp_project(sFloat *z, sFloat a, sFloat *x, sFloat b, sFloat *y, int
   }
 }
 
+/**
+   @brief Look up the coefficients for the given parameters, building
+   them on first use.  Coefficients depend only on the action
+   parameters and Ls, so every application of an operator after the
+   first reuses them.  Like the neighbor tables, the cache is not
+   thread safe and must be accessed outside parallel regions.
+ */
+template <typename Coeff, typename... Args> static const Coeff &getCoeff(const Args &... args)
+{
+  static std::vector<std::unique_ptr<Coeff>> cache;
+  const std::vector<double> key = Coeff::key(args...);
+  for (auto &coeff : cache)
+    if (coeff->key_ == key) return *coeff;
+  cache.emplace_back(new Coeff(args...));
+  cache.back()->key_ = key;
+  return *cache.back();
+}
+
+/**
+   @brief Coefficient vectors of the Moebius EOFA fifth-dimension
+   operator and its inverse, computed in the precision of the field
+   they are applied to.
+ */
+template <typename sFloat> struct EofaCoeff {
+  std::vector<double> key_;
+  sFloat kappa;                      // kappa of 1 + kappa D5
+  sFloat kappa5;                     // kappa of the inverse
+  std::vector<sFloat> shift_coeffs;  // Mooee_shift of the forward operator
+  std::vector<sFloat> x, y;          // Sherman-Morrison vectors of the inverse
+  sFloat sherman_morrison_fac;
+
+  static std::vector<double> key(sFloat mferm, sFloat m5, sFloat b, sFloat c, sFloat mq1, sFloat mq2, sFloat mq3,
+                                 int eofa_pm, sFloat eofa_shift)
+  {
+    return {(double)Ls, mferm, m5, b, c, mq1, mq2, mq3, (double)eofa_pm, eofa_shift};
+  }
+
+  EofaCoeff(sFloat mferm, sFloat m5, sFloat b, sFloat c, sFloat mq1, sFloat mq2, sFloat mq3, int eofa_pm,
+            sFloat eofa_shift) :
+    shift_coeffs(Ls), x(Ls), y(Ls)
+  {
+    sFloat alpha = b + c;
+    sFloat eofa_norm = alpha * (mq3 - mq2) * std::pow(alpha + 1., 2 * Ls)
+      / (std::pow(alpha + 1., Ls) + mq2 * std::pow(alpha - 1., Ls))
+      / (std::pow(alpha + 1., Ls) + mq3 * std::pow(alpha - 1., Ls));
+
+    kappa = 0.5 * (c * (4. + m5) - 1.) / (b * (4. + m5) + 1.);
+    kappa5 = (c * (4. + m5) - 1.) / (b * (4. + m5) + 1.); // alpha = b+c
+
+    // Construct Mooee_shift
+    sFloat N = (eofa_pm ? 1.0 : -1.0) * (2.0 * eofa_shift * eofa_norm)
+      * (std::pow(alpha + 1.0, Ls) + mq1 * std::pow(alpha - 1.0, Ls));
+
+    // For the kappa preconditioning
+    N *= 1. / (b * (m5 + 4.) + 1.);
+    for (int s = 0; s < Ls; s++) {
+      int idx = eofa_pm ? (s) : (Ls - 1 - s);
+      shift_coeffs[idx] = N * std::pow(-1.0, s) * std::pow(alpha - 1.0, s) / std::pow(alpha + 1.0, Ls + s + 1);
+    }
+
+    sFloat N_inv = (eofa_pm ? +1. : -1.) * (2. * eofa_shift * eofa_norm)
+      * (std::pow(alpha + 1., Ls) + mq1 * std::pow(alpha - 1., Ls)) / (b * (m5 + 4.) + 1.);
+
+    // Here the signs are somewhat mixed:
+    // There is one -1 from N for eofa_pm = minus, thus the u_- here is actually -u_- in the document
+    // It turns out this actually simplies things.
+    std::vector<sFloat> u(Ls);
+    for (int s = 0; s < Ls; s++) {
+      u[eofa_pm ? s : Ls - 1 - s] = N_inv * std::pow(-1., s) * std::pow(alpha - 1., s) / std::pow(alpha + 1., Ls + s + 1);
+    }
+
+    sFloat factor = -kappa5 * mferm;
+    if (eofa_pm) {
+      // eofa_pm = plus
+      // Computing x
+      x[0] = u[0];
+      for (int s = Ls - 1; s > 0; s--) {
+        x[0] -= factor * u[s];
+        factor *= -kappa5;
+      }
+      x[0] /= 1. + factor;
+      for (int s = 1; s < Ls; s++) { x[s] = x[s - 1] * (-kappa5) + u[s]; }
+      // Computing y
+      y[Ls - 1] = 1. / (1. + factor);
+      sherman_morrison_fac = x[Ls - 1];
+      for (int s = Ls - 1; s > 0; s--) { y[s - 1] = y[s] * (-kappa5); }
+    } else {
+      // eofa_pm = minus
+      // Computing x
+      x[Ls - 1] = u[Ls - 1];
+      for (int s = 0; s < Ls - 1; s++) {
+        x[Ls - 1] -= factor * u[s];
+        factor *= -kappa5;
+      }
+      x[Ls - 1] /= 1. + factor;
+      for (int s = Ls - 1; s > 0; s--) { x[s - 1] = x[s] * (-kappa5) + u[s - 1]; }
+      // Computing y
+      y[0] = 1. / (1. + factor);
+      sherman_morrison_fac = x[0];
+      for (int s = 1; s < Ls; s++) { y[s] = y[s - 1] * (-kappa5); }
+    }
+    sherman_morrison_fac = -0.5 / (1. + sherman_morrison_fac); // 0.5 for the spin project factor
+  }
+};
+
 template <typename sFloat>
 void mdw_eofa_m5_ref(sFloat *res, sFloat *spinorField, int oddBit, int daggerBit, sFloat mferm, sFloat m5, sFloat b,
                      sFloat c, sFloat mq1, sFloat mq2, sFloat mq3, int eofa_pm, sFloat eofa_shift)
@@ -403,53 +300,38 @@ void mdw_eofa_m5_ref(sFloat *res, sFloat *spinorField, int oddBit, int daggerBit
   // daggerBit: dagger or not
   // mferm: m_f
 
-  sFloat alpha = b + c;
-  sFloat eofa_norm = alpha * (mq3 - mq2) * std::pow(alpha + 1., 2 * Ls)
-    / (std::pow(alpha + 1., Ls) + mq2 * std::pow(alpha - 1., Ls))
-    / (std::pow(alpha + 1., Ls) + mq3 * std::pow(alpha - 1., Ls));
-
-  sFloat kappa = 0.5 * (c * (4. + m5) - 1.) / (b * (4. + m5) + 1.);
+  const EofaCoeff<sFloat> &coeff = getCoeff<EofaCoeff<sFloat>>(mferm, m5, b, c, mq1, mq2, mq3, eofa_pm, eofa_shift);
+  const sFloat kappa = coeff.kappa;
+  const std::vector<sFloat> &shift_coeffs = coeff.shift_coeffs;
 
   constexpr int spinor_size = 4 * 3 * 2;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
   for (int i = 0; i < V5h; i++) {
     for (int one_site = 0; one_site < 24; one_site++) { res[i * spinor_size + one_site] = 0.; }
     for (int dir = 8; dir < 10; dir++) {
       // Calls for an extension of the original function.
       // 8 is forward hop, which wants P_+, 9 is backward hop,
       // which wants P_-.  Dagger reverses these.
-      sFloat *spinor = spinorNeighbor_5d<QUDA_4D_PC>(i, dir, oddBit, spinorField);
-      sFloat projectedSpinor[spinor_size];
-      int projIdx = 2 * (dir / 2) + (dir + daggerBit) % 2;
-      multiplySpinorByDiracProjector5(projectedSpinor, projIdx, spinor);
-      // J  Need a conditional here for s=0 and s=Ls-1.
-      int X = fullLatticeIndex_5d_4dpc(i, oddBit);
-      int xs = X / (Z[3] * Z[2] * Z[1] * Z[0]);
-
-      if ((xs == 0 && dir == 9) || (xs == Ls - 1 && dir == 8)) {
-        ax(projectedSpinor, -mferm, projectedSpinor, spinor_size);
-      }
-      sum(&res[i * spinor_size], &res[i * spinor_size], projectedSpinor, spinor_size);
+      int xs = i / Vh;
+      sFloat *spinor = &spinorField[fifthDimNeighbor(i, dir) * spinor_size];
+
+      sFloat a = ((xs == 0 && dir == 9) || (xs == Ls - 1 && dir == 8)) ? -mferm : (sFloat)1.;
+      // P_+ (projIdx 8) acts on the lower spins, P_- (projIdx 9) on the upper
+      if ((dir + daggerBit) % 2 == 0)
+        chiralProjectAdd<false>(&res[i * spinor_size], spinor, a);
+      else
+        chiralProjectAdd<true>(&res[i * spinor_size], spinor, a);
     }
     // 1 + kappa*D5
     axpby((sFloat)1., &spinorField[i * spinor_size], kappa, &res[i * spinor_size], spinor_size);
   }
 
-  // Initialize
-  std::vector<sFloat> shift_coeffs(Ls);
-
-  // Construct Mooee_shift
-  sFloat N = (eofa_pm ? 1.0 : -1.0) * (2.0 * eofa_shift * eofa_norm)
-    * (std::pow(alpha + 1.0, Ls) + mq1 * std::pow(alpha - 1.0, Ls));
-
-  // For the kappa preconditioning
-  int idx = 0;
-  N *= 1. / (b * (m5 + 4.) + 1.);
-  for (int s = 0; s < Ls; s++) {
-    idx = eofa_pm ? (s) : (Ls - 1 - s);
-    shift_coeffs[idx] = N * std::pow(-1.0, s) * std::pow(alpha - 1.0, s) / std::pow(alpha + 1.0, Ls + s + 1);
-  }
-
   // The eofa part.
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
   for (int idx_cb_4d = 0; idx_cb_4d < Vh; idx_cb_4d++) {
     for (int s = 0; s < Ls; s++) {
       if (daggerBit == 0) {
@@ -486,6 +368,9 @@ void mdw_eofa_m5(void *res, void *spinorField, int oddBit, int daggerBit, double
 template <QudaPCType type, bool zero_initialize = false, typename sFloat>
 void dslashReference_5th(sFloat *res, sFloat *spinorField, int oddBit, int daggerBit, sFloat mferm)
 {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
   for (int i = 0; i < V5h; i++) {
     if (zero_initialize) for(int one_site = 0 ; one_site < 24 ; one_site++)
       res[i*(4*3*2)+one_site] = 0.0;
@@ -493,110 +378,17 @@ void dslashReference_5th(sFloat *res, sFloat *spinorField, int oddBit, int dagge
       // Calls for an extension of the original function.
       // 8 is forward hop, which wants P_+, 9 is backward hop,
       // which wants P_-.  Dagger reverses these.
-      sFloat *spinor = spinorNeighbor_5d<type>(i, dir, oddBit, spinorField);
-      sFloat projectedSpinor[4*3*2];
-      int projIdx = 2*(dir/2)+(dir+daggerBit)%2;
-      multiplySpinorByDiracProjector5(projectedSpinor, projIdx, spinor);
-      //J  Need a conditional here for s=0 and s=Ls-1.
-      int X = (type == QUDA_5D_PC) ? fullLatticeIndex_5d(i, oddBit) : fullLatticeIndex_5d_4dpc(i, oddBit);
-      int xs = X/(Z[3]*Z[2]*Z[1]*Z[0]);
-
-      if ( (xs == 0 && dir == 9) || (xs == Ls-1 && dir == 8) ) {
-        ax(projectedSpinor,(sFloat)(-mferm),projectedSpinor,4*3*2);
-      } 
-      sum(&res[i*(4*3*2)], &res[i*(4*3*2)], projectedSpinor, 4*3*2);
-    }
-  }
-}
-
-//Currently we consider only spacetime decomposition (not in 5th dim), so this operator is local
-template <typename sFloat>
-void dslashReference_5th_inv(sFloat *res, sFloat *spinorField, int oddBit, int daggerBit, sFloat mferm, double *kappa)
-{
-  double *inv_Ftr = (double*)malloc(Ls*sizeof(sFloat));
-  double *Ftr = (double*)malloc(Ls*sizeof(sFloat));
-  for(int xs = 0 ; xs < Ls ; xs++)
-  {
-    inv_Ftr[xs] = 1.0/(1.0+pow(2.0*kappa[xs], Ls)*mferm);
-    Ftr[xs] = -2.0*kappa[xs]*mferm*inv_Ftr[xs]; 
-    for (int i = 0; i < Vh; i++) {
-      memcpy(&res[24*(i+Vh*xs)], &spinorField[24*(i+Vh*xs)], 24*sizeof(sFloat));
-    }
-  }
-  if(daggerBit == 0)
-  {
-    // s = 0
-    for (int i = 0; i < Vh; i++) {
-      ax(&res[12+24*(i+Vh*(Ls-1))],(sFloat)(inv_Ftr[0]), &spinorField[12+24*(i+Vh*(Ls-1))], 12);
-    }
-
-    // s = 1 ... ls-2
-    for(int xs = 0 ; xs <= Ls-2 ; ++xs)
-    {
-      for (int i = 0; i < Vh; i++) {
-        axpy((sFloat)(2.0*kappa[xs]), &res[24*(i+Vh*xs)], &res[24*(i+Vh*(xs+1))], 12);
-        axpy((sFloat)Ftr[xs], &res[12+24*(i+Vh*xs)], &res[12+24*(i+Vh*(Ls-1))], 12);
-      }
-      for (int tmp_s = 0 ; tmp_s < Ls ; tmp_s++)
-        Ftr[tmp_s] *= 2.0*kappa[tmp_s];
-    }
-    for(int xs = 0 ; xs < Ls ; xs++)
-    {
-      Ftr[xs] = -pow(2.0*kappa[xs],Ls-1)*mferm*inv_Ftr[xs]; 
-    }
-    // s = ls-2 ... 0
-    for(int xs = Ls-2 ; xs >=0 ; --xs)
-    {
-      for (int i = 0; i < Vh; i++) {
-        axpy((sFloat)Ftr[xs], &res[24*(i+Vh*(Ls-1))], &res[24*(i+Vh*xs)], 12);
-        axpy((sFloat)(2.0*kappa[xs]), &res[12+24*(i+Vh*(xs+1))], &res[12+24*(i+Vh*xs)], 12);
-      }
-      for (int tmp_s = 0 ; tmp_s < Ls ; tmp_s++)
-        Ftr[tmp_s] /= 2.0*kappa[tmp_s];
-    }
-    // s = ls -1
-    for (int i = 0; i < Vh; i++) {
-      ax(&res[24*(i+Vh*(Ls-1))], (sFloat)(inv_Ftr[Ls-1]), &res[24*(i+Vh*(Ls-1))], 12);
-    }
-  }
-  else
-  {
-    // s = 0
-    for (int i = 0; i < Vh; i++) {
-      ax(&res[24*(i+Vh*(Ls-1))],(sFloat)(inv_Ftr[0]), &spinorField[24*(i+Vh*(Ls-1))], 12);
-    }
+      int xs = i / Vh;
+      sFloat *spinor = &spinorField[fifthDimNeighbor(i, dir) * (4 * 3 * 2)];
 
-    // s = 1 ... ls-2
-    for(int xs = 0 ; xs <= Ls-2 ; ++xs)
-    {
-      for (int i = 0; i < Vh; i++) {
-        axpy((sFloat)Ftr[xs], &res[24*(i+Vh*xs)], &res[24*(i+Vh*(Ls-1))], 12);
-        axpy((sFloat)(2.0*kappa[xs]), &res[12+24*(i+Vh*xs)], &res[12+24*(i+Vh*(xs+1))], 12);
-      }
-      for (int tmp_s = 0 ; tmp_s < Ls ; tmp_s++)
-        Ftr[tmp_s] *= 2.0*kappa[tmp_s];
-    }
-    for(int xs = 0 ; xs < Ls ; xs++)
-    {
-      Ftr[xs] = -pow(2.0*kappa[xs],Ls-1)*mferm*inv_Ftr[xs]; 
-    }
-    // s = ls-2 ... 0
-    for(int xs = Ls-2 ; xs >=0 ; --xs)
-    {
-      for (int i = 0; i < Vh; i++) {
-        axpy((sFloat)(2.0*kappa[xs]), &res[24*(i+Vh*(xs+1))], &res[24*(i+Vh*xs)], 12);
-        axpy((sFloat)Ftr[xs], &res[12+24*(i+Vh*(Ls-1))], &res[12+24*(i+Vh*xs)], 12);
-      }
-      for (int tmp_s = 0 ; tmp_s < Ls ; tmp_s++)
-        Ftr[tmp_s] /= 2.0*kappa[tmp_s];
-    }
-    // s = ls -1
-    for (int i = 0; i < Vh; i++) {
-      ax(&res[12+24*(i+Vh*(Ls-1))], (sFloat)(inv_Ftr[Ls-1]), &res[12+24*(i+Vh*(Ls-1))], 12);
+      sFloat a = ((xs == 0 && dir == 9) || (xs == Ls - 1 && dir == 8)) ? (sFloat)(-mferm) : (sFloat)1.;
+      // P_+ (projIdx 8) acts on the lower spins, P_- (projIdx 9) on the upper
+      if ((dir + daggerBit) % 2 == 0)
+        chiralProjectAdd<false>(&res[i * (4 * 3 * 2)], spinor, a);
+      else
+        chiralProjectAdd<true>(&res[i * (4 * 3 * 2)], spinor, a);
     }
   }
-  free(inv_Ftr);
-  free(Ftr);
 }
 
 template <typename sComplex>
@@ -610,82 +402,111 @@ sComplex cpow(const sComplex &x, int y)
   return z;
 }
 
-// Currently we consider only spacetime decomposition (not in 5th dim), so this operator is local
-template <typename sFloat, typename sComplex>
-void mdslashReference_5th_inv(sFloat *res, sFloat *spinorField, int oddBit, int daggerBit, sFloat mferm, sComplex *kappa)
-{
-  sComplex *inv_Ftr = (sComplex *)malloc(Ls * sizeof(sComplex));
-  sComplex *Ftr = (sComplex *)malloc(Ls * sizeof(sComplex));
-  for (int xs = 0; xs < Ls; xs++) {
-    inv_Ftr[xs] = 1.0 / (1.0 + cpow(2.0 * kappa[xs], Ls) * mferm);
-    Ftr[xs] = -2.0 * kappa[xs] * mferm * inv_Ftr[xs];
-    for (int i = 0; i < Vh; i++) {
-      memcpy(&res[24 * (i + Vh * xs)], &spinorField[24 * (i + Vh * xs)], 24 * sizeof(sFloat));
-    }
+static inline double kpow(double x, int y) { return pow(x, y); }
+static inline double _Complex kpow(double _Complex x, int y) { return cpow(x, y); }
+
+/**
+   @brief Coefficient vectors of the inverse of the fifth-dimension
+   hopping term, 1 + kappa_s D5, for Shamir (real kappa) and Moebius
+   (complex kappa) domain wall.  The inverse is a forward and a
+   backward recursion over the slices; the coefficients of each step
+   are independent of the site and are tabulated here once.
+ */
+template <typename Kappa> struct M5InvCoeff {
+  std::vector<double> key_;
+  Kappa inv_first;            // inv_Ftr[0], applied before the recursion
+  Kappa inv_last;             // inv_Ftr[Ls-1], applied after the recursion
+  std::vector<Kappa> two_kappa; // 2 kappa_s
+  std::vector<Kappa> ftr_fwd; // Ftr_s at step s of the forward recursion
+  std::vector<Kappa> ftr_bwd; // Ftr_s at step s of the backward recursion
+
+  static std::vector<double> key(const Kappa *kappa, double mferm)
+  {
+    const double *k = reinterpret_cast<const double *>(kappa);
+    std::vector<double> key(k, k + Ls * sizeof(Kappa) / sizeof(double));
+    key.push_back(mferm);
+    return key;
   }
-  if (daggerBit == 0) {
-    // s = 0
-    for (int i = 0; i < Vh; i++) {
-      ax((sComplex *)&res[12 + 24 * (i + Vh * (Ls - 1))], inv_Ftr[0],
-          (sComplex *)&spinorField[12 + 24 * (i + Vh * (Ls - 1))], 6);
-    }
 
-    // s = 1 ... ls-2
-    for (int xs = 0; xs <= Ls - 2; ++xs) {
-      for (int i = 0; i < Vh; i++) {
-        axpy((2.0 * kappa[xs]), (sComplex *)&res[24 * (i + Vh * xs)], (sComplex *)&res[24 * (i + Vh * (xs + 1))], 6);
-        axpy(Ftr[xs], (sComplex *)&res[12 + 24 * (i + Vh * xs)], (sComplex *)&res[12 + 24 * (i + Vh * (Ls - 1))], 6);
-      }
-      for (int tmp_s = 0; tmp_s < Ls; tmp_s++) Ftr[tmp_s] *= 2.0 * kappa[tmp_s];
+  M5InvCoeff(const Kappa *kappa, double mferm) : two_kappa(Ls), ftr_fwd(Ls), ftr_bwd(Ls)
+  {
+    std::vector<Kappa> inv_Ftr(Ls);
+    for (int xs = 0; xs < Ls; xs++) {
+      two_kappa[xs] = 2.0 * kappa[xs];
+      inv_Ftr[xs] = 1.0 / (1.0 + kpow(2.0 * kappa[xs], Ls) * mferm);
     }
-    for (int xs = 0; xs < Ls; xs++) Ftr[xs] = -cpow(2.0 * kappa[xs], Ls - 1) * mferm * inv_Ftr[xs];
+    inv_first = inv_Ftr[0];
+    inv_last = inv_Ftr[Ls - 1];
 
-    // s = ls-2 ... 0
-    for (int xs = Ls - 2; xs >= 0; --xs) {
-      for (int i = 0; i < Vh; i++) {
-        axpy(Ftr[xs], (sComplex *)&res[24 * (i + Vh * (Ls - 1))], (sComplex *)&res[24 * (i + Vh * xs)], 6);
-        axpy((2.0 * kappa[xs]), (sComplex *)&res[12 + 24 * (i + Vh * (xs + 1))],
-            (sComplex *)&res[12 + 24 * (i + Vh * xs)], 6);
-      }
-      for (int tmp_s = 0; tmp_s < Ls; tmp_s++) Ftr[tmp_s] /= 2.0 * kappa[tmp_s];
-    }
-    // s = ls -1
-    for (int i = 0; i < Vh; i++) {
-      ax((sComplex *)&res[24 * (i + Vh * (Ls - 1))], inv_Ftr[Ls - 1], (sComplex *)&res[24 * (i + Vh * (Ls - 1))], 6);
+    // the recursion rescales every Ftr by 2 kappa after each step, so
+    // step s sees its coefficient rescaled s times going forward and
+    // Ls - 2 - s times coming back
+    for (int xs = 0; xs < Ls; xs++) {
+      ftr_fwd[xs] = -2.0 * kappa[xs] * mferm * inv_Ftr[xs];
+      for (int step = 0; step < xs; step++) ftr_fwd[xs] *= 2.0 * kappa[xs];
+      ftr_bwd[xs] = -kpow(2.0 * kappa[xs], Ls - 1) * mferm * inv_Ftr[xs];
+      for (int step = Ls - 2; step > xs; step--) ftr_bwd[xs] /= 2.0 * kappa[xs];
     }
-  } else {
+  }
+};
+
+/**
+   @brief Apply the inverse of the fifth-dimension hopping term.  The
+   recursion runs along the fifth dimension independently at each 4-d
+   site, so sites are distributed over threads and the slices of a
+   site are updated in turn.  Each chiral half of a slice is handled as
+   a vector of Elem, which is real for Shamir and complex for Moebius.
+ */
+template <typename Elem, typename sFloat, typename Kappa>
+void fifthInvReference(sFloat *res, sFloat *spinorField, int daggerBit, const M5InvCoeff<Kappa> &coeff)
+{
+  constexpr int n = 12 * sizeof(sFloat) / sizeof(Elem); // length of a chiral half
+  // with dagger the roles of the upper and lower spins swap
+  const int p = daggerBit ? 12 : 0;
+  const int q = daggerBit ? 0 : 12;
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (int i = 0; i < Vh; i++) {
+    auto half = [&](sFloat *field, int xs, int chi) { return reinterpret_cast<Elem *>(&field[chi + 24 * (i + Vh * xs)]); };
+
+    for (int xs = 0; xs < Ls; xs++)
+      memcpy(&res[24 * (i + Vh * xs)], &spinorField[24 * (i + Vh * xs)], 24 * sizeof(sFloat));
+
     // s = 0
-    for (int i = 0; i < Vh; i++) {
-      ax((sComplex *)&res[24 * (i + Vh * (Ls - 1))], inv_Ftr[0], (sComplex *)&spinorField[24 * (i + Vh * (Ls - 1))], 6);
-    }
+    ax(half(res, Ls - 1, q), (Elem)coeff.inv_first, half(spinorField, Ls - 1, q), n);
 
     // s = 1 ... ls-2
     for (int xs = 0; xs <= Ls - 2; ++xs) {
-      for (int i = 0; i < Vh; i++) {
-        axpy(Ftr[xs], (sComplex *)&res[24 * (i + Vh * xs)], (sComplex *)&res[24 * (i + Vh * (Ls - 1))], 6);
-        axpy((2.0 * kappa[xs]), (sComplex *)&res[12 + 24 * (i + Vh * xs)],
-            (sComplex *)&res[12 + 24 * (i + Vh * (xs + 1))], 6);
-      }
-      for (int tmp_s = 0; tmp_s < Ls; tmp_s++) Ftr[tmp_s] *= 2.0 * kappa[tmp_s];
+      axpy((Elem)coeff.two_kappa[xs], half(res, xs, p), half(res, xs + 1, p), n);
+      axpy((Elem)coeff.ftr_fwd[xs], half(res, xs, q), half(res, Ls - 1, q), n);
     }
-    for (int xs = 0; xs < Ls; xs++) Ftr[xs] = -cpow(2.0 * kappa[xs], Ls - 1) * mferm * inv_Ftr[xs];
 
     // s = ls-2 ... 0
     for (int xs = Ls - 2; xs >= 0; --xs) {
-      for (int i = 0; i < Vh; i++) {
-        axpy((2.0 * kappa[xs]), (sComplex *)&res[24 * (i + Vh * (xs + 1))], (sComplex *)&res[24 * (i + Vh * xs)], 6);
-        axpy(Ftr[xs], (sComplex *)&res[12 + 24 * (i + Vh * (Ls - 1))], (sComplex *)&res[12 + 24 * (i + Vh * xs)], 6);
-      }
-      for (int tmp_s = 0; tmp_s < Ls; tmp_s++) Ftr[tmp_s] /= 2.0 * kappa[tmp_s];
+      axpy((Elem)coeff.ftr_bwd[xs], half(res, Ls - 1, p), half(res, xs, p), n);
+      axpy((Elem)coeff.two_kappa[xs], half(res, xs + 1, q), half(res, xs, q), n);
     }
+
     // s = ls -1
-    for (int i = 0; i < Vh; i++) {
-      ax((sComplex *)&res[12 + 24 * (i + Vh * (Ls - 1))], inv_Ftr[Ls - 1],
-          (sComplex *)&res[12 + 24 * (i + Vh * (Ls - 1))], 6);
-    }
+    ax(half(res, Ls - 1, p), (Elem)coeff.inv_last, half(res, Ls - 1, p), n);
   }
-  free(inv_Ftr);
-  free(Ftr);
+}
+
+//Currently we consider only spacetime decomposition (not in 5th dim), so this operator is local
+template <typename sFloat>
+void dslashReference_5th_inv(sFloat *res, sFloat *spinorField, int oddBit, int daggerBit, sFloat mferm, double *kappa)
+{
+  fifthInvReference<sFloat>(res, spinorField, daggerBit, getCoeff<M5InvCoeff<double>>(kappa, mferm));
+}
+
+// Currently we consider only spacetime decomposition (not in 5th dim), so this operator is local
+template <typename sFloat, typename sComplex>
+void mdslashReference_5th_inv(sFloat *res, sFloat *spinorField, int oddBit, int daggerBit, sFloat mferm, sComplex *kappa)
+{
+  using Elem = typename std::conditional<std::is_same<sFloat, double>::value, double _Complex, float _Complex>::type;
+  fifthInvReference<Elem>(res, spinorField, daggerBit, getCoeff<M5InvCoeff<sComplex>>(kappa, mferm));
 }
 
 template <typename sFloat>
@@ -698,66 +519,20 @@ void mdw_eofa_m5inv_ref(sFloat *res, sFloat *spinorField, int oddBit, int dagger
   // daggerBit: dagger or not
   // mferm: m_f
 
-  sFloat alpha = b + c;
-  sFloat eofa_norm = alpha * (mq3 - mq2) * std::pow(alpha + 1., 2 * Ls)
-    / (std::pow(alpha + 1., Ls) + mq2 * std::pow(alpha - 1., Ls))
-    / (std::pow(alpha + 1., Ls) + mq3 * std::pow(alpha - 1., Ls));
-  sFloat kappa5 = (c * (4. + m5) - 1.) / (b * (4. + m5) + 1.); // alpha = b+c
+  const EofaCoeff<sFloat> &coeff = getCoeff<EofaCoeff<sFloat>>(mferm, m5, b, c, mq1, mq2, mq3, eofa_pm, eofa_shift);
 
   using sComplex = double _Complex;
-
-  std::vector<sComplex> kappa_array(Ls, -0.5 * kappa5);
-  std::vector<sFloat> eofa_u(Ls);
-  std::vector<sFloat> eofa_x(Ls);
-  std::vector<sFloat> eofa_y(Ls);
-
+  std::vector<sComplex> kappa_array(Ls, -0.5 * coeff.kappa5);
   mdslashReference_5th_inv(res, spinorField, oddBit, daggerBit, mferm, kappa_array.data());
 
-  sFloat N = (eofa_pm ? +1. : -1.) * (2. * eofa_shift * eofa_norm)
-    * (std::pow(alpha + 1., Ls) + mq1 * std::pow(alpha - 1., Ls)) / (b * (m5 + 4.) + 1.);
-
-  // Here the signs are somewhat mixed:
-  // There is one -1 from N for eofa_pm = minus, thus the u_- here is actually -u_- in the document
-  // It turns out this actually simplies things.
-  for (int s = 0; s < Ls; s++) {
-    eofa_u[eofa_pm ? s : Ls - 1 - s] = N * std::pow(-1., s) * std::pow(alpha - 1., s) / std::pow(alpha + 1., Ls + s + 1);
-  }
-
-  sFloat sherman_morrison_fac;
-
-  sFloat factor = -kappa5 * mferm;
-  if (eofa_pm) {
-    // eofa_pm = plus
-    // Computing x
-    eofa_x[0] = eofa_u[0];
-    for (int s = Ls - 1; s > 0; s--) {
-      eofa_x[0] -= factor * eofa_u[s];
-      factor *= -kappa5;
-    }
-    eofa_x[0] /= 1. + factor;
-    for (int s = 1; s < Ls; s++) { eofa_x[s] = eofa_x[s - 1] * (-kappa5) + eofa_u[s]; }
-    // Computing y
-    eofa_y[Ls - 1] = 1. / (1. + factor);
-    sherman_morrison_fac = eofa_x[Ls - 1];
-    for (int s = Ls - 1; s > 0; s--) { eofa_y[s - 1] = eofa_y[s] * (-kappa5); }
-  } else {
-    // eofa_pm = minus
-    // Computing x
-    eofa_x[Ls - 1] = eofa_u[Ls - 1];
-    for (int s = 0; s < Ls - 1; s++) {
-      eofa_x[Ls - 1] -= factor * eofa_u[s];
-      factor *= -kappa5;
-    }
-    eofa_x[Ls - 1] /= 1. + factor;
-    for (int s = Ls - 1; s > 0; s--) { eofa_x[s - 1] = eofa_x[s] * (-kappa5) + eofa_u[s - 1]; }
-    // Computing y
-    eofa_y[0] = 1. / (1. + factor);
-    sherman_morrison_fac = eofa_x[0];
-    for (int s = 1; s < Ls; s++) { eofa_y[s] = eofa_y[s - 1] * (-kappa5); }
-  }
-  sherman_morrison_fac = -0.5 / (1. + sherman_morrison_fac); // 0.5 for the spin project factor
+  const std::vector<sFloat> &eofa_x = coeff.x;
+  const std::vector<sFloat> &eofa_y = coeff.y;
+  const sFloat sherman_morrison_fac = coeff.sherman_morrison_fac;
 
   // The EOFA stuff
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
   for (int idx_cb_4d = 0; idx_cb_4d < Vh; idx_cb_4d++) {
     for (int s = 0; s < Ls; s++) {
       for (int sp = 0; sp < Ls; sp++) {
@@ -1025,7 +800,8 @@ void mdw_mat(void *out, void **gauge, void *in, double _Complex *kappa_b, double
              QudaPrecision precision, QudaGaugeParam &gauge_param, double mferm, double _Complex *b5, double _Complex *c5)
 {
   void *tmp = malloc(V5h * spinor_site_size * precision);
-  double _Complex *kappa5 = (double _Complex *)malloc(Ls * sizeof(double _Complex));
+  std::vector<double _Complex> kappa5_array(Ls);
+  auto kappa5 = kappa5_array.data();
 
   for(int xs = 0; xs < Ls ; xs++) kappa5[xs] = 0.5*kappa_b[xs]/kappa_c[xs];
 
@@ -1064,7 +840,6 @@ void mdw_mat(void *out, void **gauge, void *in, double _Complex *kappa_b, double
           (char *)outEven + precision * Vh * spinor_site_size * xs, Vh * spinor_site_size, precision);
   }
 
-  free(kappa5);
   free(tmp);
 }
 
@@ -1156,9 +931,8 @@ void dw_matpc(void *out, void **gauge, void *in, double kappa, QudaMatPCType mat
 void dw_4d_matpc(void *out, void **gauge, void *in, double kappa, QudaMatPCType matpc_type, int dagger_bit, QudaPrecision precision, QudaGaugeParam &gauge_param, double mferm)
 {
   double kappa2 = -kappa*kappa;
-  double *kappa5 = (double*)malloc(Ls*sizeof(double));
-  for(int xs = 0; xs < Ls ; xs++)
-    kappa5[xs] = kappa;
+  std::vector<double> kappa5_array(Ls, kappa);
+  auto kappa5 = kappa5_array.data();
   void *tmp = malloc(V5h * spinor_site_size * precision);
   //------------------------------------------
   double *output = (double*)out;
@@ -1190,7 +964,6 @@ void dw_4d_matpc(void *out, void **gauge, void *in, double kappa, QudaMatPCType
     xpay(tmp, -kappa, out, V5h * spinor_site_size, precision);
   }
   free(tmp);
-  free(kappa5);
 }
 
 void mdw_matpc(void *out, void **gauge, void *in, double _Complex *kappa_b, double _Complex *kappa_c,
@@ -1198,9 +971,10 @@ void mdw_matpc(void *out, void **gauge, void *in, double _Complex *kappa_b, doub
     double _Complex *b5, double _Complex *c5)
 {
   void *tmp = malloc(V5h * spinor_site_size * precision);
-  double _Complex *kappa5 = (double _Complex *)malloc(Ls * sizeof(double _Complex));
-  double _Complex *kappa2 = (double _Complex *)malloc(Ls * sizeof(double _Complex));
-  double _Complex *kappa_mdwf = (double _Complex *)malloc(Ls * sizeof(double _Complex));
+  std::vector<double _Complex> kappa5_array(Ls), kappa2_array(Ls), kappa_mdwf_array(Ls);
+  auto kappa5 = kappa5_array.data();
+  auto kappa2 = kappa2_array.data();
+  auto kappa_mdwf = kappa_mdwf_array.data();
   for(int xs = 0; xs < Ls ; xs++)
   {
     kappa5[xs] = 0.5*kappa_b[xs]/kappa_c[xs];
@@ -1261,9 +1035,6 @@ void mdw_matpc(void *out, void **gauge, void *in, double _Complex *kappa_b, doub
   }
 
   free(tmp);
-  free(kappa5);
-  free(kappa2);
-  free(kappa_mdwf);
 }
 
 void mdw_eofa_matpc(void *out, void **gauge, void *in, QudaMatPCType matpc_type, int dagger, QudaPrecision precision,
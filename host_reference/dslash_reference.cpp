@@ -36,6 +36,26 @@ void verifyInversion(void *spinorOut, void **spinorOutMulti, void *spinorIn, voi
   }
 }
 
+void verifyInversion(void **spinorOut, void **spinorIn, int num_src, QudaGaugeParam &gauge_param,
+                     QudaInvertParam &inv_param, void **gauge, void *clover, void *clover_inv)
+{
+  const size_t spinor_bytes = V * spinor_site_size * host_spinor_data_type_size * inv_param.Ls;
+  void *check_buffer = malloc(num_src * spinor_bytes);
+  std::vector<void *> spinorCheck = fieldSplit(check_buffer, num_src, spinor_bytes);
+
+  if (dslash_type == QUDA_WILSON_DSLASH || dslash_type == QUDA_CLOVER_WILSON_DSLASH
+      || (dslash_type == QUDA_TWISTED_CLOVER_DSLASH && inv_param.twist_flavor == QUDA_TWIST_SINGLET)) {
+    verifyWilsonTypeInversion(spinorOut, spinorIn, spinorCheck.data(), num_src, gauge_param, inv_param, gauge, clover,
+                              clover_inv);
+  } else {
+    // no multi-source host operator, so check each source in turn
+    for (int i = 0; i < num_src; i++)
+      verifyInversion(spinorOut[i], spinorIn[i], spinorCheck[i], gauge_param, inv_param, gauge, clover, clover_inv);
+  }
+
+  free(check_buffer);
+}
+
 void verifyDomainWallTypeInversion(void *spinorOut, void **spinorOutMulti, void *spinorIn, void *spinorCheck,
                                    QudaGaugeParam &gauge_param, QudaInvertParam &inv_param, void **gauge, void *clover,
                                    void *clover_inv)
@@ -153,8 +173,7 @@ void verifyDomainWallTypeInversion(void *spinorOut, void **spinorOutMulti, void
   }
 
   int vol = inv_param.solution_type == QUDA_MAT_SOLUTION ? V : Vh;
-  mxpy(spinorIn, spinorCheck, vol * spinor_site_size * inv_param.Ls, inv_param.cpu_prec);
-  double nrm2 = norm_2(spinorCheck, vol * spinor_site_size * inv_param.Ls, inv_param.cpu_prec);
+  double nrm2 = mxpy_norm_2(spinorIn, spinorCheck, vol * spinor_site_size * inv_param.Ls, inv_param.cpu_prec);
   double src2 = norm_2(spinorIn, vol * spinor_site_size * inv_param.Ls, inv_param.cpu_prec);
   double l2r = sqrt(nrm2 / src2);
 
@@ -222,8 +241,7 @@ void verifyWilsonTypeInversion(void *spinorOut, void **spinorOutMulti, void *spi
       }
 
       axpy(inv_param.offset[i], spinorOutMulti[i], spinorCheck, Vh * spinor_site_size, inv_param.cpu_prec);
-      mxpy(spinorIn, spinorCheck, Vh * spinor_site_size, inv_param.cpu_prec);
-      double nrm2 = norm_2(spinorCheck, Vh * spinor_site_size, inv_param.cpu_prec);
+      double nrm2 = mxpy_norm_2(spinorIn, spinorCheck, Vh * spinor_site_size, inv_param.cpu_prec);
       double src2 = norm_2(spinorIn, Vh * spinor_site_size, inv_param.cpu_prec);
       double l2r = sqrt(nrm2 / src2);
 
@@ -363,8 +381,7 @@ void verifyWilsonTypeInversion(void *spinorOut, void **spinorOutMulti, void *spi
     }
 
     int vol = inv_param.solution_type == QUDA_MAT_SOLUTION ? V : Vh;
-    mxpy(spinorIn, spinorCheck, vol * spinor_site_size * inv_param.Ls, inv_param.cpu_prec);
-    double nrm2 = norm_2(spinorCheck, vol * spinor_site_size * inv_param.Ls, inv_param.cpu_prec);
+    double nrm2 = mxpy_norm_2(spinorIn, spinorCheck, vol * spinor_site_size * inv_param.Ls, inv_param.cpu_prec);
     double src2 = norm_2(spinorIn, vol * spinor_site_size * inv_param.Ls, inv_param.cpu_prec);
     double l2r = sqrt(nrm2 / src2);
 
@@ -373,6 +390,92 @@ void verifyWilsonTypeInversion(void *spinorOut, void **spinorOutMulti, void *spi
   }
 }
 
+void verifyWilsonTypeInversion(void **spinorOut, void **spinorIn, void **spinorCheck, int num_src,
+                               QudaGaugeParam &gauge_param, QudaInvertParam &inv_param, void **gauge, void *clover,
+                               void *clover_inv)
+{
+  if (inv_param.solution_type == QUDA_MAT_SOLUTION) {
+    if (dslash_type == QUDA_TWISTED_CLOVER_DSLASH) {
+      tmc_mat_msrc(spinorCheck, gauge, clover, spinorOut, num_src, inv_param.kappa, inv_param.mu,
+                   inv_param.twist_flavor, 0, inv_param.cpu_prec, gauge_param);
+    } else if (dslash_type == QUDA_WILSON_DSLASH) {
+      wil_mat_msrc(spinorCheck, gauge, spinorOut, num_src, inv_param.kappa, 0, inv_param.cpu_prec, gauge_param);
+    } else if (dslash_type == QUDA_CLOVER_WILSON_DSLASH) {
+      clover_mat_msrc(spinorCheck, gauge, clover, spinorOut, num_src, inv_param.kappa, 0, inv_param.cpu_prec,
+                      gauge_param);
+    } else {
+      errorQuda("Unsupported dslash_type=%s", get_dslash_str(dslash_type));
+    }
+    if (inv_param.mass_normalization == QUDA_MASS_NORMALIZATION) {
+      for (int i = 0; i < num_src; i++)
+        ax(0.5 / inv_param.kappa, spinorCheck[i], V * spinor_site_size, inv_param.cpu_prec);
+    }
+
+  } else if (inv_param.solution_type == QUDA_MATPC_SOLUTION) {
+
+    if (dslash_type == QUDA_TWISTED_CLOVER_DSLASH) {
+      tmc_matpc_msrc(spinorCheck, gauge, spinorOut, num_src, clover, clover_inv, inv_param.kappa, inv_param.mu,
+                     inv_param.twist_flavor, inv_param.matpc_type, 0, inv_param.cpu_prec, gauge_param);
+    } else if (dslash_type == QUDA_WILSON_DSLASH) {
+      wil_matpc_msrc(spinorCheck, gauge, spinorOut, num_src, inv_param.kappa, inv_param.matpc_type, 0,
+                     inv_param.cpu_prec, gauge_param);
+    } else if (dslash_type == QUDA_CLOVER_WILSON_DSLASH) {
+      clover_matpc_msrc(spinorCheck, gauge, clover, clover_inv, spinorOut, num_src, inv_param.kappa,
+                        inv_param.matpc_type, 0, inv_param.cpu_prec, gauge_param);
+    } else {
+      errorQuda("Unsupported dslash_type=%s", get_dslash_str(dslash_type));
+    }
+
+    if (inv_param.mass_normalization == QUDA_MASS_NORMALIZATION) {
+      for (int i = 0; i < num_src; i++)
+        ax(0.25 / (inv_param.kappa * inv_param.kappa), spinorCheck[i], Vh * spinor_site_size, inv_param.cpu_prec);
+    }
+
+  } else if (inv_param.solution_type == QUDA_MATPCDAG_MATPC_SOLUTION) {
+
+    const size_t spinor_bytes = V * spinor_site_size * host_spinor_data_type_size * inv_param.Ls;
+    void *tmp_buffer = malloc(num_src * spinor_bytes);
+    std::vector<void *> spinorTmp = fieldSplit(tmp_buffer, num_src, spinor_bytes);
+
+    if (dslash_type == QUDA_TWISTED_CLOVER_DSLASH) {
+      tmc_matpc_msrc(spinorTmp.data(), gauge, spinorOut, num_src, clover, clover_inv, inv_param.kappa, inv_param.mu,
+                     inv_param.twist_flavor, inv_param.matpc_type, 0, inv_param.cpu_prec, gauge_param);
+      tmc_matpc_msrc(spinorCheck, gauge, spinorTmp.data(), num_src, clover, clover_inv, inv_param.kappa, inv_param.mu,
+                     inv_param.twist_flavor, inv_param.matpc_type, 1, inv_param.cpu_prec, gauge_param);
+    } else if (dslash_type == QUDA_WILSON_DSLASH) {
+      wil_matpc_msrc(spinorTmp.data(), gauge, spinorOut, num_src, inv_param.kappa, inv_param.matpc_type, 0,
+                     inv_param.cpu_prec, gauge_param);
+      wil_matpc_msrc(spinorCheck, gauge, spinorTmp.data(), num_src, inv_param.kappa, inv_param.matpc_type, 1,
+                     inv_param.cpu_prec, gauge_param);
+    } else if (dslash_type == QUDA_CLOVER_WILSON_DSLASH) {
+      clover_matpc_msrc(spinorTmp.data(), gauge, clover, clover_inv, spinorOut, num_src, inv_param.kappa,
+                        inv_param.matpc_type, 0, inv_param.cpu_prec, gauge_param);
+      clover_matpc_msrc(spinorCheck, gauge, clover, clover_inv, spinorTmp.data(), num_src, inv_param.kappa,
+                        inv_param.matpc_type, 1, inv_param.cpu_prec, gauge_param);
+    } else {
+      errorQuda("Unsupported dslash_type=%s", get_dslash_str(dslash_type));
+    }
+
+    if (inv_param.mass_normalization == QUDA_MASS_NORMALIZATION) {
+      errorQuda("Mass normalization %s not implemented", get_mass_normalization_str(inv_param.mass_normalization));
+    }
+
+    free(tmp_buffer);
+  } else {
+    errorQuda("Solution type %s not implemented", get_solution_str(inv_param.solution_type));
+  }
+
+  int vol = inv_param.solution_type == QUDA_MAT_SOLUTION ? V : Vh;
+  for (int i = 0; i < num_src; i++) {
+    double nrm2 = mxpy_norm_2(spinorIn[i], spinorCheck[i], vol * spinor_site_size * inv_param.Ls, inv_param.cpu_prec);
+    double src2 = norm_2(spinorIn[i], vol * spinor_site_size * inv_param.Ls, inv_param.cpu_prec);
+    double l2r = sqrt(nrm2 / src2);
+
+    printfQuda("Source %d residuals: (L2 relative) tol %g, QUDA = %g, host = %g; (heavy-quark) tol %g, QUDA = %g\n", i,
+               inv_param.tol, inv_param.true_res, l2r, inv_param.tol_hq, inv_param.true_res_hq);
+  }
+}
+
 void verifyStaggeredInversion(quda::ColorSpinorField *tmp, quda::ColorSpinorField *ref, quda::ColorSpinorField *in,
                               quda::ColorSpinorField *out, double mass, void *qdp_fatlink[], void *qdp_longlink[],
                               void **ghost_fatlink, void **ghost_longlink, QudaGaugeParam &gauge_param,
@@ -421,8 +524,7 @@ void verifyStaggeredInversion(quda::ColorSpinorField *tmp, quda::ColorSpinorFiel
     len = Vh;
   }
 
-  mxpy(in->V(), ref->V(), len * my_spinor_site_size, inv_param.cpu_prec);
-  double nrm2 = norm_2(ref->V(), len * my_spinor_site_size, inv_param.cpu_prec);
+  double nrm2 = mxpy_norm_2(in->V(), ref->V(), len * my_spinor_site_size, inv_param.cpu_prec);
   double src2 = norm_2(in->V(), len * my_spinor_site_size, inv_param.cpu_prec);
   double hqr = sqrt(quda::blas::HeavyQuarkResidualNorm(*out, *ref).z);
   double l2r = sqrt(nrm2 / src2);
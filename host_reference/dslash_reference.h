@@ -1,6 +1,9 @@
 #pragma once
 
+#include <vector>
+
 #include <host_utils.h>
+#include <host_su3.h>
 #include <comm_quda.h>
 
 template <typename Float>
@@ -51,500 +54,195 @@ static inline void negx(Float *x, int len) {
   for (int i=0; i<len; i++) x[i] = -x[i];
 }
 
-template <typename sFloat, typename gFloat>
-static inline void dot(sFloat* res, gFloat* a, sFloat* b) {
-  res[0] = res[1] = 0;
-  for (int m = 0; m < 3; m++) {
-    sFloat a_re = a[2*m+0];
-    sFloat a_im = a[2*m+1];
-    sFloat b_re = b[2*m+0];
-    sFloat b_im = b[2*m+1];
-    res[0] += a_re * b_re - a_im * b_im;
-    res[1] += a_re * b_im + a_im * b_re;
+/**
+   @brief Multiplication of a complex number by one of the unit
+   phases that appear in the Wilson spin projectors.
+ */
+enum SpinPhase { SPIN_PHASE_PLUS_ONE, SPIN_PHASE_MINUS_ONE, SPIN_PHASE_PLUS_I, SPIN_PHASE_MINUS_I };
+
+/**
+   @brief z = x + phase * y for complex x, y, z
+ */
+template <SpinPhase phase, typename Float> static inline void spinPhaseAdd(Float *z, const Float *x, const Float *y)
+{
+  switch (phase) {
+  case SPIN_PHASE_PLUS_ONE: z[0] = x[0] + y[0]; z[1] = x[1] + y[1]; break;
+  case SPIN_PHASE_MINUS_ONE: z[0] = x[0] - y[0]; z[1] = x[1] - y[1]; break;
+  case SPIN_PHASE_PLUS_I: z[0] = x[0] - y[1]; z[1] = x[1] + y[0]; break;
+  case SPIN_PHASE_MINUS_I: z[0] = x[0] + y[1]; z[1] = x[1] - y[0]; break;
   }
 }
 
-template <typename Float>
-static inline void su3Transpose(Float *res, Float *mat) {
+/**
+   @brief The Wilson spin projectors P = (1 -/+ gamma_mu) in the
+   DeGrand-Rossi basis, indexed by projIdx = 2 * mu + (dir + dagger) % 2.
+   Each projector has rank two: the upper spin components of the
+   projected spinor are h_s = psi_s + upper_s * psi_{partner_s}, and
+   the lower ones are (P psi)_{2+s} = lower_s * h_{source_s}, so only
+   h needs to be multiplied by the gauge link.
+ */
+template <int projIdx> struct WilsonProjector;
+
+#define WILSON_PROJECTOR(idx, p0, a0, p1, a1, q2, b2, q3, b3)                                                           \
+  template <> struct WilsonProjector<idx> {                                                                            \
+    static constexpr int partner0 = p0, partner1 = p1, source2 = q2, source3 = q3;                                     \
+    static constexpr SpinPhase upper0 = a0, upper1 = a1, lower2 = b2, lower3 = b3;                                     \
+  };
+
+WILSON_PROJECTOR(0, 3, SPIN_PHASE_MINUS_I, 2, SPIN_PHASE_MINUS_I, 1, SPIN_PHASE_PLUS_I, 0, SPIN_PHASE_PLUS_I)
+WILSON_PROJECTOR(1, 3, SPIN_PHASE_PLUS_I, 2, SPIN_PHASE_PLUS_I, 1, SPIN_PHASE_MINUS_I, 0, SPIN_PHASE_MINUS_I)
+WILSON_PROJECTOR(2, 3, SPIN_PHASE_PLUS_ONE, 2, SPIN_PHASE_MINUS_ONE, 1, SPIN_PHASE_MINUS_ONE, 0, SPIN_PHASE_PLUS_ONE)
+WILSON_PROJECTOR(3, 3, SPIN_PHASE_MINUS_ONE, 2, SPIN_PHASE_PLUS_ONE, 1, SPIN_PHASE_PLUS_ONE, 0, SPIN_PHASE_MINUS_ONE)
+WILSON_PROJECTOR(4, 2, SPIN_PHASE_MINUS_I, 3, SPIN_PHASE_PLUS_I, 0, SPIN_PHASE_PLUS_I, 1, SPIN_PHASE_MINUS_I)
+WILSON_PROJECTOR(5, 2, SPIN_PHASE_PLUS_I, 3, SPIN_PHASE_MINUS_I, 0, SPIN_PHASE_MINUS_I, 1, SPIN_PHASE_PLUS_I)
+WILSON_PROJECTOR(6, 2, SPIN_PHASE_MINUS_ONE, 3, SPIN_PHASE_MINUS_ONE, 0, SPIN_PHASE_MINUS_ONE, 1, SPIN_PHASE_MINUS_ONE)
+WILSON_PROJECTOR(7, 2, SPIN_PHASE_PLUS_ONE, 3, SPIN_PHASE_PLUS_ONE, 0, SPIN_PHASE_PLUS_ONE, 1, SPIN_PHASE_PLUS_ONE)
+
+#undef WILSON_PROJECTOR
+
+/**
+   @brief Project a Wilson spinor onto its two-spin-component half spinor
+   @param[out] half The half spinor h (2 spins x 3 colors, complex)
+   @param[in] spinor The input spinor (4 spins x 3 colors, complex)
+ */
+template <int projIdx, typename Float> static inline void spinProject(Float *half, const Float *spinor)
+{
+  using P = WilsonProjector<projIdx>;
   for (int m = 0; m < 3; m++) {
-    for (int n = 0; n < 3; n++) {
-      res[m*(3*2) + n*(2) + 0] = + mat[n*(3*2) + m*(2) + 0];
-      res[m*(3*2) + n*(2) + 1] = - mat[n*(3*2) + m*(2) + 1];
-    }
+    spinPhaseAdd<P::upper0>(&half[0 * 6 + m * 2], &spinor[0 * 6 + m * 2], &spinor[P::partner0 * 6 + m * 2]);
+    spinPhaseAdd<P::upper1>(&half[1 * 6 + m * 2], &spinor[1 * 6 + m * 2], &spinor[P::partner1 * 6 + m * 2]);
   }
 }
 
-
-template <typename sFloat, typename gFloat>
-static inline void su3Mul(sFloat *res, gFloat *mat, sFloat *vec) {
-  for (int n = 0; n < 3; n++) dot(&res[n*(2)], &mat[n*(3*2)], vec);
-}
-
-template <typename sFloat, typename gFloat>
-static inline void su3Tmul(sFloat *res, gFloat *mat, sFloat *vec) {
-  gFloat matT[3*3*2];
-  su3Transpose(matT, mat);
-  su3Mul(res, matT, vec);
-}
-void verifyInversion(void *spinorOut, void *spinorIn, void *spinorCheck, QudaGaugeParam &gauge_param,
-                     QudaInvertParam &inv_param, void **gauge, void *clover, void *clover_inv);
-
-void verifyInversion(void *spinorOut, void **spinorOutMulti, void *spinorIn, void *spinorCheck,
-                     QudaGaugeParam &gauge_param, QudaInvertParam &inv_param, void **gauge, void *clover,
-                     void *clover_inv);
-
-void verifyDomainWallTypeInversion(void *spinorOut, void **spinorOutMulti, void *spinorIn, void *spinorCheck,
-                                   QudaGaugeParam &gauge_param, QudaInvertParam &inv_param, void **gauge, void *clover,
-                                   void *clover_inv);
-
-void verifyWilsonTypeInversion(void *spinorOut, void **spinorOutMulti, void *spinorIn, void *spinorCheck,
-                               QudaGaugeParam &gauge_param, QudaInvertParam &inv_param, void **gauge, void *clover,
-                               void *clover_inv);
-
-void verifyStaggeredInversion(quda::ColorSpinorField *tmp, quda::ColorSpinorField *ref, quda::ColorSpinorField *in,
-                              quda::ColorSpinorField *out, double mass, void *qdp_fatlink[], void *qdp_longlink[],
-                              void **ghost_fatlink, void **ghost_longlink, QudaGaugeParam &gauge_param,
-                              QudaInvertParam &inv_param, int shift);
-
-// i represents a "half index" into an even or odd "half lattice".
-// when oddBit={0,1} the half lattice is {even,odd}.
-// 
-// the displacements, such as dx, refer to the full lattice coordinates. 
-//
-// neighborIndex() takes a "half index", displaces it, and returns the
-// new "half index", which can be an index into either the even or odd lattices.
-// displacements of magnitude one always interchange odd and even lattices.
-//
-
-
-template <typename Float>
-static inline Float *gaugeLink(int i, int dir, int oddBit, Float **gaugeEven, Float **gaugeOdd, int nbr_distance) {
-  Float **gaugeField;
-  int j;
-  int d = nbr_distance;
-  if (dir % 2 == 0) {
-    j = i;
-    gaugeField = (oddBit ? gaugeOdd : gaugeEven);
-  }
-  else {
-    switch (dir) {
-    case 1: j = neighborIndex(i, oddBit, 0, 0, 0, -d); break;
-    case 3: j = neighborIndex(i, oddBit, 0, 0, -d, 0); break;
-    case 5: j = neighborIndex(i, oddBit, 0, -d, 0, 0); break;
-    case 7: j = neighborIndex(i, oddBit, -d, 0, 0, 0); break;
-    default: j = -1; break;
+/**
+   @brief Reconstruct the full spinor from a half spinor and add it to
+   res, i.e., res += P psi given h
+   @param[in,out] res The spinor we are accumulating into
+   @param[in] half The (typically gauge-transported) half spinor h
+ */
+template <int projIdx, typename Float> static inline void spinReconstructAdd(Float *res, const Float *half)
+{
+  using P = WilsonProjector<projIdx>;
+  for (int m = 0; m < 3; m++) {
+    for (int s = 0; s < 2; s++) {
+      res[s * 6 + m * 2 + 0] += half[s * 6 + m * 2 + 0];
+      res[s * 6 + m * 2 + 1] += half[s * 6 + m * 2 + 1];
     }
-    gaugeField = (oddBit ? gaugeEven : gaugeOdd);
+    spinPhaseAdd<P::lower2>(&res[2 * 6 + m * 2], &res[2 * 6 + m * 2], &half[P::source2 * 6 + m * 2]);
+    spinPhaseAdd<P::lower3>(&res[3 * 6 + m * 2], &res[3 * 6 + m * 2], &half[P::source3 * 6 + m * 2]);
   }
-  
-  return &gaugeField[dir/2][j*(3*3*2)];
 }
 
-template <typename Float>
-static inline Float *spinorNeighbor(int i, int dir, int oddBit, Float *spinorField, int neighbor_distance) 
+/**
+   @brief Add a single Wilson hopping term to res: res += U P psi for a
+   forwards hop, and res += U^dagger P psi for a backwards hop.  The
+   link is only applied to the two components of the half spinor.
+   @param[in,out] res The spinor we are accumulating into
+   @param[in] gauge The link matrix
+   @param[in] spinor The neighboring spinor
+   @param[in] backwards Whether this is a backwards hop
+ */
+template <int projIdx, typename sFloat, typename gFloat>
+static inline void wilsonHop(sFloat *res, gFloat *gauge, sFloat *spinor, bool backwards)
 {
-  int j;
-  int nb = neighbor_distance;
-  switch (dir) {
-  case 0: j = neighborIndex(i, oddBit, 0, 0, 0, +nb); break;
-  case 1: j = neighborIndex(i, oddBit, 0, 0, 0, -nb); break;
-  case 2: j = neighborIndex(i, oddBit, 0, 0, +nb, 0); break;
-  case 3: j = neighborIndex(i, oddBit, 0, 0, -nb, 0); break;
-  case 4: j = neighborIndex(i, oddBit, 0, +nb, 0, 0); break;
-  case 5: j = neighborIndex(i, oddBit, 0, -nb, 0, 0); break;
-  case 6: j = neighborIndex(i, oddBit, +nb, 0, 0, 0); break;
-  case 7: j = neighborIndex(i, oddBit, -nb, 0, 0, 0); break;
-  default: j = -1; break;
+  sFloat projectedSpinor[2 * 3 * 2], gaugedSpinor[2 * 3 * 2];
+  spinProject<projIdx>(projectedSpinor, spinor);
+
+  for (int s = 0; s < 2; s++) {
+    if (!backwards)
+      su3MatVec(&gaugedSpinor[s * (3 * 2)], gauge, &projectedSpinor[s * (3 * 2)]);
+    else
+      su3AdjMatVec(&gaugedSpinor[s * (3 * 2)], gauge, &projectedSpinor[s * (3 * 2)]);
   }
 
-  return &spinorField[j * (my_spinor_site_size)];
-}
-
-
-// i represents a "half index" into an even or odd "half lattice".
-// when oddBit={0,1} the half lattice is {even,odd}.
-//
-// the displacements, such as dx, refer to the full lattice coordinates.
-//
-// neighborIndex() takes a "half index", displaces it, and returns the
-// new "half index", which can be an index into either the even or odd lattices.
-// displacements of magnitude one always interchange odd and even lattices.
-//
-//
-template <QudaPCType type> int neighborIndex_5d(int i, int oddBit, int dxs, int dx4, int dx3, int dx2, int dx1)
-{
-  // fullLatticeIndex was modified for fullLatticeIndex_4d.  It is in util_quda.cpp.
-  // This code bit may not properly perform 5dPC.
-  int X = type == QUDA_5D_PC ? fullLatticeIndex_5d(i, oddBit) : fullLatticeIndex_5d_4dpc(i, oddBit);
-  // Checked that this matches code in dslash_core_ante.h.
-  int xs = X/(Z[3]*Z[2]*Z[1]*Z[0]);
-  int x4 = (X/(Z[2]*Z[1]*Z[0])) % Z[3];
-  int x3 = (X/(Z[1]*Z[0])) % Z[2];
-  int x2 = (X/Z[0]) % Z[1];
-  int x1 = X % Z[0];
-  // Displace and project back into domain 0,...,Ls-1.
-  // Note that we add Ls to avoid the negative problem
-  // of the C % operator.
-  xs = (xs+dxs+Ls) % Ls;
-  // Etc.
-  x4 = (x4+dx4+Z[3]) % Z[3];
-  x3 = (x3+dx3+Z[2]) % Z[2];
-  x2 = (x2+dx2+Z[1]) % Z[1];
-  x1 = (x1+dx1+Z[0]) % Z[0];
-  // Return linear half index.  Remember that integer division
-  // rounds down.
-  return (xs*(Z[3]*Z[2]*Z[1]*Z[0]) + x4*(Z[2]*Z[1]*Z[0]) + x3*(Z[1]*Z[0]) + x2*(Z[0]) + x1) / 2;
+  spinReconstructAdd<projIdx>(res, gaugedSpinor);
 }
 
-template <QudaPCType type, typename Float>
-Float *spinorNeighbor_5d(int i, int dir, int oddBit, Float *spinorField, int neighbor_distance = 1, int siteSize = 24)
+/**
+   @brief Runtime dispatch to the projector specialization for
+   hopping direction dir (0..7) and daggerBit.
+ */
+template <typename sFloat, typename gFloat>
+static inline void wilsonHop(sFloat *res, gFloat *gauge, sFloat *spinor, int dir, int daggerBit)
 {
-  int nb = neighbor_distance;
-  int j;
-  switch (dir) {
-  case 0: j = neighborIndex_5d<type>(i, oddBit, 0, 0, 0, 0, +nb); break;
-  case 1: j = neighborIndex_5d<type>(i, oddBit, 0, 0, 0, 0, -nb); break;
-  case 2: j = neighborIndex_5d<type>(i, oddBit, 0, 0, 0, +nb, 0); break;
-  case 3: j = neighborIndex_5d<type>(i, oddBit, 0, 0, 0, -nb, 0); break;
-  case 4: j = neighborIndex_5d<type>(i, oddBit, 0, 0, +nb, 0, 0); break;
-  case 5: j = neighborIndex_5d<type>(i, oddBit, 0, 0, -nb, 0, 0); break;
-  case 6: j = neighborIndex_5d<type>(i, oddBit, 0, +nb, 0, 0, 0); break;
-  case 7: j = neighborIndex_5d<type>(i, oddBit, 0, -nb, 0, 0, 0); break;
-  case 8: j = neighborIndex_5d<type>(i, oddBit, +nb, 0, 0, 0, 0); break;
-  case 9: j = neighborIndex_5d<type>(i, oddBit, -nb, 0, 0, 0, 0); break;
-  default: j = -1; break;
+  const bool backwards = dir % 2;
+  switch (2 * (dir / 2) + (dir + daggerBit) % 2) {
+  case 0: wilsonHop<0>(res, gauge, spinor, backwards); break;
+  case 1: wilsonHop<1>(res, gauge, spinor, backwards); break;
+  case 2: wilsonHop<2>(res, gauge, spinor, backwards); break;
+  case 3: wilsonHop<3>(res, gauge, spinor, backwards); break;
+  case 4: wilsonHop<4>(res, gauge, spinor, backwards); break;
+  case 5: wilsonHop<5>(res, gauge, spinor, backwards); break;
+  case 6: wilsonHop<6>(res, gauge, spinor, backwards); break;
+  case 7: wilsonHop<7>(res, gauge, spinor, backwards); break;
+  default: break;
   }
-  return &spinorField[j*siteSize];
 }
 
-#ifdef MULTI_GPU
-inline int x4_mg(int i, int oddBit)
+/**
+   @brief Add the fifth-dimension (chiral) hopping term to res:
+   res += a * 2 P_+ psi (lower spins) if upper = false, or
+   res += a * 2 P_- psi (upper spins) if upper = true, in the
+   DeGrand-Rossi basis where gamma_5 is diagonal.
+ */
+template <bool upper, typename Float> static inline void chiralProjectAdd(Float *res, const Float *spinor, Float a)
 {
-  int Y = fullLatticeIndex(i, oddBit);
-  int x4 = Y/(Z[2]*Z[1]*Z[0]);
-  return x4;
+  for (int i = (upper ? 0 : 12); i < (upper ? 12 : 24); i++) res[i] += a * (2 * spinor[i]);
 }
 
-template <typename Float>
-static inline Float *gaugeLink_mg4dir(int i, int dir, int oddBit, Float **gaugeEven, Float **gaugeOdd,
-			Float** ghostGaugeEven, Float** ghostGaugeOdd, int n_ghost_faces, int nbr_distance) {
-  Float **gaugeField;
-  int j;
-  int d = nbr_distance;
-  if (dir % 2 == 0) {
-    j = i;
-    gaugeField = (oddBit ? gaugeOdd : gaugeEven);
-  }
-  else {
-
-    int Y = fullLatticeIndex(i, oddBit);
-    int x4 = Y/(Z[2]*Z[1]*Z[0]);
-    int x3 = (Y/(Z[1]*Z[0])) % Z[2];
-    int x2 = (Y/Z[0]) % Z[1];
-    int x1 = Y % Z[0];
-    int X1= Z[0];
-    int X2= Z[1];
-    int X3= Z[2];
-    int X4= Z[3];
-    Float* ghostGaugeField;
-
-    switch (dir) {
-    case 1:
-      { //-X direction
-        int new_x1 = (x1 - d + X1 )% X1;
-        if (x1 -d < 0 && comm_dim_partitioned(0)){
-	  ghostGaugeField = (oddBit?ghostGaugeEven[0]: ghostGaugeOdd[0]);
-	  int offset = (n_ghost_faces + x1 -d)*X4*X3*X2/2 + (x4*X3*X2 + x3*X2+x2)/2;
-	  return &ghostGaugeField[offset*(3*3*2)];
-        }
-        j = (x4*X3*X2*X1 + x3*X2*X1 + x2*X1 + new_x1) / 2;
-        break;
-      }
-    case 3:
-      { //-Y direction
-        int new_x2 = (x2 - d + X2 )% X2;
-        if (x2 -d < 0 && comm_dim_partitioned(1)){
-          ghostGaugeField = (oddBit?ghostGaugeEven[1]: ghostGaugeOdd[1]);
-          int offset = (n_ghost_faces + x2 -d)*X4*X3*X1/2 + (x4*X3*X1 + x3*X1+x1)/2;
-          return &ghostGaugeField[offset*(3*3*2)];
-        }
-        j = (x4*X3*X2*X1 + x3*X2*X1 + new_x2*X1 + x1) / 2;
-        break;
-
-      }
-    case 5:
-      { //-Z direction
-        int new_x3 = (x3 - d + X3 )% X3;
-        if (x3 -d < 0 && comm_dim_partitioned(2)){
-          ghostGaugeField = (oddBit?ghostGaugeEven[2]: ghostGaugeOdd[2]);
-          int offset = (n_ghost_faces + x3 -d)*X4*X2*X1/2 + (x4*X2*X1 + x2*X1+x1)/2;
-          return &ghostGaugeField[offset*(3*3*2)];
-        }
-        j = (x4*X3*X2*X1 + new_x3*X2*X1 + x2*X1 + x1) / 2;
-        break;
-      }
-    case 7:
-      { //-T direction
-        int new_x4 = (x4 - d + X4)% X4;
-        if (x4 -d < 0 && comm_dim_partitioned(3)){
-          ghostGaugeField = (oddBit?ghostGaugeEven[3]: ghostGaugeOdd[3]);
-          int offset = (n_ghost_faces + x4 -d)*X1*X2*X3/2 + (x3*X2*X1 + x2*X1+x1)/2;
-          return &ghostGaugeField[offset*(3*3*2)];
-        }
-        j = (new_x4*(X3*X2*X1) + x3*(X2*X1) + x2*(X1) + x1) / 2;
-        break;
-      }//7
-
-    default: j = -1; printf("ERROR: wrong dir \n"); exit(1);
-    }
-    gaugeField = (oddBit ? gaugeEven : gaugeOdd);
-
-  }
-
-  return &gaugeField[dir/2][j*(3*3*2)];
+/**
+   @brief Return the pointers field[s] + offset bytes for each of a
+   set of nSrc fields, e.g., the odd-parity halves of full fields
+ */
+inline std::vector<void *> fieldOffset(void *const *field, int nSrc, size_t offset)
+{
+  std::vector<void *> set(nSrc);
+  for (int s = 0; s < nSrc; s++) set[s] = static_cast<char *>(field[s]) + offset;
+  return set;
 }
 
-template <typename Float>
-static inline Float *spinorNeighbor_mg4dir(int i, int dir, int oddBit, Float *spinorField, Float** fwd_nbr_spinor, 
-					   Float** back_nbr_spinor, int neighbor_distance, int nFace)
+/**
+   @brief Partition a single allocation into a set of nSrc
+   consecutive fields of the given size
+ */
+inline std::vector<void *> fieldSplit(void *buffer, int nSrc, size_t bytes)
 {
-  int j;
-  int nb = neighbor_distance;
-  int Y = fullLatticeIndex(i, oddBit);
-  int x4 = Y/(Z[2]*Z[1]*Z[0]);
-  int x3 = (Y/(Z[1]*Z[0])) % Z[2];
-  int x2 = (Y/Z[0]) % Z[1];
-  int x1 = Y % Z[0];
-  int X1= Z[0];
-  int X2= Z[1];
-  int X3= Z[2];
-  int X4= Z[3];
-
-  switch (dir) {
-  case 0://+X
-    {
-      int new_x1 = (x1 + nb)% X1;
-      if(x1+nb >=X1 && comm_dim_partitioned(0) ){
-        int offset = ( x1 + nb -X1)*X4*X3*X2/2+(x4*X3*X2 + x3*X2+x2)/2;
-        return fwd_nbr_spinor[0] + offset * my_spinor_site_size;
-      }
-      j = (x4*X3*X2*X1 + x3*X2*X1 + x2*X1 + new_x1) / 2;
-      break;
-    }
-  case 1://-X
-    {
-      int new_x1 = (x1 - nb + X1)% X1;
-      if(x1 - nb < 0 && comm_dim_partitioned(0)){
-        int offset = ( x1+nFace- nb)*X4*X3*X2/2+(x4*X3*X2 + x3*X2+x2)/2;
-        return back_nbr_spinor[0] + offset * my_spinor_site_size;
-      } 
-      j = (x4*X3*X2*X1 + x3*X2*X1 + x2*X1 + new_x1) / 2;
-      break;
-    }
-  case 2://+Y
-    {
-      int new_x2 = (x2 + nb)% X2;
-      if(x2+nb >=X2 && comm_dim_partitioned(1)){
-        int offset = ( x2 + nb -X2)*X4*X3*X1/2+(x4*X3*X1 + x3*X1+x1)/2;
-        return fwd_nbr_spinor[1] + offset * my_spinor_site_size;
-      } 
-      j = (x4*X3*X2*X1 + x3*X2*X1 + new_x2*X1 + x1) / 2;
-      break;
-    }
-  case 3:// -Y
-    {
-      int new_x2 = (x2 - nb + X2)% X2;
-      if(x2 - nb < 0 && comm_dim_partitioned(1)){
-        int offset = ( x2 + nFace -nb)*X4*X3*X1/2+(x4*X3*X1 + x3*X1+x1)/2;
-        return back_nbr_spinor[1] + offset * my_spinor_site_size;
-      } 
-      j = (x4*X3*X2*X1 + x3*X2*X1 + new_x2*X1 + x1) / 2;
-      break;
-    }
-  case 4://+Z
-    {
-      int new_x3 = (x3 + nb)% X3;
-      if(x3+nb >=X3 && comm_dim_partitioned(2)){
-        int offset = ( x3 + nb -X3)*X4*X2*X1/2+(x4*X2*X1 + x2*X1+x1)/2;
-        return fwd_nbr_spinor[2] + offset * my_spinor_site_size;
-      } 
-      j = (x4*X3*X2*X1 + new_x3*X2*X1 + x2*X1 + x1) / 2;
-      break;
-    }
-  case 5://-Z
-    {
-      int new_x3 = (x3 - nb + X3)% X3;
-      if(x3 - nb < 0 && comm_dim_partitioned(2)){
-        int offset = ( x3 + nFace -nb)*X4*X2*X1/2+(x4*X2*X1 + x2*X1+x1)/2;
-        return back_nbr_spinor[2] + offset * my_spinor_site_size;
-      }
-      j = (x4*X3*X2*X1 + new_x3*X2*X1 + x2*X1 + x1) / 2;
-      break;
-    }
-  case 6://+T
-    {
-      j = neighborIndex_mg(i, oddBit, +nb, 0, 0, 0);
-      int x4 = x4_mg(i, oddBit);
-      if ( (x4 + nb) >= Z[3]  && comm_dim_partitioned(3)){
-        int offset = (x4+nb - Z[3])*Vsh_t;
-        return &fwd_nbr_spinor[3][(offset + j) * my_spinor_site_size];
-      }
-      break;
-    }
-  case 7://-T
-    {
-      j = neighborIndex_mg(i, oddBit, -nb, 0, 0, 0);
-      int x4 = x4_mg(i, oddBit);
-      if ( (x4 - nb) < 0 && comm_dim_partitioned(3)){
-        int offset = ( x4 - nb +nFace)*Vsh_t;
-        return &back_nbr_spinor[3][(offset + j) * my_spinor_site_size];
-      }
-      break;
-    }
-  default: j = -1; printf("ERROR: wrong dir\n"); exit(1);
-  }
-
-  return &spinorField[j * (my_spinor_site_size)];
+  std::vector<void *> set(nSrc);
+  for (int s = 0; s < nSrc; s++) set[s] = static_cast<char *>(buffer) + s * bytes;
+  return set;
 }
 
-template <QudaPCType type> int neighborIndex_5d_mgpu(int i, int oddBit, int dxs, int dx4, int dx3, int dx2, int dx1)
-{
-  int ret;
-
-  int Y = (type == QUDA_5D_PC) ? fullLatticeIndex_5d(i, oddBit) : fullLatticeIndex_5d_4dpc(i, oddBit);
-
-  int xs = Y/(Z[3]*Z[2]*Z[1]*Z[0]);
-  int x4 = (Y/(Z[2]*Z[1]*Z[0])) % Z[3];
-  int x3 = (Y/(Z[1]*Z[0])) % Z[2];
-  int x2 = (Y/Z[0]) % Z[1];
-  int x1 = Y % Z[0];
-  int ghost_x4 = x4+ dx4;
-
-  xs = (xs+dxs+Ls) % Ls;
-  x4 = (x4+dx4+Z[3]) % Z[3];
-  x3 = (x3+dx3+Z[2]) % Z[2];
-  x2 = (x2+dx2+Z[1]) % Z[1];
-  x1 = (x1+dx1+Z[0]) % Z[0];
-
-  if ( (ghost_x4 >= 0 && ghost_x4) < Z[3] || !comm_dim_partitioned(3)){
-    ret = (xs*Z[3]*Z[2]*Z[1]*Z[0] + x4*Z[2]*Z[1]*Z[0] + x3*Z[1]*Z[0] + x2*Z[0] + x1) >> 1;
-  }else{
-    ret = (xs*Z[2]*Z[1]*Z[0] + x3*Z[1]*Z[0] + x2*Z[0] + x1) >> 1;
-  }
+void verifyInversion(void *spinorOut, void *spinorIn, void *spinorCheck, QudaGaugeParam &gauge_param,
+                     QudaInvertParam &inv_param, void **gauge, void *clover, void *clover_inv);
 
-  return ret;
-}
+void verifyInversion(void *spinorOut, void **spinorOutMulti, void *spinorIn, void *spinorCheck,
+                     QudaGaugeParam &gauge_param, QudaInvertParam &inv_param, void **gauge, void *clover,
+                     void *clover_inv);
 
-template <QudaPCType type> int x4_5d_mgpu(int i, int oddBit)
-{
-  int Y = (type == QUDA_5D_PC) ? fullLatticeIndex_5d(i, oddBit) : fullLatticeIndex_5d_4dpc(i, oddBit);
-  return (Y/(Z[2]*Z[1]*Z[0])) % Z[3];
-}
+/**
+   @brief Verify the solutions of a multi-source inversion, e.g., from
+   invertMultiSrcQuda.  The Wilson, clover and twisted-clover
+   operators are applied to all sources at once.
+   @param[in] spinorOut The num_src solution vectors
+   @param[in] spinorIn The num_src source vectors
+   @param[in] num_src The number of sources
+ */
+void verifyInversion(void **spinorOut, void **spinorIn, int num_src, QudaGaugeParam &gauge_param,
+                     QudaInvertParam &inv_param, void **gauge, void *clover, void *clover_inv);
 
-template <QudaPCType type, typename Float>
-Float *spinorNeighbor_5d_mgpu(int i, int dir, int oddBit, Float *spinorField, Float **fwd_nbr_spinor,
-    Float **back_nbr_spinor, int neighbor_distance, int nFace, int spinorSize = 24)
-{
-  int j;
-  int nb = neighbor_distance;
-  int Y = (type == QUDA_5D_PC) ? fullLatticeIndex_5d(i, oddBit) : fullLatticeIndex_5d_4dpc(i, oddBit);
-
-  int xs = Y/(Z[3]*Z[2]*Z[1]*Z[0]);
-  int x4 = (Y/(Z[2]*Z[1]*Z[0])) % Z[3];
-  int x3 = (Y/(Z[1]*Z[0])) % Z[2];
-  int x2 = (Y/Z[0]) % Z[1];
-  int x1 = Y % Z[0];
-
-  int X1= Z[0];
-  int X2= Z[1];
-  int X3= Z[2];
-  int X4= Z[3];
-  switch (dir) {
-  case 0://+X
-    {
-      int new_x1 = (x1 + nb)% X1;
-      if(x1+nb >=X1 && comm_dim_partitioned(0)) {
-        int offset = ((x1 + nb -X1)*Ls*X4*X3*X2+xs*X4*X3*X2+x4*X3*X2 + x3*X2+x2) >> 1;
-        return fwd_nbr_spinor[0] + offset*spinorSize;
-      }
-      j = (xs*X4*X3*X2*X1 + x4*X3*X2*X1 + x3*X2*X1 + x2*X1 + new_x1) >> 1;
-      break;
-    }
-  case 1://-X
-    {
-      int new_x1 = (x1 - nb + X1)% X1;
-      if(x1 - nb < 0 && comm_dim_partitioned(0)) {
-        int offset = (( x1+nFace- nb)*Ls*X4*X3*X2 + xs*X4*X3*X2 + x4*X3*X2 + x3*X2 + x2) >> 1;
-        return back_nbr_spinor[0] + offset*spinorSize;
-      }
-      j = (xs*X4*X3*X2*X1 + x4*X3*X2*X1 + x3*X2*X1 + x2*X1 + new_x1) >> 1;
-      break;
-    }
-  case 2://+Y
-    {
-      int new_x2 = (x2 + nb)% X2;
-      if(x2+nb >=X2 && comm_dim_partitioned(1)) {
-        int offset = (( x2 + nb -X2)*Ls*X4*X3*X1+xs*X4*X3*X1+x4*X3*X1 + x3*X1+x1) >> 1;
-        return fwd_nbr_spinor[1] + offset*spinorSize;
-      }
-      j = (xs*X4*X3*X2*X1 + x4*X3*X2*X1 + x3*X2*X1 + new_x2*X1 + x1) >> 1;
-      break;
-    }
-  case 3:// -Y
-    {
-      int new_x2 = (x2 - nb + X2)% X2;
-      if(x2 - nb < 0 && comm_dim_partitioned(1)) {
-        int offset = (( x2 + nFace -nb)*Ls*X4*X3*X1+xs*X4*X3*X1+ x4*X3*X1 + x3*X1+x1) >> 1;
-        return back_nbr_spinor[1] + offset*spinorSize;
-      }
-      j = (xs*X4*X3*X2*X1 + x4*X3*X2*X1 + x3*X2*X1 + new_x2*X1 + x1) >> 1;
-      break;
-    }
-  case 4://+Z
-    {
-      int new_x3 = (x3 + nb)% X3;
-      if(x3+nb >=X3 && comm_dim_partitioned(2)) {
-        int offset = (( x3 + nb -X3)*Ls*X4*X2*X1+xs*X4*X2*X1+x4*X2*X1 + x2*X1+x1) >> 1;
-        return fwd_nbr_spinor[2] + offset*spinorSize;
-      }
-      j = (xs*X4*X3*X2*X1 + x4*X3*X2*X1 + new_x3*X2*X1 + x2*X1 + x1) >> 1;
-      break;
-    }
-  case 5://-Z
-    {
-      int new_x3 = (x3 - nb + X3)% X3;
-      if(x3 - nb < 0 && comm_dim_partitioned(2)){
-        int offset = (( x3 + nFace -nb)*Ls*X4*X2*X1+xs*X4*X2*X1+x4*X2*X1+x2*X1+x1) >> 1;
-        return back_nbr_spinor[2] + offset*spinorSize;
-      }
-      j = (xs*X4*X3*X2*X1 + x4*X3*X2*X1 + new_x3*X2*X1 + x2*X1 + x1) >> 1;
-      break;
-    }
-  case 6://+T
-    {
-      int x4 = x4_5d_mgpu<type>(i, oddBit);
-      if ( (x4 + nb) >= Z[3] && comm_dim_partitioned(3)) {
-        int offset = ((x4 + nb - Z[3])*Ls*X3*X2*X1+xs*X3*X2*X1+x3*X2*X1+x2*X1+x1) >> 1;
-        return fwd_nbr_spinor[3] + offset*spinorSize;
-      }
-      j = neighborIndex_5d_mgpu<type>(i, oddBit, 0, +nb, 0, 0, 0);
-      break;
-    }
-  case 7://-T
-    {
-      int x4 = x4_5d_mgpu<type>(i, oddBit);
-      if ( (x4 - nb) < 0 && comm_dim_partitioned(3)) {
-        int offset = (( x4 - nb +nFace)*Ls*X3*X2*X1+xs*X3*X2*X1+x3*X2*X1+x2*X1+x1) >> 1;
-        return back_nbr_spinor[3] + offset*spinorSize;
-      }
-      j = neighborIndex_5d_mgpu<type>(i, oddBit, 0, -nb, 0, 0, 0);
-      break;
-    }
-  default: j = -1; printf("ERROR: wrong dir\n"); exit(1);
-  }
+void verifyDomainWallTypeInversion(void *spinorOut, void **spinorOutMulti, void *spinorIn, void *spinorCheck,
+                                   QudaGaugeParam &gauge_param, QudaInvertParam &inv_param, void **gauge, void *clover,
+                                   void *clover_inv);
 
-  return &spinorField[j*(spinorSize)];
-}
+void verifyWilsonTypeInversion(void *spinorOut, void **spinorOutMulti, void *spinorIn, void *spinorCheck,
+                               QudaGaugeParam &gauge_param, QudaInvertParam &inv_param, void **gauge, void *clover,
+                               void *clover_inv);
 
+void verifyWilsonTypeInversion(void **spinorOut, void **spinorIn, void **spinorCheck, int num_src,
+                               QudaGaugeParam &gauge_param, QudaInvertParam &inv_param, void **gauge, void *clover,
+                               void *clover_inv);
 
-#endif // MULTI_GPU
+void verifyStaggeredInversion(quda::ColorSpinorField *tmp, quda::ColorSpinorField *ref, quda::ColorSpinorField *in,
+                              quda::ColorSpinorField *out, double mass, void *qdp_fatlink[], void *qdp_longlink[],
+                              void **ghost_fatlink, void **ghost_longlink, QudaGaugeParam &gauge_param,
+                              QudaInvertParam &inv_param, int shift);
@@ -2,13 +2,18 @@
 #include <stdlib.h>
 #include <math.h>
 #include <string.h>
+#include <algorithm>
+#include <functional>
+#include <map>
 #include <type_traits>
+#include <vector>
 
 #include "quda.h"
 #include "gauge_field.h"
 #include "host_utils.h"
 #include "misc.h"
 #include "gauge_force_reference.h"
+#include "host_su3.h"
 
 extern int Z[4];
 extern int V;
@@ -16,36 +21,6 @@ extern int Vh;
 extern int Vh_ex;
 extern int E[4];
 
-#define CADD(a, b, c)                                                                                                  \
-  {                                                                                                                    \
-    (c).real = (a).real + (b).real;                                                                                    \
-    (c).imag = (a).imag + (b).imag;                                                                                    \
-  }
-#define CMUL(a, b, c)                                                                                                  \
-  {                                                                                                                    \
-    (c).real = (a).real * (b).real - (a).imag * (b).imag;                                                              \
-    (c).imag = (a).real * (b).imag + (a).imag * (b).real;                                                              \
-  }
-#define CSUM(a, b)                                                                                                     \
-  {                                                                                                                    \
-    (a).real += (b).real;                                                                                              \
-    (a).imag += (b).imag;                                                                                              \
-  }
-
-/* c = a* * b */
-#define CMULJ_(a, b, c)                                                                                                \
-  {                                                                                                                    \
-    (c).real = (a).real * (b).real + (a).imag * (b).imag;                                                              \
-    (c).imag = (a).real * (b).imag - (a).imag * (b).real;                                                              \
-  }
-
-/* c = a * b* */
-#define CMUL_J(a, b, c)                                                                                                \
-  {                                                                                                                    \
-    (c).real = (a).real * (b).real + (a).imag * (b).imag;                                                              \
-    (c).imag = (a).imag * (b).real - (a).real * (b).imag;                                                              \
-  }
-
 #define CONJG(a, b)                                                                                                    \
   {                                                                                                                    \
     (b).real = (a).real;                                                                                               \
@@ -160,49 +135,24 @@ static void scalar_mult_add_su3_matrix(su3_matrix *a, su3_matrix *b, Float s, su
   }
 }
 
+// The MILC-style structs above share the interleaved layout of the
+// host_su3.h primitives, so we can apply those to them directly
 template <typename su3_matrix> static void mult_su3_nn(su3_matrix *a, su3_matrix *b, su3_matrix *c)
 {
-  typename std::remove_reference<decltype(a->e[0][0])>::type x, y;
-  for (int i = 0; i < 3; i++) {
-    for (int j = 0; j < 3; j++) {
-      x.real = x.imag = 0.0;
-      for (int k = 0; k < 3; k++) {
-        CMUL(a->e[i][k], b->e[k][j], y);
-        CSUM(x, y);
-      }
-      c->e[i][j] = x;
-    }
-  }
+  using Float = decltype(c->e[0][0].real);
+  su3MatMat<false, false>((Float *)c, (Float *)a, (Float *)b);
 }
 
 template <typename su3_matrix> static void mult_su3_an(su3_matrix *a, su3_matrix *b, su3_matrix *c)
 {
-  typename std::remove_reference<decltype(a->e[0][0])>::type x, y;
-  for (int i = 0; i < 3; i++) {
-    for (int j = 0; j < 3; j++) {
-      x.real = x.imag = 0.0;
-      for (int k = 0; k < 3; k++) {
-        CMULJ_(a->e[k][i], b->e[k][j], y);
-        CSUM(x, y);
-      }
-      c->e[i][j] = x;
-    }
-  }
+  using Float = decltype(c->e[0][0].real);
+  su3MatMat<true, false>((Float *)c, (Float *)a, (Float *)b);
 }
 
 template <typename su3_matrix> static void mult_su3_na(su3_matrix *a, su3_matrix *b, su3_matrix *c)
 {
-  typename std::remove_reference<decltype(a->e[0][0])>::type x, y;
-  for (int i = 0; i < 3; i++) {
-    for (int j = 0; j < 3; j++) {
-      x.real = x.imag = 0.0;
-      for (int k = 0; k < 3; k++) {
-        CMUL_J(a->e[i][k], b->e[j][k], y);
-        CSUM(x, y);
-      }
-      c->e[i][j] = x;
-    }
-  }
+  using Float = decltype(c->e[0][0].real);
+  su3MatMat<false, true>((Float *)c, (Float *)a, (Float *)b);
 }
 
 template <typename su3_matrix> void print_su3_matrix(su3_matrix *a)
@@ -266,63 +216,141 @@ int gf_neighborIndexFullLattice(int i, int dx4, int dx3, int dx2, int dx1)
   return ret;
 }
 
-// this functon compute one path for all lattice sites
-template <typename su3_matrix, typename Float>
-static void compute_path_product(su3_matrix *staple, su3_matrix **sitelink, su3_matrix **sitelink_ex_2d, int *path,
-                                 int len, Float loop_coeff, int dir)
+/**
+   @brief Prefix trie of the loop paths of one direction.  The paths of
+   improved gauge actions share long common prefixes (every rectangle
+   starts like a plaquette staple), so rather than walking each path
+   from scratch we walk the trie once per site, extending the link
+   product of the parent node by one hop at each node.  Nodes are
+   stored in preorder, so the walk is a linear sweep over the nodes
+   with the running products kept on a stack indexed by depth.
+ */
+class PathTrie
 {
-  su3_matrix prev_matrix, curr_matrix, tmat;
-  int dx[4];
 
-  for (int i = 0; i < V; i++) {
-    memset(dx, 0, sizeof(dx));
-    memset(&curr_matrix, 0, sizeof(curr_matrix));
-
-    curr_matrix.e[0][0].real = 1.0;
-    curr_matrix.e[1][1].real = 1.0;
-    curr_matrix.e[2][2].real = 1.0;
-
-    dx[dir] = 1;
-    for (int j = 0; j < len; j++) {
-      int lnkdir;
-
-      prev_matrix = curr_matrix;
-      if (GOES_FORWARDS(path[j])) {
-        // dx[path[j]] +=1;
-        lnkdir = path[j];
-      } else {
-        dx[OPP_DIR(path[j])] -= 1;
-        lnkdir = OPP_DIR(path[j]);
+public:
+  struct Node {
+    int hop;                /** direction of the hop into this node (-1 for the root) */
+    int depth;              /** number of hops from the root */
+    std::vector<int> paths; /** paths that end at this node */
+  };
+
+private:
+  std::vector<Node> nodes;
+  int max_depth;
+
+public:
+  PathTrie(int **path, const int *length, int num_paths) : max_depth(0)
+  {
+    struct Branch {
+      std::map<int, int> child;
+      std::vector<int> paths;
+    };
+    std::vector<Branch> tree(1);
+
+    for (int p = 0; p < num_paths; p++) {
+      int n = 0;
+      for (int j = 0; j < length[p]; j++) {
+        auto it = tree[n].child.find(path[p][j]);
+        if (it != tree[n].child.end()) {
+          n = it->second;
+        } else {
+          tree[n].child[path[p][j]] = tree.size();
+          n = tree.size();
+          tree.emplace_back();
+        }
       }
+      tree[n].paths.push_back(p);
+    }
+
+    std::function<void(int, int, int)> flatten = [&](int n, int hop, int depth) {
+      nodes.push_back({hop, depth, tree[n].paths});
+      max_depth = std::max(max_depth, depth);
+      for (auto &c : tree[n].child) flatten(c.second, c.first, depth + 1);
+    };
+    flatten(0, -1, 0);
+  }
 
-      int nbr_idx = gf_neighborIndexFullLattice(i, dx[3], dx[2], dx[1], dx[0]);
+  const std::vector<Node> &Nodes() const { return nodes; }
+
+  int MaxDepth() const { return max_depth; }
+
+  /**
+     @brief Number of link multiplications per site, which without
+     the trie would be the total length of all paths
+   */
+  int Products() const { return nodes.size() - 1; }
+};
+
+// this functon computes the sum of all the paths of one direction for all lattice sites
+template <typename su3_matrix, typename Float>
+static void compute_path_product(su3_matrix *staple, su3_matrix **sitelink, su3_matrix **sitelink_ex_2d,
+                                 const PathTrie &trie, const Float *loop_coeff, int num_paths, int dir)
+{
+  // We walk each path one hop at a time.  In the multi-GPU case the
+  // walk happens on the extended lattice, whose halo is deep enough
+  // that no path ever wraps around it.
 #ifdef MULTI_GPU
-      su3_matrix *lnk = sitelink_ex_2d[lnkdir] + nbr_idx;
+  su3_matrix **link = sitelink_ex_2d;
+  FullLatticeNeighborTable neighbor(E);
 #else
-      su3_matrix *lnk = sitelink[lnkdir] + nbr_idx;
+  su3_matrix **link = sitelink;
+  FullLatticeNeighborTable neighbor(Z);
 #endif
-      if (GOES_FORWARDS(path[j])) {
-        mult_su3_nn(&prev_matrix, lnk, &curr_matrix);
-      } else {
-        mult_su3_na(&prev_matrix, lnk, &curr_matrix);
-      }
 
-      if (GOES_FORWARDS(path[j])) {
-        dx[path[j]] += 1;
-      } else {
-        // we already substract one in the code above
-      }
+  const std::vector<PathTrie::Node> &nodes = trie.Nodes();
 
-    } // j
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+  {
+    std::vector<su3_matrix> product(trie.MaxDepth() + 1);
+    std::vector<int> nbr_idx(trie.MaxDepth() + 1);
+    std::vector<su3_matrix> path_product(num_paths);
 
-    su3_adjoint(&curr_matrix, &tmat);
-    scalar_mult_add_su3_matrix(staple + i, &tmat, loop_coeff, staple + i);
-  } // i
+#ifdef _OPENMP
+#pragma omp for
+#endif
+    for (int i = 0; i < V; i++) {
+      memset(&product[0], 0, sizeof(su3_matrix));
+
+      product[0].e[0][0].real = 1.0;
+      product[0].e[1][1].real = 1.0;
+      product[0].e[2][2].real = 1.0;
+
+      // the path starts from the site x + dir
+      nbr_idx[0] = neighbor(gf_neighborIndexFullLattice(i, 0, 0, 0, 0), 2 * dir);
+
+      for (const auto &node : nodes) {
+        const int d = node.depth;
+        if (d > 0) {
+          if (GOES_FORWARDS(node.hop)) {
+            mult_su3_nn(&product[d - 1], link[node.hop] + nbr_idx[d - 1], &product[d]);
+            nbr_idx[d] = neighbor(nbr_idx[d - 1], 2 * node.hop);
+          } else {
+            nbr_idx[d] = neighbor(nbr_idx[d - 1], 2 * OPP_DIR(node.hop) + 1);
+            mult_su3_na(&product[d - 1], link[OPP_DIR(node.hop)] + nbr_idx[d], &product[d]);
+          }
+        }
+        for (int p : node.paths) path_product[p] = product[d];
+      }
+
+      // accumulate in the order the paths were given, independent of the trie layout
+      for (int p = 0; p < num_paths; p++) {
+        su3_matrix tmat;
+        su3_adjoint(&path_product[p], &tmat);
+        scalar_mult_add_su3_matrix(staple + i, &tmat, loop_coeff[p], staple + i);
+      }
+    } // i
+  }
 }
 
 template <typename su3_matrix, typename anti_hermitmat, typename Float>
 static void update_mom(anti_hermitmat *momentum, int dir, su3_matrix **sitelink, su3_matrix *staple, Float eb3)
 {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
   for (int i = 0; i < V; i++) {
     su3_matrix tmat1;
     su3_matrix tmat2;
@@ -357,16 +385,20 @@ void gauge_force_reference_dir(void *refMom, int dir, double eb3, void **sitelin
 
   memset(staple, 0, V * gauge_site_size * gSize);
 
-  for (int i = 0; i < num_paths; i++) {
-    if (prec == QUDA_DOUBLE_PRECISION) {
-      double *my_loop_coeff = (double *)loop_coeff;
-      compute_path_product((dsu3_matrix *)staple, (dsu3_matrix **)sitelink, (dsu3_matrix **)sitelink_ex_2d, path_dir[i],
-                           length[i], my_loop_coeff[i], dir);
-    } else {
-      float *my_loop_coeff = (float *)loop_coeff;
-      compute_path_product((fsu3_matrix *)staple, (fsu3_matrix **)sitelink, (fsu3_matrix **)sitelink_ex_2d, path_dir[i],
-                           length[i], my_loop_coeff[i], dir);
-    }
+  PathTrie trie(path_dir, length, num_paths);
+  if (getVerbosity() >= QUDA_DEBUG_VERBOSE) {
+    int total_length = 0;
+    for (int i = 0; i < num_paths; i++) total_length += length[i];
+    printfQuda("Gauge force dir %d: %d paths of total length %d need %d link products per site\n", dir, num_paths,
+               total_length, trie.Products());
+  }
+
+  if (prec == QUDA_DOUBLE_PRECISION) {
+    compute_path_product((dsu3_matrix *)staple, (dsu3_matrix **)sitelink, (dsu3_matrix **)sitelink_ex_2d, trie,
+                         (double *)loop_coeff, num_paths, dir);
+  } else {
+    compute_path_product((fsu3_matrix *)staple, (fsu3_matrix **)sitelink, (fsu3_matrix **)sitelink_ex_2d, trie,
+                         (float *)loop_coeff, num_paths, dir);
   }
 
   if (prec == QUDA_DOUBLE_PRECISION) {
@@ -8,26 +8,13 @@
 #include <host_utils.h>
 #include <misc.h>
 #include <hisq_force_reference.h>
+#include <host_su3.h>
 
 extern int Z[4];
 extern int V;
 extern int Vh;
 
 
-#define CADD(a,b,c) { (c).real = (a).real + (b).real;	\
-	(c).imag = (a).imag + (b).imag; }
-#define CMUL(a,b,c) { (c).real = (a).real*(b).real - (a).imag*(b).imag; \
-		      (c).imag = (a).real*(b).imag + (a).imag*(b).real; }
-#define CSUM(a,b) { (a).real += (b).real; (a).imag += (b).imag; }
-
-/* c = a* * b */
-#define CMULJ_(a,b,c) { (c).real = (a).real*(b).real + (a).imag*(b).imag; \
-		        (c).imag = (a).real*(b).imag - (a).imag*(b).real; }
-
-/* c = a * b* */
-#define CMUL_J(a,b,c) { (c).real = (a).real*(b).real + (a).imag*(b).imag; \
-	  	        (c).imag = (a).imag*(b).real - (a).real*(b).imag; }
-
 #define CONJG(a,b) { (b).real = (a).real; (b).imag = -(a).imag; }
 
 typedef struct {   
@@ -183,46 +170,26 @@ scale_su3_matrix(su3_matrix *a,  Float s)
   }    
 }
 
-template<typename su3_matrix, typename su3_vector>
-static void
-mult_su3_mat_vec( su3_matrix *a, su3_vector *b, su3_vector *c  )
+// The MILC-style structs above share the interleaved layout of the
+// host_su3.h primitives, so we can apply those to them directly
+template <typename su3_matrix, typename su3_vector>
+static void mult_su3_mat_vec(su3_matrix *a, su3_vector *b, su3_vector *c)
 {
-    int i,j;
-    typename std::remove_reference<decltype(a->e[0][0])>::type x,y;
-    for(i=0;i<3;i++){
-	x.real=x.imag=0.0;
-	for(j=0;j<3;j++){
-	    CMUL( a->e[i][j] , b->c[j] , y );
-	    CSUM( x , y );
-	}
-	c->c[i]=x;
-    }
+  using Float = decltype(a->e[0][0].real);
+  su3MatVec((Float *)c, (Float *)a, (Float *)b);
 }
-template<typename su3_matrix, typename su3_vector>
-static void
-mult_adj_su3_mat_vec( su3_matrix *a, su3_vector *b, su3_vector *c )
+
+template <typename su3_matrix, typename su3_vector>
+static void mult_adj_su3_mat_vec(su3_matrix *a, su3_vector *b, su3_vector *c)
 {
-    int i,j;
-    typename std::remove_reference<decltype(a->e[0][0])>::type x,y,z;
-    for(i=0;i<3;i++){
-	x.real=x.imag=0.0;
-	for(j=0;j<3;j++){
-	    CONJG( a->e[j][i], z );
-	    CMUL( z , b->c[j], y );
-	    CSUM( x , y );
-	}
-	c->c[i] = x;
-    }
+  using Float = decltype(a->e[0][0].real);
+  su3AdjMatVec((Float *)c, (Float *)a, (Float *)b);
 }
 
-template<typename su3_vector, typename su3_matrix>
-static void
-su3_projector( su3_vector *a, su3_vector *b, su3_matrix *c )
+template <typename su3_vector, typename su3_matrix> static void su3_projector(su3_vector *a, su3_vector *b, su3_matrix *c)
 {
-    int i,j;
-    for(i=0;i<3;i++)for(j=0;j<3;j++){
-	    CMUL_J( a->c[i], b->c[j], c->e[i][j] );
-	}
+  using Float = decltype(c->e[0][0].real);
+  su3OuterProduct((Float *)c, (Float *)a, (Float *)b);
 }
 
 template<typename su3_vector, typename Real>
@@ -255,73 +222,32 @@ print_su3_matrix(su3_matrix *a)
 
 
 
-// Add a matrix multiplication function
-template<typename su3_matrix>
-static void
-matrix_mult_nn(su3_matrix* a, su3_matrix* b, su3_matrix* c){
-  // c = a*b
-  typename std::remove_reference<decltype(c->e[0][0])>::type x;
-  for(int i=0; i<3; i++){
-    for(int j=0; j<3; j++){	
-      c->e[i][j].real = 0.;
-      c->e[i][j].imag = 0.;
-      for(int k=0; k<3; k++){	
-	CMUL(a->e[i][k],b->e[k][j],x);
-	c->e[i][j].real += x.real;
-	c->e[i][j].imag += x.imag;
-      } 	
-    }	
-  }
-  return;
+// c = a*b
+template <typename su3_matrix> static void matrix_mult_nn(su3_matrix *a, su3_matrix *b, su3_matrix *c)
+{
+  using Float = decltype(c->e[0][0].real);
+  su3MatMat<false, false>((Float *)c, (Float *)a, (Float *)b);
 }
 
-
-template<typename su3_matrix>
-static void
-matrix_mult_an(su3_matrix* a, su3_matrix* b, su3_matrix* c){
-  // c = (a^{\dagger})*b
-  typename std::remove_reference<decltype(c->e[0][0])>::type x;
-  for(int i=0; i<3; i++){
-    for(int j=0; j<3; j++){	
-      c->e[i][j].real = 0.;
-      c->e[i][j].imag = 0.;
-      for(int k=0; k<3; k++){	
-	CMULJ_(a->e[k][i],b->e[k][j],x);
-	c->e[i][j].real += x.real;
-	c->e[i][j].imag += x.imag;
-      } 	
-    }	
-  }
-  return;
+// c = (a^{\dagger})*b
+template <typename su3_matrix> static void matrix_mult_an(su3_matrix *a, su3_matrix *b, su3_matrix *c)
+{
+  using Float = decltype(c->e[0][0].real);
+  su3MatMat<true, false>((Float *)c, (Float *)a, (Float *)b);
 }
 
-
-
-template<typename su3_matrix>
-static void
-matrix_mult_na(su3_matrix* a, su3_matrix* b, su3_matrix* c){
-  // c = a*b^{\dagger}
-  typename std::remove_reference<decltype(c->e[0][0])>::type x;
-  for(int i=0; i<3; i++){
-    for(int j=0; j<3; j++){
-      c->e[i][j].real = 0.; c->e[i][j].imag = 0.;
-      for(int k=0; k<3; k++){
-        CMUL_J(a->e[i][k],b->e[j][k],x);
-	c->e[i][j].real += x.real;
-	c->e[i][j].imag += x.imag;
-      }
-    }
-  }
-  return;
+// c = a*b^{\dagger}
+template <typename su3_matrix> static void matrix_mult_na(su3_matrix *a, su3_matrix *b, su3_matrix *c)
+{
+  using Float = decltype(c->e[0][0].real);
+  su3MatMat<false, true>((Float *)c, (Float *)a, (Float *)b);
 }
 
-template<typename su3_matrix>
-static void
-matrix_mult_aa(su3_matrix* a, su3_matrix* b, su3_matrix* c){
-  
-  su3_matrix a_adjoint;
-  su3_adjoint(a, &a_adjoint);
-  matrix_mult_na(&a_adjoint, b, c);
+// c = a^{\dagger}*b^{\dagger}
+template <typename su3_matrix> static void matrix_mult_aa(su3_matrix *a, su3_matrix *b, su3_matrix *c)
+{
+  using Float = decltype(c->e[0][0].real);
+  su3MatMat<true, true>((Float *)c, (Float *)a, (Float *)b);
 }
 
 template <typename su3_matrix, typename anti_hermitmat, typename Float>
@@ -350,28 +276,27 @@ update_mom(anti_hermitmat* momentum, int dir, su3_matrix* sitelink,
 }
 
 
+// Neighbor-table hop direction (0/1 = +/-X, ..., 6/7 = +/-T) of the
+// MILC-style direction dir
+static inline int hop_dir(int dir) { return GOES_FORWARDS(dir) ? 2 * dir : 2 * OPP_DIR(dir) + 1; }
+
 template<typename half_wilson_vector, typename su3_matrix>
 static void 
 u_shift_hw(half_wilson_vector *src, half_wilson_vector *dest, int dir, su3_matrix* sitelink ) 
 {
-    int i ;
-    int dx[4];
-    
-    dx[3]=dx[2]=dx[1]=dx[0]=0;
-    
+    FullLatticeNeighborTable neighbor(Z);
+
     if(GOES_FORWARDS(dir)){	
-	dx[dir]=1;	
-	for(i=0;i < V; i++){
-	    int nbr_idx = neighborIndexFullLattice(i, dx[3], dx[2], dx[1], dx[0]);
+	for(int i=0;i < V; i++){
+	    int nbr_idx = neighbor(i, hop_dir(dir));
 	    half_wilson_vector* hw = src + nbr_idx;
 	    su3_matrix* link = sitelink + i*4 + dir;
 	    mult_su3_mat_vec(link, &hw->h[0], &dest[i].h[0]);
 	    mult_su3_mat_vec(link, &hw->h[1], &dest[i].h[1]);	    
 	}	
     }else{
-	dx[OPP_DIR(dir)]=-1;
-	for(i=0;i < V; i++){
-	    int nbr_idx = neighborIndexFullLattice(i, dx[3], dx[2], dx[1], dx[0]);
+	for(int i=0;i < V; i++){
+	    int nbr_idx = neighbor(i, hop_dir(dir));
 	    half_wilson_vector* hw = src + nbr_idx;
 	    su3_matrix* link = sitelink + nbr_idx*4 + OPP_DIR(dir);
 	    mult_adj_su3_mat_vec(link, &hw->h[0], &dest[i].h[0]);
@@ -386,18 +311,10 @@ template<typename half_wilson_vector, typename su3_matrix>
 static void 
 shifted_outer_prod(half_wilson_vector *src, su3_matrix* dest, int dir)
 {
-    
-    int i;
-    int dx[4];
-    
-    dx[3]=dx[2]=dx[1]=dx[0]=0;
-    
-    if(GOES_FORWARDS(dir)){	
-	dx[dir]=1;	
-    }else{ dx[OPP_DIR(dir)]=-1; }
+    FullLatticeNeighborTable neighbor(Z);
 
-    for(i=0;i < V; i++){
-      int nbr_idx = neighborIndexFullLattice(i, dx[3], dx[2], dx[1], dx[0]);
+    for(int i=0;i < V; i++){
+      int nbr_idx = neighbor(i, hop_dir(dir));
       half_wilson_vector* hw = src + nbr_idx;
       su3_projector( &src[i].h[0], &(hw->h[0]), &dest[i]);
     }	
@@ -408,18 +325,10 @@ template<typename half_wilson_vector, typename su3_matrix>
 static void 
 forward_shifted_outer_prod(half_wilson_vector *src, su3_matrix* dest, int dir)
 {
+  FullLatticeNeighborTable neighbor(Z);
 
-  int i;
-  int dx[4];
-    
-  dx[3]=dx[2]=dx[1]=dx[0]=0;
-    
-  if(GOES_FORWARDS(dir)){	
-    dx[dir]=1;	
-  }else{ dx[OPP_DIR(dir)]=-1; }
-
-  for(i=0;i < V; i++){
-    int nbr_idx = neighborIndexFullLattice(i, dx[3], dx[2], dx[1], dx[0]);
+  for(int i=0;i < V; i++){
+    int nbr_idx = neighbor(i, hop_dir(dir));
     half_wilson_vector* hw = src + nbr_idx;
     //su3_projector( &src[i].h[0], &(hw->h[0]), &dest[i]);
     su3_projector( &(hw->h[0]), &src[i].h[0], &dest[i]);
@@ -436,12 +345,10 @@ template <typename half_wilson_vector, typename su3_matrix>
 static void
 computeLinkOrderedOuterProduct(half_wilson_vector *src, su3_matrix* dest, int gauge_order)
 {
-  int dx[4];
+  FullLatticeNeighborTable neighbor(Z);
   for(int i=0; i<V; ++i){
     for(int dir=0; dir<4; ++dir){
-      dx[3]=dx[2]=dx[1]=dx[0]=0;
-      dx[dir] = 1;
-      int nbr_idx = neighborIndexFullLattice(i, dx[3], dx[2], dx[1], dx[0]);
+      int nbr_idx = neighbor(i, 2*dir);
       half_wilson_vector* hw = src + nbr_idx;
       su3_matrix* p = get_su3_matrix(gauge_order, dest, i, dir);
       su3_projector( &(hw->h[0]), &src[i].h[0], p);
@@ -455,12 +362,10 @@ template <typename half_wilson_vector, typename su3_matrix>
 static void
 computeLinkOrderedOuterProduct(half_wilson_vector *src, su3_matrix* dest, size_t nhops, int gauge_order)
 {
-  int dx[4];
+  FullLatticeNeighborTable neighbor(Z, nhops);
   for(int i=0; i<V; ++i){
     for(int dir=0; dir<4; ++dir){
-      dx[3]=dx[2]=dx[1]=dx[0]=0;
-      dx[dir] = nhops;
-      int nbr_idx = neighborIndexFullLattice(i, dx[3], dx[2], dx[1], dx[0]);
+      int nbr_idx = neighbor(i, 2*dir);
       half_wilson_vector* hw = src + nbr_idx;
       su3_matrix* p = get_su3_matrix(gauge_order, dest, i, dir);
       su3_projector( &(hw->h[0]), &src[i].h[0], p);
@@ -526,22 +431,18 @@ template<typename su3_matrix>
 static void 
 u_shift_mat(su3_matrix *src, su3_matrix *dest, int dir, su3_matrix* sitelink)
 {
-  int i;
-  int dx[4];
-  dx[3]=dx[2]=dx[1]=dx[0]=0;
+  FullLatticeNeighborTable neighbor(Z);
 
   if(GOES_FORWARDS(dir)){
-    dx[dir]=1;
-    for(i=0; i<V; i++){
-      int nbr_idx = neighborIndexFullLattice(i, dx[3], dx[2], dx[1], dx[0]);
+    for(int i=0; i<V; i++){
+      int nbr_idx = neighbor(i, hop_dir(dir));
       su3_matrix* mat = src+nbr_idx; // No need for a factor of 4 here, the colour matrices do not have a Lorentz index
       su3_matrix* link = sitelink + i*4 + dir;
       matrix_mult_nn(link, mat, &dest[i]);	
     }	
   }else{
-    dx[OPP_DIR(dir)]=-1;
-    for(i=0; i<V; i++){
-      int nbr_idx = neighborIndexFullLattice(i, dx[3], dx[2], dx[1], dx[0]);
+    for(int i=0; i<V; i++){
+      int nbr_idx = neighbor(i, hop_dir(dir));
       su3_matrix* mat = src+nbr_idx; // No need for a factor of 4 here, the colour matrices do not have a Lorentz index
       su3_matrix* link = sitelink + nbr_idx*4 + OPP_DIR(dir);
       matrix_mult_an(link, mat, &dest[i]);
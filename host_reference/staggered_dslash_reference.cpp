@@ -34,20 +34,25 @@ template <typename Float> void display_link_internal(Float *link)
 // if oddBit is one:  calculate odd parity spinor elements
 // if daggerBit is zero: perform ordinary dslash operator
 // if daggerBit is one:  perform hermitian conjugate of dslash
+//
+// The nSrc right-hand sides are stored consecutively as the fifth
+// dimension.  Sites are distributed over threads, and for each site
+// and direction the fat and long links are resolved once and then
+// applied to every right-hand side, so the links are only streamed
+// from memory once regardless of the number of sources.  Each output
+// site accumulates its hops in a fixed order, so the result does not
+// depend on the number of threads or sources.
 template <typename sFloat, typename gFloat>
 void staggeredDslashReference(sFloat *res, gFloat **fatlink, gFloat **longlink, gFloat **ghostFatlink,
                               gFloat **ghostLonglink, sFloat *spinorField, sFloat **fwd_nbr_spinor,
                               sFloat **back_nbr_spinor, int oddBit, int daggerBit, int nSrc, QudaDslashType dslash_type)
 {
-  for (int i = 0; i < Vh * my_spinor_site_size * nSrc; i++) res[i] = 0.0;
-
   gFloat *fatlinkEven[4], *fatlinkOdd[4];
   gFloat *longlinkEven[4], *longlinkOdd[4];
-
-#ifdef MULTI_GPU
-  gFloat *ghostFatlinkEven[4], *ghostFatlinkOdd[4];
-  gFloat *ghostLonglinkEven[4], *ghostLonglinkOdd[4];
-#endif
+  gFloat *ghostFatlinkEven[4] = {nullptr, nullptr, nullptr, nullptr};
+  gFloat *ghostFatlinkOdd[4] = {nullptr, nullptr, nullptr, nullptr};
+  gFloat *ghostLonglinkEven[4] = {nullptr, nullptr, nullptr, nullptr};
+  gFloat *ghostLonglinkOdd[4] = {nullptr, nullptr, nullptr, nullptr};
 
   for (int dir = 0; dir < 4; dir++) {
     fatlinkEven[dir] = fatlink[dir];
@@ -63,64 +68,90 @@ void staggeredDslashReference(sFloat *res, gFloat **fatlink, gFloat **longlink,
 #endif
   }
 
-  for (int xs = 0; xs < nSrc; xs++) {
-
-    for (int i = 0; i < Vh; i++) {
-      int sid = i + xs * Vh;
-      int offset = my_spinor_site_size * sid;
+  // backwards links and ghost links live on the other parity
+  gFloat **fatlinkThis = oddBit ? fatlinkOdd : fatlinkEven;
+  gFloat **fatlinkOther = oddBit ? fatlinkEven : fatlinkOdd;
+  gFloat **ghostFatlinkOther = oddBit ? ghostFatlinkEven : ghostFatlinkOdd;
+  gFloat **longlinkThis = oddBit ? longlinkOdd : longlinkEven;
+  gFloat **longlinkOther = oddBit ? longlinkEven : longlinkOdd;
+  gFloat **ghostLonglinkOther = oddBit ? ghostLonglinkEven : ghostLonglinkOdd;
+
+  const bool improved = dslash_type == QUDA_ASQTAD_DSLASH;
+  const int nFace = improved ? 3 : 1;
+  const NeighborTable &first_neighbor = getNeighborTable(Z, oddBit, 1);
+  const NeighborTable *third_neighbor = improved ? &getNeighborTable(Z, oddBit, 3) : nullptr;
+
+  // Return the link for a hop of the table's distance, where the
+  // ghost links hold nLinkFace faces
+  auto link = [&](const NeighborTable &neighbor, gFloat **linkThis, gFloat **linkOther, gFloat **ghostLinkOther,
+                  int nLinkFace, int i, int dir) -> gFloat * {
+    const NeighborTable::Neighbor &nbr = neighbor.neighbor(i, dir);
+    if (dir % 2 == 0)
+      return &linkThis[dir / 2][i * gauge_site_size];
+    else if (nbr.depth >= 0)
+      return &ghostLinkOther[dir / 2][neighbor.ghostOffset(nbr, dir, nLinkFace) * gauge_site_size];
+    else
+      return &linkOther[dir / 2][nbr.idx * gauge_site_size];
+  };
+
+  // Return the neighboring spinor of right-hand side xs, where the
+  // ghost spinor holds nFace faces of nSrc slices
+  auto spinor = [&](const NeighborTable &neighbor, int i, int xs, int dir) -> sFloat * {
+    const NeighborTable::Neighbor &nbr = neighbor.neighbor(i, dir);
+    if (nbr.depth >= 0) {
+      sFloat **ghostSpinor = dir % 2 == 0 ? fwd_nbr_spinor : back_nbr_spinor;
+      return &ghostSpinor[dir / 2][neighbor.ghostOffset(nbr, dir, nFace, nSrc, xs) * my_spinor_site_size];
+    } else {
+      return &spinorField[(nbr.idx + xs * Vh) * my_spinor_site_size];
+    }
+  };
 
-      for (int dir = 0; dir < 8; dir++) {
-#ifdef MULTI_GPU
-        const int nFace = dslash_type == QUDA_ASQTAD_DSLASH ? 3 : 1;
-        gFloat *fatlnk
-          = gaugeLink_mg4dir(i, dir, oddBit, fatlinkEven, fatlinkOdd, ghostFatlinkEven, ghostFatlinkOdd, 1, 1);
-        gFloat *longlnk = dslash_type == QUDA_ASQTAD_DSLASH ?
-          gaugeLink_mg4dir(i, dir, oddBit, longlinkEven, longlinkOdd, ghostLonglinkEven, ghostLonglinkOdd, 3, 3) :
-          nullptr;
-        sFloat *first_neighbor_spinor = spinorNeighbor_5d_mgpu<QUDA_4D_PC>(
-          sid, dir, oddBit, spinorField, fwd_nbr_spinor, back_nbr_spinor, 1, nFace, my_spinor_site_size);
-        sFloat *third_neighbor_spinor = dslash_type == QUDA_ASQTAD_DSLASH ?
-          spinorNeighbor_5d_mgpu<QUDA_4D_PC>(sid, dir, oddBit, spinorField, fwd_nbr_spinor, back_nbr_spinor, 3, nFace,
-                                             my_spinor_site_size) :
-          nullptr;
-#else
-        gFloat *fatlnk = gaugeLink(i, dir, oddBit, fatlinkEven, fatlinkOdd, 1);
-        gFloat *longlnk
-          = dslash_type == QUDA_ASQTAD_DSLASH ? gaugeLink(i, dir, oddBit, longlinkEven, longlinkOdd, 3) : nullptr;
-        sFloat *first_neighbor_spinor
-          = spinorNeighbor_5d<QUDA_4D_PC>(sid, dir, oddBit, spinorField, 1, my_spinor_site_size);
-        sFloat *third_neighbor_spinor = dslash_type == QUDA_ASQTAD_DSLASH ?
-          spinorNeighbor_5d<QUDA_4D_PC>(sid, dir, oddBit, spinorField, 3, my_spinor_site_size) :
-          nullptr;
+#ifdef _OPENMP
+#pragma omp parallel for
 #endif
+  for (int i = 0; i < Vh; i++) {
+    for (int xs = 0; xs < nSrc; xs++)
+      for (int j = 0; j < my_spinor_site_size; j++) res[(i + xs * Vh) * my_spinor_site_size + j] = 0.0;
+
+    for (int dir = 0; dir < 8; dir++) {
+      gFloat *fatlnk = link(first_neighbor, fatlinkThis, fatlinkOther, ghostFatlinkOther, 1, i, dir);
+      gFloat *longlnk
+        = improved ? link(*third_neighbor, longlinkThis, longlinkOther, ghostLonglinkOther, 3, i, dir) : nullptr;
+
+      for (int xs = 0; xs < nSrc; xs++) {
+        int offset = my_spinor_site_size * (i + xs * Vh);
+        sFloat *first_neighbor_spinor = spinor(first_neighbor, i, xs, dir);
+        sFloat *third_neighbor_spinor = improved ? spinor(*third_neighbor, i, xs, dir) : nullptr;
+
         sFloat gaugedSpinor[my_spinor_site_size];
 
         if (dir % 2 == 0) {
-          su3Mul(gaugedSpinor, fatlnk, first_neighbor_spinor);
+          su3MatVec(gaugedSpinor, fatlnk, first_neighbor_spinor);
           sum(&res[offset], &res[offset], gaugedSpinor, my_spinor_site_size);
 
-          if (dslash_type == QUDA_ASQTAD_DSLASH) {
-            su3Mul(gaugedSpinor, longlnk, third_neighbor_spinor);
+          if (improved) {
+            su3MatVec(gaugedSpinor, longlnk, third_neighbor_spinor);
             sum(&res[offset], &res[offset], gaugedSpinor, my_spinor_site_size);
           }
         } else {
-          su3Tmul(gaugedSpinor, fatlnk, first_neighbor_spinor);
+          su3AdjMatVec(gaugedSpinor, fatlnk, first_neighbor_spinor);
           if (dslash_type == QUDA_LAPLACE_DSLASH) {
             sum(&res[offset], &res[offset], gaugedSpinor, my_spinor_site_size);
           } else {
             sub(&res[offset], &res[offset], gaugedSpinor, my_spinor_site_size);
           }
 
-          if (dslash_type == QUDA_ASQTAD_DSLASH) {
-            su3Tmul(gaugedSpinor, longlnk, third_neighbor_spinor);
+          if (improved) {
+            su3AdjMatVec(gaugedSpinor, longlnk, third_neighbor_spinor);
             sub(&res[offset], &res[offset], gaugedSpinor, my_spinor_site_size);
           }
         }
-      }
+      } // right-hand-side
+    }
 
-      if (daggerBit) negx(&res[offset], my_spinor_site_size);
-    } // 4-d volume
-  }   // right-hand-side
+    if (daggerBit)
+      for (int xs = 0; xs < nSrc; xs++) negx(&res[(i + xs * Vh) * my_spinor_site_size], my_spinor_site_size);
+  } // 4-d volume
 }
 
 void staggeredDslash(ColorSpinorField *out, void **fatlink, void **longlink, void **ghost_fatlink,
@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <vector>
 
 #include <util_quda.h>
 
@@ -15,79 +16,6 @@
 
 using namespace quda;
 
-static const double projector[8][4][4][2] = {
-  {
-    {{1,0}, {0,0}, {0,0}, {0,-1}},
-    {{0,0}, {1,0}, {0,-1}, {0,0}},
-    {{0,0}, {0,1}, {1,0}, {0,0}},
-    {{0,1}, {0,0}, {0,0}, {1,0}}
-  },
-  {
-    {{1,0}, {0,0}, {0,0}, {0,1}},
-    {{0,0}, {1,0}, {0,1}, {0,0}},
-    {{0,0}, {0,-1}, {1,0}, {0,0}},
-    {{0,-1}, {0,0}, {0,0}, {1,0}}
-  },
-  {
-    {{1,0}, {0,0}, {0,0}, {1,0}},
-    {{0,0}, {1,0}, {-1,0}, {0,0}},
-    {{0,0}, {-1,0}, {1,0}, {0,0}},
-    {{1,0}, {0,0}, {0,0}, {1,0}}
-  },
-  {
-    {{1,0}, {0,0}, {0,0}, {-1,0}},
-    {{0,0}, {1,0}, {1,0}, {0,0}},
-    {{0,0}, {1,0}, {1,0}, {0,0}},
-    {{-1,0}, {0,0}, {0,0}, {1,0}}
-  },
-  {
-    {{1,0}, {0,0}, {0,-1}, {0,0}},
-    {{0,0}, {1,0}, {0,0}, {0,1}},
-    {{0,1}, {0,0}, {1,0}, {0,0}},
-    {{0,0}, {0,-1}, {0,0}, {1,0}}
-  },
-  {
-    {{1,0}, {0,0}, {0,1}, {0,0}},
-    {{0,0}, {1,0}, {0,0}, {0,-1}},
-    {{0,-1}, {0,0}, {1,0}, {0,0}},
-    {{0,0}, {0,1}, {0,0}, {1,0}}
-  },
-  {
-    {{1,0}, {0,0}, {-1,0}, {0,0}},
-    {{0,0}, {1,0}, {0,0}, {-1,0}},
-    {{-1,0}, {0,0}, {1,0}, {0,0}},
-    {{0,0}, {-1,0}, {0,0}, {1,0}}
-  },
-  {
-    {{1,0}, {0,0}, {1,0}, {0,0}},
-    {{0,0}, {1,0}, {0,0}, {1,0}},
-    {{1,0}, {0,0}, {1,0}, {0,0}},
-    {{0,0}, {1,0}, {0,0}, {1,0}}
-  }
-};
-
-
-// todo pass projector
-template <typename Float>
-void multiplySpinorByDiracProjector(Float *res, int projIdx, Float *spinorIn) {
-  for (int i=0; i<4*3*2; i++) res[i] = 0.0;
-
-  for (int s = 0; s < 4; s++) {
-    for (int t = 0; t < 4; t++) {
-      Float projRe = projector[projIdx][s][t][0];
-      Float projIm = projector[projIdx][s][t][1];
-      
-      for (int m = 0; m < 3; m++) {
-	Float spinorRe = spinorIn[t*(3*2) + m*(2) + 0];
-	Float spinorIm = spinorIn[t*(3*2) + m*(2) + 1];
-	res[s*(3*2) + m*(2) + 0] += projRe*spinorRe - projIm*spinorIm;
-	res[s*(3*2) + m*(2) + 1] += projRe*spinorIm + projIm*spinorRe;
-      }
-    }
-  }
-}
-
-
 //
 // dslashReference()
 //
@@ -97,87 +25,93 @@ void multiplySpinorByDiracProjector(Float *res, int projIdx, Float *spinorIn) {
 // if daggerBit is zero: perform ordinary dslash operator
 // if daggerBit is one:  perform hermitian conjugate of dslash
 //
-
-#ifndef MULTI_GPU
+// The operator is applied to nSrc spinors at once: each link is
+// loaded once per site and direction and then applied to every
+// source, so the gauge field is only streamed from memory once
+// regardless of the number of sources.  The ghost spinors of source s
+// in dimension d are at fwdSpinor[s * 4 + d] and backSpinor[s * 4 + d].
+//
+// The ghost arguments are only dereferenced for partitioned
+// dimensions, so they may be null in a single-GPU build.  Sites are
+// processed independently and each accumulates its eight directions
+// in a fixed order, so the result does not depend on the number of
+// threads or sources.
+//
 
 template <typename sFloat, typename gFloat>
-void dslashReference(sFloat *res, gFloat **gaugeFull, sFloat *spinorField, int oddBit, int daggerBit) {
-  for (int i = 0; i < Vh * my_spinor_site_size; i++) res[i] = 0.0;
+void dslashReference(sFloat **res, gFloat **gaugeFull, gFloat **ghostGauge, sFloat **spinorField, sFloat **fwdSpinor,
+                     sFloat **backSpinor, int nSrc, int oddBit, int daggerBit)
+{
+  const NeighborTable &neighbor = getNeighborTable(Z, oddBit);
 
   gFloat *gaugeEven[4], *gaugeOdd[4];
-  for (int dir = 0; dir < 4; dir++) {  
+  gFloat *ghostGaugeEven[4] = {nullptr, nullptr, nullptr, nullptr};
+  gFloat *ghostGaugeOdd[4] = {nullptr, nullptr, nullptr, nullptr};
+  for (int dir = 0; dir < 4; dir++) {
     gaugeEven[dir] = gaugeFull[dir];
     gaugeOdd[dir] = gaugeFull[dir] + Vh * gauge_site_size;
-  }
-  
-  for (int i = 0; i < Vh; i++) {
-    for (int dir = 0; dir < 8; dir++) {
-      gFloat *gauge = gaugeLink(i, dir, oddBit, gaugeEven, gaugeOdd, 1);
-      sFloat *spinor = spinorNeighbor(i, dir, oddBit, spinorField, 1);
-      
-      sFloat projectedSpinor[4*3*2], gaugedSpinor[4*3*2];
-      int projIdx = 2*(dir/2)+(dir+daggerBit)%2;
-      multiplySpinorByDiracProjector(projectedSpinor, projIdx, spinor);
-      
-      for (int s = 0; s < 4; s++) {
-	if (dir % 2 == 0) su3Mul(&gaugedSpinor[s*(3*2)], gauge, &projectedSpinor[s*(3*2)]);
-	else su3Tmul(&gaugedSpinor[s*(3*2)], gauge, &projectedSpinor[s*(3*2)]);
-      }
-      
-      sum(&res[i*(4*3*2)], &res[i*(4*3*2)], gaugedSpinor, 4*3*2);
+
+    if (ghostGauge) {
+      ghostGaugeEven[dir] = ghostGauge[dir];
+      ghostGaugeOdd[dir] = ghostGauge[dir] + (faceVolume[dir] / 2) * gauge_site_size;
     }
   }
-}
 
-#else
-
-template <typename sFloat, typename gFloat>
-void dslashReference(sFloat *res, gFloat **gaugeFull,  gFloat **ghostGauge, sFloat *spinorField, 
-		     sFloat **fwdSpinor, sFloat **backSpinor, int oddBit, int daggerBit) {
-  for (int i = 0; i < Vh * my_spinor_site_size; i++) res[i] = 0.0;
-
-  gFloat *gaugeEven[4], *gaugeOdd[4];
-  gFloat *ghostGaugeEven[4], *ghostGaugeOdd[4];
-  for (int dir = 0; dir < 4; dir++) {  
-    gaugeEven[dir] = gaugeFull[dir];
-    gaugeOdd[dir] = gaugeFull[dir] + Vh * gauge_site_size;
+  // forwards links live on this parity, backwards links on the other
+  gFloat **gaugeThis = oddBit ? gaugeOdd : gaugeEven;
+  gFloat **gaugeOther = oddBit ? gaugeEven : gaugeOdd;
+  gFloat **ghostGaugeOther = oddBit ? ghostGaugeEven : ghostGaugeOdd;
 
-    ghostGaugeEven[dir] = ghostGauge[dir];
-    ghostGaugeOdd[dir] = ghostGauge[dir] + (faceVolume[dir] / 2) * gauge_site_size;
-  }
-  
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
   for (int i = 0; i < Vh; i++) {
+    for (int s = 0; s < nSrc; s++)
+      for (int j = 0; j < 4 * 3 * 2; j++) res[s][i * (4 * 3 * 2) + j] = 0.0;
 
     for (int dir = 0; dir < 8; dir++) {
-      gFloat *gauge = gaugeLink_mg4dir(i, dir, oddBit, gaugeEven, gaugeOdd, ghostGaugeEven, ghostGaugeOdd, 1, 1);
-      sFloat *spinor = spinorNeighbor_mg4dir(i, dir, oddBit, spinorField, fwdSpinor, backSpinor, 1, 1);
-
-      sFloat projectedSpinor[my_spinor_site_size], gaugedSpinor[my_spinor_site_size];
-      int projIdx = 2*(dir/2)+(dir+daggerBit)%2;
-      multiplySpinorByDiracProjector(projectedSpinor, projIdx, spinor);
-      
-      for (int s = 0; s < 4; s++) {
-	if (dir % 2 == 0) su3Mul(&gaugedSpinor[s*(3*2)], gauge, &projectedSpinor[s*(3*2)]);
-	else su3Tmul(&gaugedSpinor[s*(3*2)], gauge, &projectedSpinor[s*(3*2)]);
+      const NeighborTable::Neighbor &nbr = neighbor.neighbor(i, dir);
+      const bool ghost = nbr.depth >= 0;
+
+      gFloat *gaugePtr;
+      if (dir % 2 == 0)
+        gaugePtr = &gaugeThis[dir / 2][i * gauge_site_size];
+      else if (ghost)
+        gaugePtr = &ghostGaugeOther[dir / 2][neighbor.ghostOffset(nbr, dir, 1) * gauge_site_size];
+      else
+        gaugePtr = &gaugeOther[dir / 2][nbr.idx * gauge_site_size];
+
+      gFloat gauge[gauge_site_size];
+      for (int j = 0; j < gauge_site_size; j++) gauge[j] = gaugePtr[j];
+
+      const int offset = ghost ? neighbor.ghostOffset(nbr, dir, 1) : nbr.idx;
+      sFloat **ghostSpinor = dir % 2 == 0 ? fwdSpinor : backSpinor;
+
+      for (int s = 0; s < nSrc; s++) {
+        sFloat *spinor = ghost ? &ghostSpinor[s * 4 + dir / 2][offset * my_spinor_site_size] :
+                                 &spinorField[s][offset * my_spinor_site_size];
+        wilsonHop(&res[s][i * (4 * 3 * 2)], gauge, spinor, dir, daggerBit);
       }
-      
-      sum(&res[i*(4*3*2)], &res[i*(4*3*2)], gaugedSpinor, 4*3*2);
     }
-
   }
 }
 
-#endif
-
 // this actually applies the preconditioned dslash, e.g., D_ee^{-1} D_eo or D_oo^{-1} D_oe
 void wil_dslash(void *out, void **gauge, void *in, int oddBit, int daggerBit,
 		QudaPrecision precision, QudaGaugeParam &gauge_param) {
-  
-#ifndef MULTI_GPU  
+  wil_dslash_msrc(&out, gauge, &in, 1, oddBit, daggerBit, precision, gauge_param);
+}
+
+void wil_dslash_msrc(void **out, void **gauge, void **in, int nSrc, int oddBit, int daggerBit, QudaPrecision precision,
+                     QudaGaugeParam &gauge_param)
+{
+#ifndef MULTI_GPU
   if (precision == QUDA_DOUBLE_PRECISION)
-    dslashReference((double*)out, (double**)gauge, (double*)in, oddBit, daggerBit);
+    dslashReference((double **)out, (double **)gauge, (double **)nullptr, (double **)in, (double **)nullptr,
+                    (double **)nullptr, nSrc, oddBit, daggerBit);
   else
-    dslashReference((float*)out, (float**)gauge, (float*)in, oddBit, daggerBit);
+    dslashReference((float **)out, (float **)gauge, (float **)nullptr, (float **)in, (float **)nullptr,
+                    (float **)nullptr, nSrc, oddBit, daggerBit);
 #else
 
   GaugeFieldParam gauge_field_param(gauge, gauge_param);
@@ -188,7 +122,6 @@ void wil_dslash(void *out, void **gauge, void *in, int oddBit, int daggerBit,
   // Get spinor ghost fields
   // First wrap the input spinor into a ColorSpinorField
   ColorSpinorParam csParam;
-  csParam.v = in;
   csParam.nColor = 3;
   csParam.nSpin = 4;
   csParam.nDim = 4;
@@ -201,29 +134,51 @@ void wil_dslash(void *out, void **gauge, void *in, int oddBit, int daggerBit,
   csParam.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
   csParam.gammaBasis = QUDA_DEGRAND_ROSSI_GAMMA_BASIS;
   csParam.create = QUDA_REFERENCE_FIELD_CREATE;
-  
-  cpuColorSpinorField inField(csParam);
 
-  {  // Now do the exchange
-    QudaParity otherParity = QUDA_INVALID_PARITY;
-    if (oddBit == QUDA_EVEN_PARITY) otherParity = QUDA_ODD_PARITY;
-    else if (oddBit == QUDA_ODD_PARITY) otherParity = QUDA_EVEN_PARITY;
-    else errorQuda("ERROR: full parity not supported in function %s", __FUNCTION__);
-    const int nFace = 1;
+  QudaParity otherParity = QUDA_INVALID_PARITY;
+  if (oddBit == QUDA_EVEN_PARITY) otherParity = QUDA_ODD_PARITY;
+  else if (oddBit == QUDA_ODD_PARITY) otherParity = QUDA_EVEN_PARITY;
+  else errorQuda("ERROR: full parity not supported in function %s", __FUNCTION__);
+  const int nFace = 1;
+
+  // The host ghost buffers are shared by all cpuColorSpinorFields, so
+  // each source's ghost zone is copied out after its exchange.
+  size_t ghost_bytes[4];
+  size_t src_ghost_bytes = 0;
+  for (int d = 0; d < 4; d++) {
+    ghost_bytes[d] = nFace * (faceVolume[d] / 2) * spinor_site_size * precision;
+    src_ghost_bytes += 2 * ghost_bytes[d];
+  }
+  char *ghost_buffer = static_cast<char *>(malloc(nSrc * src_ghost_bytes));
+  std::vector<void *> fwd_nbr_spinor(4 * nSrc, nullptr), back_nbr_spinor(4 * nSrc, nullptr);
 
+  for (int s = 0; s < nSrc; s++) {
+    csParam.v = in[s];
+    cpuColorSpinorField inField(csParam);
     inField.exchangeGhost(otherParity, nFace, daggerBit);
+
+    char *ghost = ghost_buffer + s * src_ghost_bytes;
+    for (int d = 0; d < 4; d++) {
+      if (!comm_dim_partitioned(d)) continue;
+      fwd_nbr_spinor[s * 4 + d] = ghost;
+      memcpy(ghost, inField.fwdGhostFaceBuffer[d], ghost_bytes[d]);
+      ghost += ghost_bytes[d];
+      back_nbr_spinor[s * 4 + d] = ghost;
+      memcpy(ghost, inField.backGhostFaceBuffer[d], ghost_bytes[d]);
+      ghost += ghost_bytes[d];
+    }
   }
-  void** fwd_nbr_spinor = inField.fwdGhostFaceBuffer;
-  void** back_nbr_spinor = inField.backGhostFaceBuffer;
 
   if (precision == QUDA_DOUBLE_PRECISION) {
-    dslashReference((double*)out, (double**)gauge, (double**)ghostGauge, (double*)in, 
-		    (double**)fwd_nbr_spinor, (double**)back_nbr_spinor, oddBit, daggerBit);
-  } else{
-    dslashReference((float*)out, (float**)gauge, (float**)ghostGauge, (float*)in, 
-		    (float**)fwd_nbr_spinor, (float**)back_nbr_spinor, oddBit, daggerBit);
+    dslashReference((double **)out, (double **)gauge, (double **)ghostGauge, (double **)in,
+                    (double **)fwd_nbr_spinor.data(), (double **)back_nbr_spinor.data(), nSrc, oddBit, daggerBit);
+  } else {
+    dslashReference((float **)out, (float **)gauge, (float **)ghostGauge, (float **)in,
+                    (float **)fwd_nbr_spinor.data(), (float **)back_nbr_spinor.data(), nSrc, oddBit, daggerBit);
   }
 
+  free(ghost_buffer);
+
 #endif
 
 }
@@ -291,17 +246,21 @@ void tm_dslash(void *res, void **gaugeFull, void *spinorField, double kappa, dou
 
 void wil_mat(void *out, void **gauge, void *in, double kappa, int dagger_bit, QudaPrecision precision,
 	     QudaGaugeParam &gauge_param) {
+  wil_mat_msrc(&out, gauge, &in, 1, kappa, dagger_bit, precision, gauge_param);
+}
 
-  void *inEven = in;
-  void *inOdd = (char *)in + Vh * spinor_site_size * precision;
-  void *outEven = out;
-  void *outOdd = (char *)out + Vh * spinor_site_size * precision;
+void wil_mat_msrc(void **out, void **gauge, void **in, int nSrc, double kappa, int dagger_bit,
+                  QudaPrecision precision, QudaGaugeParam &gauge_param)
+{
+  const size_t parity_bytes = Vh * spinor_site_size * precision;
+  std::vector<void *> inOdd = fieldOffset(in, nSrc, parity_bytes);
+  std::vector<void *> outOdd = fieldOffset(out, nSrc, parity_bytes);
 
-  wil_dslash(outOdd, gauge, inEven, 1, dagger_bit, precision, gauge_param);
-  wil_dslash(outEven, gauge, inOdd, 0, dagger_bit, precision, gauge_param);
+  wil_dslash_msrc(outOdd.data(), gauge, in, nSrc, 1, dagger_bit, precision, gauge_param);
+  wil_dslash_msrc(out, gauge, inOdd.data(), nSrc, 0, dagger_bit, precision, gauge_param);
 
   // lastly apply the kappa term
-  xpay(in, -kappa, out, V * spinor_site_size, precision);
+  for (int s = 0; s < nSrc; s++) xpay(in[s], -kappa, out[s], V * spinor_site_size, precision);
 }
 
 void tm_mat(void *out, void **gauge, void *in, double kappa, double mu, 
@@ -330,24 +289,31 @@ void tm_mat(void *out, void **gauge, void *in, double kappa, double mu,
 void wil_matpc(void *outEven, void **gauge, void *inEven, double kappa, 
 	       QudaMatPCType matpc_type, int daggerBit, QudaPrecision precision,
 	       QudaGaugeParam &gauge_param) {
+  wil_matpc_msrc(&outEven, gauge, &inEven, 1, kappa, matpc_type, daggerBit, precision, gauge_param);
+}
 
-  void *tmp = malloc(Vh * spinor_site_size * precision);
+void wil_matpc_msrc(void **outEven, void **gauge, void **inEven, int nSrc, double kappa, QudaMatPCType matpc_type,
+                    int daggerBit, QudaPrecision precision, QudaGaugeParam &gauge_param)
+{
+  const size_t parity_bytes = Vh * spinor_site_size * precision;
+  void *tmp_buffer = malloc(nSrc * parity_bytes);
+  std::vector<void *> tmp = fieldSplit(tmp_buffer, nSrc, parity_bytes);
 
   // FIXME: remove once reference clover is finished
   // full dslash operator
   if (matpc_type == QUDA_MATPC_EVEN_EVEN || matpc_type == QUDA_MATPC_EVEN_EVEN_ASYMMETRIC) {
-    wil_dslash(tmp, gauge, inEven, 1, daggerBit, precision, gauge_param);
-    wil_dslash(outEven, gauge, tmp, 0, daggerBit, precision, gauge_param);
+    wil_dslash_msrc(tmp.data(), gauge, inEven, nSrc, 1, daggerBit, precision, gauge_param);
+    wil_dslash_msrc(outEven, gauge, tmp.data(), nSrc, 0, daggerBit, precision, gauge_param);
   } else {
-    wil_dslash(tmp, gauge, inEven, 0, daggerBit, precision, gauge_param);
-    wil_dslash(outEven, gauge, tmp, 1, daggerBit, precision, gauge_param);
-  }    
-  
+    wil_dslash_msrc(tmp.data(), gauge, inEven, nSrc, 0, daggerBit, precision, gauge_param);
+    wil_dslash_msrc(outEven, gauge, tmp.data(), nSrc, 1, daggerBit, precision, gauge_param);
+  }
+
   // lastly apply the kappa term
   double kappa2 = -kappa*kappa;
-  xpay(inEven, kappa2, outEven, Vh * spinor_site_size, precision);
+  for (int s = 0; s < nSrc; s++) xpay(inEven[s], kappa2, outEven[s], Vh * spinor_site_size, precision);
 
-  free(tmp);
+  free(tmp_buffer);
 }
 
 // Apply the even-odd preconditioned Dirac operator
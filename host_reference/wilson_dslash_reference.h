@@ -17,6 +17,42 @@ extern "C" {
   void wil_matpc(void *out, void **gauge, void *in, double kappa,
 		 QudaMatPCType matpc_type,  int daggerBit, QudaPrecision precision, QudaGaugeParam &param);
 
+  /*
+    Multi-source variants of the Wilson, clover and twisted-clover
+    operators: these apply the operator to the nSrc spinors in[s],
+    storing the results in out[s], and stream the gauge field from
+    memory once for all sources rather than once per source.
+  */
+
+  void wil_dslash_msrc(void **out, void **gauge, void **in, int nSrc, int oddBit, int daggerBit,
+                       QudaPrecision precision, QudaGaugeParam &param);
+
+  void wil_mat_msrc(void **out, void **gauge, void **in, int nSrc, double kappa, int daggerBit,
+                    QudaPrecision precision, QudaGaugeParam &param);
+
+  void wil_matpc_msrc(void **out, void **gauge, void **in, int nSrc, double kappa, QudaMatPCType matpc_type,
+                      int daggerBit, QudaPrecision precision, QudaGaugeParam &param);
+
+  void clover_dslash_msrc(void **out, void **gauge, void *clover, void **in, int nSrc, int oddBit, int daggerBit,
+                          QudaPrecision precision, QudaGaugeParam &param);
+
+  void clover_mat_msrc(void **out, void **gauge, void *clover, void **in, int nSrc, double kappa, int dagger,
+                       QudaPrecision precision, QudaGaugeParam &gauge_param);
+
+  void clover_matpc_msrc(void **out, void **gauge, void *clover, void *clover_inv, void **in, int nSrc, double kappa,
+                         QudaMatPCType matpc_type, int dagger, QudaPrecision precision, QudaGaugeParam &gauge_param);
+
+  void tmc_dslash_msrc(void **out, void **gauge, void **in, int nSrc, void *clover, void *cInv, double kappa,
+                       double mu, QudaTwistFlavorType flavor, int oddBit, QudaMatPCType matpc_type, int daggerBit,
+                       QudaPrecision precision, QudaGaugeParam &param);
+
+  void tmc_mat_msrc(void **out, void **gauge, void *clover, void **in, int nSrc, double kappa, double mu,
+                    QudaTwistFlavorType flavor, int dagger, QudaPrecision precision, QudaGaugeParam &gauge_param);
+
+  void tmc_matpc_msrc(void **out, void **gauge, void **in, int nSrc, void *clover, void *cInv, double kappa,
+                      double mu, QudaTwistFlavorType flavor, QudaMatPCType matpc_type, int dagger,
+                      QudaPrecision precision, QudaGaugeParam &gauge_param);
+
   void tm_dslash(void *res, void **gauge, void *spinorField, double kappa,
 		 double mu, QudaTwistFlavorType flavor, int oddBit, QudaMatPCType matpc_type,
 		 int daggerBit, QudaPrecision sprecision, QudaGaugeParam &param);
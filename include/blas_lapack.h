@@ -20,6 +20,33 @@
 #define FLOPS_ZGETRI(n_) (6. * FMULS_GETRI((double)(n_)) + 2.0 * FADDS_GETRI((double)(n_)))
 #define FLOPS_CGETRI(n_) (6. * FMULS_GETRI((double)(n_)) + 2.0 * FADDS_GETRI((double)(n_)))
 
+#define FMULS_GETRS(n_, nrhs_) ((nrhs_) * (n_) * (n_))
+#define FADDS_GETRS(n_, nrhs_) ((nrhs_) * (n_) * ((n_)-1))
+
+#define FLOPS_ZGETRS(n_, nrhs_)                                                                                        \
+  (6. * FMULS_GETRS((double)(n_), (double)(nrhs_)) + 2.0 * FADDS_GETRS((double)(n_), (double)(nrhs_)))
+#define FLOPS_CGETRS(n_, nrhs_)                                                                                        \
+  (6. * FMULS_GETRS((double)(n_), (double)(nrhs_)) + 2.0 * FADDS_GETRS((double)(n_), (double)(nrhs_)))
+
+#define FMULS_GEMM(m_, n_, k_) ((m_) * (n_) * (k_))
+#define FADDS_GEMM(m_, n_, k_) ((m_) * (n_) * (k_))
+
+#define FLOPS_ZGEMM(m_, n_, k_)                                                                                        \
+  (6. * FMULS_GEMM((double)(m_), (double)(n_), (double)(k_))                                                           \
+   + 2.0 * FADDS_GEMM((double)(m_), (double)(n_), (double)(k_)))
+#define FLOPS_CGEMM(m_, n_, k_)                                                                                        \
+  (6. * FMULS_GEMM((double)(m_), (double)(n_), (double)(k_))                                                           \
+   + 2.0 * FADDS_GEMM((double)(m_), (double)(n_), (double)(k_)))
+
+// leading-order count for the Householder reduction to tridiagonal
+// form and the back transformation of the eigenvectors; the
+// tridiagonal QR iterations are not included
+#define FMULS_HEEV(n_) ((10. / 3.) * (n_) * (n_) * (n_))
+#define FADDS_HEEV(n_) ((10. / 3.) * (n_) * (n_) * (n_))
+
+#define FLOPS_ZHEEV(n_) (6. * FMULS_HEEV((double)(n_)) + 2.0 * FADDS_HEEV((double)(n_)))
+#define FLOPS_CHEEV(n_) (6. * FMULS_HEEV((double)(n_)) + 2.0 * FADDS_HEEV((double)(n_)))
+
 namespace quda
 {
 
@@ -29,6 +56,37 @@ namespace quda
     bool use_native();
     void set_native(bool native);
 
+    /**
+       Operation applied to a matrix operand, following the BLAS
+       convention: no-op, transpose or conjugate (Hermitian) transpose.
+     */
+    enum class Op { N, T, C };
+
+    /**
+       Parameters for a strided batched GEMM, C_i = alpha op(A_i) op(B_i)
+       + beta C_i for i = 0 .. batch-1, mirroring
+       cublas<t>gemmStridedBatched.  All matrices are complex and
+       stored in column-major order, op(A) is m x k, op(B) is k x n and
+       C is m x n.
+     */
+    struct GEMMParam {
+      Op trans_a = Op::N;       /**< Operation applied to A */
+      Op trans_b = Op::N;       /**< Operation applied to B */
+      int m = 0;                /**< Rows of op(A) and C */
+      int n = 0;                /**< Columns of op(B) and C */
+      int k = 0;                /**< Columns of op(A) and rows of op(B) */
+      int lda = 0;              /**< Leading dimension of A */
+      int ldb = 0;              /**< Leading dimension of B */
+      int ldc = 0;              /**< Leading dimension of C */
+      uint64_t stride_a = 0;    /**< Distance in elements between consecutive A_i */
+      uint64_t stride_b = 0;    /**< Distance in elements between consecutive B_i */
+      uint64_t stride_c = 0;    /**< Distance in elements between consecutive C_i */
+      Complex alpha = 1.0;      /**< Scale factor of the product */
+      Complex beta = 0.0;       /**< Scale factor of the input C */
+      uint64_t batch = 1;       /**< Problem batch size */
+      QudaPrecision precision = QUDA_DOUBLE_PRECISION; /**< Precision of the data */
+    };
+
     /**
        The native namespace is where we can deploy target specific
        blas/lapack operations, using vendor-specific libraries.  In
@@ -93,6 +151,69 @@ namespace quda
       long long BatchInvertMatrix(void *Ainv, void *A, const int n, const uint64_t batch, QudaPrecision precision,
                                   QudaFieldLocation location);
 
+      /**
+         Strided batched matrix-matrix product, C_i = alpha op(A_i)
+         op(B_i) + beta C_i.
+         @param[in] A Matrix field containing the A matrices
+         @param[in] B Matrix field containing the B matrices
+         @param[in,out] C Matrix field containing the C matrices
+         @param[in] param Problem dimensions, layout and scale factors
+         @param[in] Location of the input/output data
+         @return Number of flops done in this computation
+      */
+      long long BatchGEMM(void *A, void *B, void *C, const GEMMParam &param, QudaFieldLocation location);
+
+      /**
+         Batch LU factorization with partial pivoting, P A = L U, done
+         in place (cf. getrfBatched).  The unit lower triangle L and the
+         upper triangle U overwrite each matrix, and the row
+         interchanges are returned in LAPACK form: row i was swapped
+         with row pivot[i] - 1.
+         @param[in,out] A Matrix field, overwritten by the LU factors
+         @param[out] pivot Pivot indices, n per matrix
+         @param[in] n Dimension of each matrix
+         @param[in] batch Problem batch size
+         @param[in] precision Precision of the input/output data
+         @param[in] Location of the input/output data (including pivot)
+         @return Number of flops done in this computation
+      */
+      long long BatchLUFactor(void *A, int *pivot, const int n, const uint64_t batch, QudaPrecision precision,
+                              QudaFieldLocation location);
+
+      /**
+         Batch solve of A X = B using the LU factors computed by
+         BatchLUFactor (cf. getrsBatched).
+         @param[in,out] B Matrix field of n x nrhs right-hand sides,
+         overwritten by the solutions
+         @param[in] LU Matrix field containing the LU factors
+         @param[in] pivot Pivot indices returned by BatchLUFactor
+         @param[in] n Dimension of each matrix
+         @param[in] nrhs Number of right-hand sides per matrix
+         @param[in] batch Problem batch size
+         @param[in] precision Precision of the input/output data
+         @param[in] Location of the input/output data (including pivot)
+         @return Number of flops done in this computation
+      */
+      long long BatchLUSolve(void *B, void *LU, const int *pivot, const int n, const int nrhs, const uint64_t batch,
+                             QudaPrecision precision, QudaFieldLocation location);
+
+      /**
+         Batch eigen-decomposition of Hermitian matrices (cf.
+         heevjBatched).  Only the lower triangle of each matrix is
+         referenced.
+         @param[out] evals Real eigenvalues in ascending order, n per
+         matrix, in the same precision as A
+         @param[in,out] A Matrix field, overwritten by the orthonormal
+         eigenvectors stored as columns
+         @param[in] n Dimension of each matrix
+         @param[in] batch Problem batch size
+         @param[in] precision Precision of the input/output data
+         @param[in] Location of the input/output data (including evals)
+         @return Number of flops done in this computation
+      */
+      long long BatchHermitianEig(void *evals, void *A, const int n, const uint64_t batch, QudaPrecision precision,
+                                  QudaFieldLocation location);
+
     } // namespace generic
   }   // namespace blas_lapack
 } // namespace quda
@@ -6,6 +6,7 @@ extern "C" {
 #endif
 
   typedef struct MsgHandle_s MsgHandle;
+  typedef struct ReduceHandle_s ReduceHandle;
   typedef struct Topology_s Topology;
 
   /* defined in quda.h; redefining here to avoid circular references */
@@ -176,6 +177,32 @@ extern "C" {
    */
   bool comm_deterministic_reduce();
 
+  /**
+     @return Number of int64_t used to hold each double in the exact
+     accumulator used for deterministic reductions
+   */
+  size_t comm_exact_sum_length();
+
+  /**
+     @brief Convert doubles into exact accumulators.  Accumulators
+     from up to 2^31 processes can be summed element-wise as integers
+     (e.g., with MPI_SUM) in any order, and decoding the result gives
+     the correctly rounded sum of all the doubles.
+     @param[out] acc Accumulators, comm_exact_sum_length() per element
+     @param[in] data Values to encode
+     @param[in] size Number of values
+   */
+  void comm_exact_sum_encode(int64_t *acc, const double *data, size_t size);
+
+  /**
+     @brief Convert summed exact accumulators back into doubles,
+     rounded to nearest
+     @param[out] data Decoded sums
+     @param[in] acc Accumulators, comm_exact_sum_length() per element
+     @param[in] size Number of values
+   */
+  void comm_exact_sum_decode(double *data, const int64_t *acc, size_t size);
+
   /**
      @brief Gather all hostnames
      @param[out] hostname_recv_buf char array of length
@@ -191,6 +218,28 @@ extern "C" {
    */
   void comm_gather_gpuid(int *gpuid_recv_buf);
 
+  /**
+     @brief Gather the sizes of a variable-sized message from all
+     processes, e.g., ahead of comm_gatherv
+     @param[out] nbytes_recv_buf size_t array of length comm_size()
+     that will be filled in with the message size of all processes (in
+     rank order)
+     @param[in] nbytes Size of the message on this process
+   */
+  void comm_gather_nbytes(size_t *nbytes_recv_buf, size_t nbytes);
+
+  /**
+     @brief Gather variable-sized messages from all processes to
+     process 0
+     @param[out] recv_buf On process 0, buffer of the summed size of
+     all messages that will be filled in with the messages of all
+     processes (in rank order).  Not referenced on other processes.
+     @param[in] send_buf Message sent from this process
+     @param[in] nbytes Array of message sizes of all processes, as
+     returned by comm_gather_nbytes
+   */
+  void comm_gatherv(void *recv_buf, const void *send_buf, const size_t *nbytes);
+
   /**
      Enabled peer-to-peer communication.
      @param hostname_buf Array that holds all process hostnames
@@ -297,6 +346,59 @@ extern "C" {
   void comm_start(MsgHandle *mh);
   void comm_wait(MsgHandle *mh);
   int comm_query(MsgHandle *mh);
+
+  /**
+     @brief Allocate a host buffer that the other processes on this
+     node can read directly.  With MPI this is a segment of an
+     MPI_Win_allocate_shared window over the node; elsewhere, or if
+     this process has no other process on its node, it is a plain
+     host allocation.  This is collective over all processes, which
+     must make the same sequence of shared allocations and frees.
+     @param[in] nbytes Size of the allocation in bytes
+     @return Pointer to this process's segment
+   */
+  void *comm_shared_malloc(size_t nbytes);
+
+  /**
+     @brief Free a buffer allocated with comm_shared_malloc (collective)
+     @param[in] ptr Buffer to free
+   */
+  void comm_shared_free(void *ptr);
+
+  /**
+     @brief Whether a buffer is visible to the other processes on this
+     node, i.e., was allocated by comm_shared_malloc with shared memory
+     available.  This is the same on every process of a node.
+   */
+  bool comm_shared(void *ptr);
+
+  /**
+     @brief Locate a neighbor's copy of a shared buffer
+     @param[in] ptr Buffer returned by comm_shared_malloc
+     @param[in] dim Dimension of the neighbor
+     @param[in] dir Direction of the neighbor (-1 backwards, +1 forwards)
+     @return The neighbor's segment of the same allocation if the
+     neighbor is on this node, else NULL, in which case the data must
+     be exchanged with messages
+   */
+  void *comm_shared_neighbor(void *ptr, int dim, int dir);
+
+  /**
+     @brief Barrier over the processes on this node, which also makes
+     all writes to shared buffers made before the barrier visible to
+     reads after it.  Must be called by every process of the node
+     whenever comm_shared() is true of the buffers being exchanged.
+   */
+  void comm_shared_barrier(void);
+
+  /**
+     @brief Free any shared buffers still allocated, and the node
+     communicator, ahead of MPI_Finalize (collective).  Called from
+     comm_finalize; a later comm_shared_free of a buffer freed here
+     does nothing.
+   */
+  void comm_shared_finalize(void);
+
   void comm_allreduce(double* data);
   void comm_allreduce_max(double* data);
   void comm_allreduce_min(double* data);
@@ -304,6 +406,41 @@ extern "C" {
   void comm_allreduce_max_array(double* data, size_t size);
   void comm_allreduce_int(int* data);
   void comm_allreduce_xor(uint64_t *data);
+
+  /**
+     @brief Start a non-blocking sum of a double over all processes.
+     The result is written back to data by comm_reduce_wait, and data
+     must not be accessed until then.  As with the blocking
+     reductions, all processes must start their reductions in the
+     same order.
+     @param[in,out] data Value to be summed
+     @return Handle to the reduction in flight, NULL when there is
+     nothing to wait for
+   */
+  ReduceHandle *comm_iallreduce(double *data);
+
+  /**
+     @brief Start a non-blocking element-wise sum of an array over all
+     processes, see comm_iallreduce
+     @param[in,out] data Array to be summed
+     @param[in] size Number of elements
+     @return Handle to the reduction in flight
+   */
+  ReduceHandle *comm_iallreduce_array(double *data, size_t size);
+
+  /**
+     @brief Complete a non-blocking reduction, writing the result and
+     freeing the handle.  A NULL handle is ignored.
+     @param[in,out] rh Handle returned by comm_iallreduce*, set to NULL
+   */
+  void comm_reduce_wait(ReduceHandle *&rh);
+
+  /**
+     @brief Query whether a non-blocking reduction has completed
+     @param[in] rh Handle returned by comm_iallreduce*
+     @return Whether comm_reduce_wait would return immediately
+   */
+  int comm_reduce_query(ReduceHandle *rh);
   void comm_broadcast(void *data, size_t nbytes);
   void comm_barrier(void);
   void comm_abort(int status);
@@ -312,6 +449,21 @@ extern "C" {
   void reduceMaxDouble(double &);
   void reduceDouble(double &);
   void reduceDoubleArray(double *, const int len);
+
+  /**
+     @brief Non-blocking counterparts of reduceDouble and
+     reduceDoubleArray, so that the reduction can be overlapped with
+     other work.  The sum is only valid after reduceWait.
+     @return Handle to pass to reduceWait
+   */
+  ReduceHandle *reduceDoubleAsync(double &);
+  ReduceHandle *reduceDoubleArrayAsync(double *, const int len);
+
+  /**
+     @brief Complete a reduction started with reduceDoubleAsync or
+     reduceDoubleArrayAsync
+   */
+  void reduceWait(ReduceHandle *&);
   int commDim(int);
   int commCoords(int);
   int commDimPartitioned(int dir);
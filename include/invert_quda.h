@@ -785,6 +785,27 @@ namespace quda {
       virtual bool hermitian() { return true; } /** MPCG is only Hermitian system */
   };
 
+  /**
+     @brief Pipelined (Ghysels-Vanroose) CG solver.  The two inner
+     products of each iteration are fused into a single reduction,
+     which is done with a non-blocking global reduction that is
+     overlapped with the matrix-vector product.  This trades three
+     extra vector recurrences, and one extra matrix-vector product at
+     convergence, for hiding the allreduce latency.  Reliable updates
+     replace the residual and the recurred products with their true
+     values.
+   */
+  class PipelinedCG : public Solver
+  {
+
+  public:
+    PipelinedCG(const DiracMatrix &mat, const DiracMatrix &matSloppy, SolverParam &param, TimeProfile &profile);
+    virtual ~PipelinedCG();
+
+    void operator()(ColorSpinorField &out, ColorSpinorField &in);
+
+    virtual bool hermitian() { return true; } /** CG is only for Hermitian systems */
+  };
 
   class BiCGstab : public Solver {
 
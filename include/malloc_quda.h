@@ -136,6 +136,26 @@ namespace quda {
     */
     void flush_pinned();
 
+    /**
+       @brief Release cached host-memory allocations (see
+       QUDA_ENABLE_HOST_MEMORY_POOL), largest first, until at most
+       bytes remain cached.  safe_malloc() and host_free() go through
+       the host pool when it is enabled.
+       @param bytes Number of cached bytes to keep
+    */
+    void trim_host(size_t bytes);
+
+    /**
+       @brief Free all cached host-memory allocations.
+    */
+    void flush_host();
+
+    /**
+       @return High-water mark of the host pool, counting both the
+       allocations in use and those cached
+    */
+    size_t host_pool_peak();
+
   } // namespace pool
 
 }
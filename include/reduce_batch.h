@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include <comm_quda.h>
+#include <util_quda.h>
+
+namespace quda
+{
+
+  /**
+     @brief Coalesces independent global reductions into a single
+     allreduce.  While a batch is open the blas reductions return
+     rank-local partial sums, which are queued with add().  flush()
+     then sums the whole queue across ranks in one call, after which
+     get() returns the global value behind each handle.
+
+     Every reduction issued while the batch is open is left local, so
+     the batch should span only the reductions being queued and must
+     be flushed before any result is used.  Batches do not nest.
+  */
+  class ReduceBatch
+  {
+    // per-thread queue of partial sums, reused from batch to batch
+    static std::vector<double> &buffer()
+    {
+      static thread_local std::vector<double> buffer;
+      return buffer;
+    }
+
+    static bool &open()
+    {
+      static thread_local bool open = false;
+      return open;
+    }
+
+    const bool global_reduction; // the reduction state to restore at flush
+    bool flushed;
+
+  public:
+    /**
+       @brief Location of a queued value of type T
+    */
+    template <typename T> struct handle {
+      size_t offset;
+    };
+
+    ReduceBatch() : global_reduction(commGlobalReduction()), flushed(false)
+    {
+      if (open()) errorQuda("Nested reduction batches are not supported");
+      open() = true;
+      buffer().clear();
+      commGlobalReductionSet(false);
+    }
+
+    ~ReduceBatch()
+    {
+      if (!flushed) commGlobalReductionSet(global_reduction);
+      open() = false;
+    }
+
+    ReduceBatch(const ReduceBatch &) = delete;
+    ReduceBatch &operator=(const ReduceBatch &) = delete;
+
+    /**
+       @brief Queue a local partial sum for the global reduction
+       @param[in] local Partial sum, a double or an aggregate of them
+       (Complex, double2, double3, ...)
+       @return Handle with which to retrieve the sum after flush()
+    */
+    template <typename T> handle<T> add(const T &local)
+    {
+      static_assert(std::is_trivially_copyable<T>::value && sizeof(T) % sizeof(double) == 0,
+                    "ReduceBatch only queues aggregates of double");
+      if (flushed) errorQuda("Cannot add to a reduction batch that has been flushed");
+      auto &buf = buffer();
+      handle<T> h {buf.size()};
+      buf.resize(buf.size() + sizeof(T) / sizeof(double));
+      std::memcpy(buf.data() + h.offset, &local, sizeof(T));
+      return h;
+    }
+
+    /**
+       @brief Globally sum everything queued with one allreduce, and
+       restore the global reduction state for subsequent reductions
+    */
+    void flush()
+    {
+      if (flushed) errorQuda("Reduction batch has already been flushed");
+      commGlobalReductionSet(global_reduction);
+      flushed = true;
+      auto &buf = buffer();
+      if (buf.size() > 0) reduceDoubleArray(buf.data(), buf.size());
+    }
+
+    /**
+       @brief Return a globally summed value
+       @param[in] h Handle returned by add()
+    */
+    template <typename T> T get(handle<T> h) const
+    {
+      if (!flushed) errorQuda("Reduction batch must be flushed before it is read");
+      T value;
+      std::memcpy(static_cast<void *>(&value), buffer().data() + h.offset, sizeof(T));
+      return value;
+    }
+  };
+
+} // namespace quda
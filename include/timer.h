@@ -23,6 +23,12 @@ namespace quda {
 #else
 
 #include <sys/time.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
 
 #ifdef INTERFACE_NVTX
 #if QUDA_NVTX_VERSION == 3
@@ -40,6 +46,9 @@ namespace quda {
    * for timing fully host-device synchronous algorithms.
    */
   struct Timer {
+    /**< Monotonic clock used for all host timing */
+    using clock = std::chrono::steady_clock;
+
     /**< The cumulative sum of time */
     double time;
 
@@ -47,10 +56,10 @@ namespace quda {
     double last;
 
     /**< Used to store when the timer was last started */
-    timeval start;
+    clock::time_point start;
 
     /**< Used to store when the timer was last stopped */
-    timeval stop;
+    clock::time_point stop;
 
     /**< Are we currently timing? */
     bool running;
@@ -58,14 +67,36 @@ namespace quda {
     /**< Keep track of number of calls */
     int count;
 
-  Timer() : time(0.0), last(0.0), running(false), count(0) { ; } 
+#ifdef QUDA_HOST_PROFILE
+    /**< Shortest and longest recorded time interval */
+    double min;
+    double max;
+
+    /**< Number of histogram bins: bin 0 counts intervals below 1 us,
+       bin i intervals in [2^(i-1), 2^i) us and the last bin everything
+       longer */
+    static constexpr int n_bin = 32;
+
+    /**< Histogram of the recorded time intervals */
+    int histogram[n_bin];
+
+    /**< Lower edge of a histogram bin in seconds */
+    static double BinEdge(int bin) { return bin == 0 ? 0.0 : 1e-6 * std::ldexp(1.0, bin - 1); }
+#endif
+
+    Timer() : time(0.0), last(0.0), running(false), count(0)
+    {
+#ifdef QUDA_HOST_PROFILE
+      ResetStatistics();
+#endif
+    }
 
     void Start(const char *func, const char *file, int line) {
       if (running) {
 	printfQuda("ERROR: Cannot start an already running timer (%s:%d in %s())\n", file, line, func);
 	errorQuda("Aborting");
       }
-      gettimeofday(&start, NULL);
+      start = clock::now();
       running = true;
     }
 
@@ -74,14 +105,19 @@ namespace quda {
 	printfQuda("ERROR: Cannot stop an unstarted timer (%s:%d in %s())\n", file, line, func);
 	errorQuda("Aborting");
       }
-      gettimeofday(&stop, NULL);
+      stop = clock::now();
 
-      long ds = stop.tv_sec - start.tv_sec;
-      long dus = stop.tv_usec - start.tv_usec;
-      last = ds + 0.000001*dus;
+      last = std::chrono::duration<double>(stop - start).count();
       time += last;
       count++;
 
+#ifdef QUDA_HOST_PROFILE
+      if (last < min) min = last;
+      if (last > max) max = last;
+      const double us = 1e6 * last;
+      histogram[us < 1.0 ? 0 : std::min(std::ilogb(us) + 1, n_bin - 1)]++;
+#endif
+
       running = false;
     }
 
@@ -95,10 +131,113 @@ namespace quda {
       time = 0.0;
       last = 0.0;
       count = 0;
+#ifdef QUDA_HOST_PROFILE
+      ResetStatistics();
+#endif
+    }
+
+#ifdef QUDA_HOST_PROFILE
+    void ResetStatistics()
+    {
+      min = HUGE_VAL;
+      max = 0.0;
+      for (int i = 0; i < n_bin; i++) histogram[i] = 0;
     }
+#endif
 
   };
 
+#ifdef QUDA_HOST_PROFILE
+  /**
+     A node of the host call tree.  Each node is a named scope within
+     its parent, so the same scope entered from different places is
+     accounted separately, and the time spent in child scopes is
+     tracked to give the self time.
+   */
+  struct ProfileNode {
+    std::string name;
+    ProfileNode *parent;
+    std::vector<std::unique_ptr<ProfileNode>> children;
+    Timer timer;       /**< Inclusive time spent in this scope */
+    double child_time; /**< Time spent in the child scopes */
+
+    ProfileNode(const std::string &name, ProfileNode *parent) : name(name), parent(parent), child_time(0.0) { }
+
+    /**< Return the child scope with the given name, creating it if needed */
+    ProfileNode *Child(const std::string &name)
+    {
+      for (auto &child : children)
+        if (child->name == name) return child.get();
+      children.emplace_back(new ProfileNode(name, this));
+      return children.back().get();
+    }
+
+    /**< Time spent in this scope excluding its child scopes */
+    double SelfTime() const { return timer.time - child_time; }
+  };
+
+  /**
+     The host call tree of this process, built from ProfileScope
+     guards and from the TimeProfile timers.  Scopes are expected to
+     nest; exiting a scope closes any scope that was left open inside
+     it.
+   */
+  class ProfileTree {
+    static ProfileNode root;
+    static ProfileNode *current;
+
+    static void Close(const char *func, const char *file, int line);
+
+  public:
+    /**< Enter the named scope as a child of the current scope */
+    static ProfileNode *Enter(const std::string &name, const char *func, const char *file, int line)
+    {
+      return Enter(current->Child(name), func, file, line);
+    }
+
+    /**< Enter the given scope, which must be a child of the current scope */
+    static ProfileNode *Enter(ProfileNode *node, const char *func, const char *file, int line)
+    {
+      node->timer.Start(func, file, line);
+      current = node;
+      return node;
+    }
+
+    /**< The scope that new scopes are entered into */
+    static ProfileNode *Current() { return current; }
+
+    /**< Exit the scope node along with any scopes still open inside it */
+    static void Exit(ProfileNode *node, const char *func, const char *file, int line);
+
+    /**< Print the call tree with inclusive and self times */
+    static void Print();
+  };
+#endif
+
+  /**
+     RAII guard that attributes the time until the end of the
+     enclosing C++ scope to a named node of the host call tree, e.g.,
+
+       ProfileScope scope("setup");
+
+     The guard compiles to nothing unless QUDA_HOST_PROFILE is
+     defined.
+   */
+  class ProfileScope {
+#ifdef QUDA_HOST_PROFILE
+    ProfileNode *node;
+
+  public:
+    ProfileScope(const std::string &name) : node(ProfileTree::Enter(name, __func__, __FILE__, __LINE__)) { }
+    ~ProfileScope() { ProfileTree::Exit(node, __func__, __FILE__, __LINE__); }
+#else
+  public:
+    ProfileScope(const std::string &) { }
+#endif
+    ProfileScope(const ProfileScope &) = delete;
+    ProfileScope &operator=(const ProfileScope &) = delete;
+  };
+
   /**< Enumeration type used for writing a simple but extensible profiling framework. */
   enum QudaProfileType {
     QUDA_PROFILE_H2D,      /**< host -> device transfers */
@@ -179,6 +318,45 @@ namespace quda {
     bool switchOff;
     bool use_global;
 
+#ifdef QUDA_HOST_PROFILE
+    /**< Call-tree node last used by each timer; lower-level timers are not part of the tree */
+    ProfileNode *node[QUDA_PROFILE_COUNT] = {};
+
+    void EnterNode(const char *func, const char *file, int line, QudaProfileType idx)
+    {
+      if (idx >= QUDA_PROFILE_LOWER_LEVEL && idx != QUDA_PROFILE_TOTAL) return;
+      ProfileNode *parent = ProfileTree::Current();
+      if (!node[idx] || node[idx]->parent != parent)
+        node[idx] = parent->Child(idx == QUDA_PROFILE_TOTAL ? fname : pname[idx]);
+      ProfileTree::Enter(node[idx], func, file, line);
+    }
+
+    void ExitNode(const char *func, const char *file, int line, QudaProfileType idx)
+    {
+      if (idx >= QUDA_PROFILE_LOWER_LEVEL && idx != QUDA_PROFILE_TOTAL) return;
+      ProfileTree::Exit(node[idx], func, file, line);
+    }
+#endif
+
+  public:
+    /**< A timed interval, kept for the trace output */
+    struct Event {
+      std::string fname;                /**< Name of the profile the interval belongs to */
+      QudaProfileType idx;              /**< Which timer of the profile */
+      Timer::clock::time_point start;   /**< When the interval started */
+      Timer::clock::time_point stop;    /**< When the interval stopped */
+    };
+
+  private:
+    static bool record_events; /**< Whether to record every interval (enabled by QUDA_ENABLE_TRACE) */
+    static std::vector<Event> events;
+    static Timer::clock::time_point epoch;
+
+    void RecordEvent(QudaProfileType idx)
+    {
+      if (record_events) events.push_back({fname, idx, profile[idx].start, profile[idx].stop});
+    }
+
     // global timer
     static Timer global_profile[QUDA_PROFILE_COUNT];
     static bool global_switchOff[QUDA_PROFILE_COUNT];
@@ -221,10 +399,16 @@ namespace quda {
       // if total timer isn't running, then start it running
       if (!profile[QUDA_PROFILE_TOTAL].running && idx != QUDA_PROFILE_TOTAL) {
 	profile[QUDA_PROFILE_TOTAL].Start(func,file,line);
+#ifdef QUDA_HOST_PROFILE
+        EnterNode(func, file, line, QUDA_PROFILE_TOTAL);
+#endif
         switchOff = true;
       }
 
       profile[idx].Start(func, file, line); 
+#ifdef QUDA_HOST_PROFILE
+      EnterNode(func, file, line, idx);
+#endif
       PUSH_RANGE(fname.c_str(),idx)
 	if (use_global) StartGlobal(func,file,line,idx);
     }
@@ -232,11 +416,19 @@ namespace quda {
 
     void Stop_(const char *func, const char *file, int line, QudaProfileType idx) {
       profile[idx].Stop(func, file, line); 
+      RecordEvent(idx);
+#ifdef QUDA_HOST_PROFILE
+      ExitNode(func, file, line, idx);
+#endif
       POP_RANGE
 
       // switch off total timer if we need to
       if (switchOff && idx != QUDA_PROFILE_TOTAL) {
         profile[QUDA_PROFILE_TOTAL].Stop(func,file,line);
+        RecordEvent(QUDA_PROFILE_TOTAL);
+#ifdef QUDA_HOST_PROFILE
+        ExitNode(func, file, line, QUDA_PROFILE_TOTAL);
+#endif
         switchOff = false;
       }
       if (use_global) StopGlobal(func,file,line,idx);
@@ -255,6 +447,18 @@ namespace quda {
 
     bool isRunning(QudaProfileType idx) { return profile[idx].running; }
 
+    /**< Name of a timer type */
+    static const std::string &Name(QudaProfileType idx) { return pname[idx]; }
+
+    /**< The intervals recorded by all profiles so far (empty unless QUDA_ENABLE_TRACE is set) */
+    static const std::vector<Event> &Events() { return events; }
+
+    /**< Microseconds elapsed between the start of this process and t, the time base of the trace */
+    static double TraceTime(const Timer::clock::time_point &t)
+    {
+      return std::chrono::duration<double, std::micro>(t - epoch).count();
+    }
+
   };
 
 } // namespace quda
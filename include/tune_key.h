@@ -2,6 +2,7 @@
 #define _TUNE_KEY_H
 
 #include <cstring>
+#include <cstdint>
 
 namespace quda {
 
@@ -14,13 +15,23 @@ namespace quda {
     char name[name_n];
     char aux[aux_n];
 
-    TuneKey() { }
+    /**
+       64-bit FNV-1a hash of the volume, name and aux strings,
+       computed when the key is built so that the tunecache lookup in
+       tuneLaunch does not have to touch the strings.  Anything that
+       modifies the strings in place must call rehash() (or use
+       appendAux(), which does so).
+    */
+    uint64_t hash;
+
+    TuneKey() : hash(0) { volume[0] = name[0] = aux[0] = '\0'; }
     TuneKey(const char v[], const char n[], const char a[]="type=default") {
-      strcpy(volume, v);
-      strcpy(name, n);
-      strcpy(aux, a);
-    } 
-    TuneKey(const TuneKey &key) {
+      uint64_t h = hash_init;
+      h = copy_hash(volume, v, h);
+      h = copy_hash(name, n, h);
+      hash = copy_hash(aux, a, h);
+    }
+    TuneKey(const TuneKey &key) : hash(key.hash) {
       strcpy(volume,key.volume);
       strcpy(name,key.name);
       strcpy(aux,key.aux);
@@ -31,10 +42,31 @@ namespace quda {
 	strcpy(volume,key.volume);
 	strcpy(name,key.name);
 	strcpy(aux,key.aux);
+	hash = key.hash;
       }
       return *this;
     }
 
+    /**
+       @brief Recompute the hash after the strings have been modified
+       in place
+    */
+    void rehash() {
+      uint64_t h = hash_init;
+      h = hash_string(volume, h);
+      h = hash_string(name, h);
+      hash = hash_string(aux, h);
+    }
+
+    /**
+       @brief Append a string to aux and update the hash
+    */
+    TuneKey& appendAux(const char a[]) {
+      strcat(aux, a);
+      rehash();
+      return *this;
+    }
+
     bool operator<(const TuneKey &other) const {
       int vc = std::strcmp(volume, other.volume);
       if (vc < 0) {
@@ -49,12 +81,38 @@ namespace quda {
       }
       return false;
     }
-  
+
+    bool operator==(const TuneKey &other) const {
+      return hash == other.hash && std::strcmp(aux, other.aux) == 0 && std::strcmp(name, other.name) == 0
+        && std::strcmp(volume, other.volume) == 0;
+    }
+
+  private:
+    static constexpr uint64_t hash_init = 0xcbf29ce484222325ull;
+    static constexpr uint64_t hash_prime = 0x100000001b3ull;
+
+    // hash a string including its terminating null, so that the
+    // boundaries between the three strings are part of the hash
+    static uint64_t hash_string(const char *s, uint64_t h) {
+      do {
+        h = (h ^ static_cast<unsigned char>(*s)) * hash_prime;
+      } while (*s++);
+      return h;
+    }
+
+    // strcpy that hashes the string as it is copied
+    static uint64_t copy_hash(char *dst, const char *src, uint64_t h) {
+      do {
+        h = (h ^ static_cast<unsigned char>(*src)) * hash_prime;
+      } while ((*dst++ = *src++));
+      return h;
+    }
+
   };
 
 }
 
 /** Return the key of the last kernel that has been tuned / called.*/
 quda::TuneKey getLastTuneKey();
- 
+
 #endif
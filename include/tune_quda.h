@@ -310,7 +310,7 @@ namespace quda {
       if (!getTuning()) return true;
 
       TuneKey key = tuneKey();
-      if (use_managed_memory()) strcat(key.aux, ",managed");
+      if (use_managed_memory()) key.appendAux(",managed");
       // if key is present in cache then already tuned
       return getTuneCache().find(key) != getTuneCache().end();
 #else
@@ -382,6 +382,33 @@ namespace quda {
       return advanceSharedBytes(param) || advanceBlockDim(param) || advanceGridDim(param) || advanceAux(param);
     }
 
+    /**
+       @brief Adapt launch parameters tuned for this kernel at a
+       different volume to the present instance, used to warm start
+       the tuning (see QUDA_TUNE_WARM_START).  The tunable's own search
+       space is walked from initTuneParam until a configuration with
+       the seed's block, shared memory and aux (and grid, if the grid
+       is tuned) is reached, so that any grid the tunable derives for
+       itself is derived here in the same way.
+       @param[in,out] param The parameters to adapt
+       @return Whether the seed is in the search space of this instance
+    */
+    bool seedTuneParam(TuneParam &param) const
+    {
+      auto same = [](const dim3 &a, const dim3 &b) { return a.x == b.x && a.y == b.y && a.z == b.z; };
+      TuneParam candidate;
+      initTuneParam(candidate);
+      do {
+        if (same(candidate.block, param.block) && candidate.shared_bytes == param.shared_bytes
+            && candidate.aux.x == param.aux.x && candidate.aux.y == param.aux.y && candidate.aux.z == param.aux.z
+            && candidate.aux.w == param.aux.w && (!tuneGridDim() || same(candidate.grid, param.grid))) {
+          param = candidate;
+          return true;
+        }
+      } while (advanceTuneParam(candidate));
+      return false;
+    }
+
     /**
      * Check the launch parameters of the kernel to ensure that they are
      * valid for the current device.
@@ -510,29 +510,49 @@ namespace quda {
       }
     }
 
+    // Host send buffers from comm_shared_malloc are visible to the
+    // neighbors on this node, which read the faces straight out of
+    // them; messages are only used for the neighbors elsewhere
+    void *shm_fwd[4] = { };  // the forwards neighbor's backwards face
+    void *shm_back[4] = { }; // the backwards neighbor's forwards face
+    bool shared = false;
+
     for (int i=0; i<nDimComms; i++) {
       if (!comm_dim_partitioned(i)) continue;
-      mh_send_fwd[i] = comm_declare_send_relative(send_fwd[i], i, +1, bytes[i]);
-      mh_send_back[i] = comm_declare_send_relative(send_back[i], i, -1, bytes[i]);
-      mh_from_fwd[i] = comm_declare_receive_relative(recv_fwd[i], i, +1, bytes[i]);
-      mh_from_back[i] = comm_declare_receive_relative(recv_back[i], i, -1, bytes[i]);
+      shared = shared || comm_shared(send_fwd[i]);
+      shm_fwd[i] = comm_shared_neighbor(send_back[i], i, +1);
+      shm_back[i] = comm_shared_neighbor(send_fwd[i], i, -1);
+      mh_send_fwd[i] = shm_fwd[i] ? nullptr : comm_declare_send_relative(send_fwd[i], i, +1, bytes[i]);
+      mh_send_back[i] = shm_back[i] ? nullptr : comm_declare_send_relative(send_back[i], i, -1, bytes[i]);
+      mh_from_fwd[i] = shm_fwd[i] ? nullptr : comm_declare_receive_relative(recv_fwd[i], i, +1, bytes[i]);
+      mh_from_back[i] = shm_back[i] ? nullptr : comm_declare_receive_relative(recv_back[i], i, -1, bytes[i]);
     }
 
     for (int i=0; i<nDimComms; i++) {
       if (comm_dim_partitioned(i)) {
-	comm_start(mh_from_back[i]);
-	comm_start(mh_from_fwd[i]);
-	comm_start(mh_send_fwd[i]);
-	comm_start(mh_send_back[i]);
+	if (mh_from_back[i]) comm_start(mh_from_back[i]);
+	if (mh_from_fwd[i]) comm_start(mh_from_fwd[i]);
+	if (mh_send_fwd[i]) comm_start(mh_send_fwd[i]);
+	if (mh_send_back[i]) comm_start(mh_send_back[i]);
+      }
+    }
+
+    if (shared) {
+      comm_shared_barrier(); // the neighbors' faces are packed
+      for (int i=0; i<nDimComms; i++) {
+	if (!comm_dim_partitioned(i)) continue;
+	if (shm_fwd[i]) memcpy(recv_fwd[i], shm_fwd[i], bytes[i]);
+	if (shm_back[i]) memcpy(recv_back[i], shm_back[i], bytes[i]);
       }
+      comm_shared_barrier(); // our faces have been read and may be overwritten
     }
 
     for (int i=0; i<nDimComms; i++) {
       if (!comm_dim_partitioned(i)) continue;
-      comm_wait(mh_send_fwd[i]);
-      comm_wait(mh_send_back[i]);
-      comm_wait(mh_from_back[i]);
-      comm_wait(mh_from_fwd[i]);
+      if (mh_send_fwd[i]) comm_wait(mh_send_fwd[i]);
+      if (mh_send_back[i]) comm_wait(mh_send_back[i]);
+      if (mh_from_back[i]) comm_wait(mh_from_back[i]);
+      if (mh_from_fwd[i]) comm_wait(mh_from_fwd[i]);
     }
 
     if (Location() == QUDA_CUDA_FIELD_LOCATION) {
@@ -564,10 +584,10 @@ namespace quda {
 
     for (int i=0; i<nDimComms; i++) {
       if (!comm_dim_partitioned(i)) continue;
-      comm_free(mh_send_fwd[i]);
-      comm_free(mh_send_back[i]);
-      comm_free(mh_from_back[i]);
-      comm_free(mh_from_fwd[i]);
+      if (mh_send_fwd[i]) comm_free(mh_send_fwd[i]);
+      if (mh_send_back[i]) comm_free(mh_send_back[i]);
+      if (mh_from_back[i]) comm_free(mh_from_back[i]);
+      if (mh_from_fwd[i]) comm_free(mh_from_fwd[i]);
     }
   }
 
@@ -1,6 +1,8 @@
 #include <unistd.h> // for gethostname()
 #include <assert.h>
 #include <limits>
+#include <cmath>
+#include <cstring>
 
 #include <quda_internal.h>
 #include <comm_quda.h>
@@ -630,6 +632,8 @@ MsgHandle *comm_declare_strided_receive_relative_(const char *func, const char *
 
 void comm_finalize(void)
 {
+  comm_shared_finalize();
+
   Topology *topo = comm_default_topology();
   comm_destroy_topology(topo);
   comm_set_default_topology(NULL);
@@ -828,6 +832,120 @@ const char *comm_dim_topology_string() { return topology_string; }
 
 bool comm_deterministic_reduce() { return deterministic_reduce; }
 
+/**
+   The exact accumulator represents a sum of doubles as a fixed-point
+   integer spanning the whole double range, from 2^-1074 upwards, in
+   32-bit digits each held in an int64_t.  A double touches at most
+   three digits, and since each digit only accumulates values below
+   2^32 in magnitude, up to 2^31 accumulators can be added digit-wise
+   without carrying or overflow.  Integer addition is associative, so
+   the sum is the same whatever the number of ranks and the shape of
+   the reduction tree, and the digits can be reduced with a plain
+   MPI_SUM.  Three more slots count the infinities and NaNs.
+ */
+static constexpr int exact_min_exponent = -1074;
+static constexpr int exact_digits = 67; // (1024 + 1074 + 31 carry bits) / 32, rounded up
+static constexpr int exact_pos_inf = exact_digits;
+static constexpr int exact_neg_inf = exact_digits + 1;
+static constexpr int exact_nan = exact_digits + 2;
+
+size_t comm_exact_sum_length() { return exact_digits + 3; }
+
+void comm_exact_sum_encode(int64_t *acc, const double *data, size_t size)
+{
+  const size_t length = comm_exact_sum_length();
+  memset(acc, 0, size * length * sizeof(int64_t));
+
+  for (size_t i = 0; i < size; i++) {
+    int64_t *a = acc + i * length;
+    const double x = data[i];
+    if (std::isnan(x)) {
+      a[exact_nan]++;
+      continue;
+    } else if (std::isinf(x)) {
+      a[x > 0 ? exact_pos_inf : exact_neg_inf]++;
+      continue;
+    }
+
+    uint64_t bits;
+    memcpy(&bits, &x, sizeof(double));
+    const int64_t sign = (bits >> 63) ? -1 : 1;
+    const int biased = (bits >> 52) & 0x7ff;
+    uint64_t m = bits & ((1ull << 52) - 1);
+    int e = exact_min_exponent; // x = m * 2^e
+    if (biased) {
+      m |= 1ull << 52;
+      e = biased - 1075;
+    }
+
+    const int shift = e - exact_min_exponent;
+    const int k = shift / 32;
+    const int offset = shift % 32;
+    const uint64_t mask = 0xffffffffull;
+    const uint64_t upper = offset ? m >> (32 - offset) : m >> 32; // (m << offset) >> 32
+    a[k] += sign * static_cast<int64_t>((m << offset) & mask);
+    a[k + 1] += sign * static_cast<int64_t>(upper & mask);
+    a[k + 2] += sign * static_cast<int64_t>(upper >> 32);
+  }
+}
+
+void comm_exact_sum_decode(double *data, const int64_t *acc, size_t size)
+{
+  const size_t length = comm_exact_sum_length();
+
+  for (size_t i = 0; i < size; i++) {
+    const int64_t *a = acc + i * length;
+    if (a[exact_nan] || (a[exact_pos_inf] && a[exact_neg_inf])) {
+      data[i] = std::numeric_limits<double>::quiet_NaN();
+      continue;
+    } else if (a[exact_pos_inf] || a[exact_neg_inf]) {
+      data[i] = a[exact_pos_inf] ? std::numeric_limits<double>::infinity() : -std::numeric_limits<double>::infinity();
+      continue;
+    }
+
+    // propagate the carries, leaving digits in [0, 2^32) below a signed top digit
+    int64_t d[exact_digits];
+    int64_t carry = 0;
+    for (int k = 0; k < exact_digits; k++) {
+      const int64_t v = a[k] + carry;
+      carry = v >> 32; // arithmetic shift, i.e., floor division
+      d[k] = v - carry * (1ll << 32);
+    }
+    d[exact_digits - 1] += carry * (1ll << 32);
+
+    // take the magnitude in two's complement
+    const bool negative = d[exact_digits - 1] < 0;
+    if (negative) {
+      int64_t borrow = 0;
+      for (int k = 0; k < exact_digits; k++) {
+        const int64_t v = -d[k] - borrow;
+        borrow = v < 0 ? 1 : 0;
+        d[k] = v + borrow * (1ll << 32);
+      }
+    }
+
+    int h = exact_digits - 1;
+    while (h >= 0 && d[h] == 0) h--;
+    if (h < 0) {
+      data[i] = 0.0;
+      continue;
+    }
+
+    // gather the leading 64 bits, folding everything below into a
+    // sticky bit so that the conversion to double rounds correctly
+    const int lz = __builtin_clzll(d[h]) - 32;
+    uint64_t w = static_cast<uint64_t>(d[h]) << (32 + lz);
+    if (h >= 1) w |= static_cast<uint64_t>(d[h - 1]) << lz;
+    if (h >= 2 && lz) w |= static_cast<uint64_t>(d[h - 2]) >> (32 - lz);
+    bool sticky = h >= 2 && (lz ? d[h - 2] & ((1ll << (32 - lz)) - 1) : d[h - 2]) != 0;
+    for (int k = h - 3; k >= 0 && !sticky; k--) sticky = d[k] != 0;
+    if (sticky) w |= 1;
+
+    const double r = std::ldexp(static_cast<double>(w), exact_min_exponent + 32 * (h - 1) - lz);
+    data[i] = negative ? -r : r;
+  }
+}
+
 static bool globalReduce = true;
 static bool asyncReduce = false;
 
@@ -838,6 +956,13 @@ void reduceDouble(double &sum) { if (globalReduce) comm_allreduce(&sum); }
 void reduceDoubleArray(double *sum, const int len)
 { if (globalReduce) comm_allreduce_array(sum, len); }
 
+ReduceHandle *reduceDoubleAsync(double &sum) { return globalReduce ? comm_iallreduce(&sum) : nullptr; }
+
+ReduceHandle *reduceDoubleArrayAsync(double *sum, const int len)
+{ return globalReduce ? comm_iallreduce_array(sum, len) : nullptr; }
+
+void reduceWait(ReduceHandle *&handle) { comm_reduce_wait(handle); }
+
 int commDim(int dir) { return comm_dim(dir); }
 
 int commCoords(int dir) { return comm_coord(dir); }
@@ -3,6 +3,10 @@
 #include <cstring>
 #include <algorithm>
 #include <numeric>
+#include <limits>
+#include <map>
+#include <set>
+#include <vector>
 #include <mpi.h>
 #include <quda_internal.h>
 #include <comm_quda.h>
@@ -39,9 +43,46 @@ struct MsgHandle_s {
   bool custom;
 };
 
+struct ReduceHandle_s {
+  MPI_Request request;
+  double *data;
+  size_t size;
+  std::vector<int64_t> acc; // exact accumulators, when reducing deterministically
+};
+
 static int rank = -1;
 static int size = -1;
 
+/**
+   Communicator over the processes sharing this node's memory, or
+   MPI_COMM_NULL if there are none (or QUDA_ENABLE_HOST_SHM=0)
+ */
+static MPI_Comm node_comm = MPI_COMM_NULL;
+
+/**
+   Rank in node_comm of each neighbor, indexed as comm_neighbor_rank,
+   or MPI_UNDEFINED if the neighbor is on another node
+ */
+static int node_neighbor[2][4];
+
+/**
+   The window behind each comm_shared_malloc allocation, keyed by its
+   address, along with its place in the sequence of allocations, which
+   is the same on every process of the node
+ */
+struct SharedWindow {
+  MPI_Win win;
+  size_t serial;
+};
+static std::map<void *, SharedWindow> shared_window;
+static size_t shared_serial = 0;
+
+/**
+   Buffers whose windows were freed by comm_shared_finalize, so that a
+   later comm_shared_free of them does nothing
+ */
+static std::set<void *> shared_released;
+
 void comm_gather_hostname(char *hostname_recv_buf) {
   // determine which GPU this rank will use
   char *hostname = comm_hostname();
@@ -53,6 +94,26 @@ void comm_gather_gpuid(int *gpuid_recv_buf) {
   MPI_CHECK(MPI_Allgather(&gpuid, 1, MPI_INT, gpuid_recv_buf, 1, MPI_INT, MPI_COMM_HANDLE));
 }
 
+void comm_gather_nbytes(size_t *nbytes_recv_buf, size_t nbytes)
+{
+  MPI_CHECK(MPI_Allgather(&nbytes, sizeof(size_t), MPI_BYTE, nbytes_recv_buf, sizeof(size_t), MPI_BYTE, MPI_COMM_HANDLE));
+}
+
+void comm_gatherv(void *recv_buf, const void *send_buf, const size_t *nbytes)
+{
+  std::vector<int> counts(size), displs(size);
+  size_t offset = 0;
+  for (int i = 0; i < size; i++) {
+    if (offset + nbytes[i] > static_cast<size_t>(std::numeric_limits<int>::max()))
+      errorQuda("Gathered message size exceeds the MPI limit");
+    counts[i] = nbytes[i];
+    displs[i] = offset;
+    offset += nbytes[i];
+  }
+  MPI_CHECK(MPI_Gatherv(send_buf, counts[rank], MPI_BYTE, recv_buf, counts.data(), displs.data(), MPI_BYTE, 0,
+                        MPI_COMM_HANDLE));
+}
+
 void comm_init(int ndim, const int *dims, QudaCommsMap rank_from_coords, void *map_data)
 {
   int initialized;
@@ -75,6 +136,28 @@ void comm_init(int ndim, const int *dims, QudaCommsMap rank_from_coords, void *m
   }
 
   comm_init_common(ndim, dims, rank_from_coords, map_data);
+
+  char *enable_shm_env = getenv("QUDA_ENABLE_HOST_SHM");
+  if (!enable_shm_env || strcmp(enable_shm_env, "0") != 0) {
+    MPI_CHECK(MPI_Comm_split_type(MPI_COMM_HANDLE, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &node_comm));
+    int node_size;
+    MPI_CHECK(MPI_Comm_size(node_comm, &node_size));
+    if (node_size == 1) MPI_CHECK(MPI_Comm_free(&node_comm));
+  }
+
+  if (node_comm != MPI_COMM_NULL) {
+    MPI_Group group, node_group;
+    MPI_CHECK(MPI_Comm_group(MPI_COMM_HANDLE, &group));
+    MPI_CHECK(MPI_Comm_group(node_comm, &node_group));
+    for (int dir = 0; dir < 2; dir++) {
+      for (int dim = 0; dim < 4; dim++) {
+        int neighbor = comm_neighbor_rank(dir, dim);
+        MPI_CHECK(MPI_Group_translate_ranks(group, 1, &neighbor, node_group, &node_neighbor[dir][dim]));
+      }
+    }
+    MPI_CHECK(MPI_Group_free(&node_group));
+    MPI_CHECK(MPI_Group_free(&group));
+  }
 }
 
 int comm_rank(void)
@@ -231,10 +314,105 @@ int comm_query(MsgHandle *mh)
   return query;
 }
 
-template <typename T> T deterministic_reduce(T *array, int n)
+void *comm_shared_malloc(size_t nbytes)
+{
+  if (node_comm == MPI_COMM_NULL) {
+    void *ptr = safe_malloc(nbytes);
+    shared_released.erase(ptr);
+    return ptr;
+  }
+
+  // non-contiguous segments are each page aligned and can be placed
+  // on the owner's NUMA domain; never allocate zero bytes, so that
+  // every allocation has a distinct address
+  MPI_Info info;
+  MPI_CHECK(MPI_Info_create(&info));
+  MPI_CHECK(MPI_Info_set(info, "alloc_shared_noncontig", "true"));
+
+  void *ptr;
+  MPI_Win win;
+  MPI_CHECK(MPI_Win_allocate_shared(std::max(nbytes, (size_t)1), 1, info, node_comm, &ptr, &win));
+  MPI_CHECK(MPI_Info_free(&info));
+
+  // a passive-target epoch over the lifetime of the window, for MPI_Win_sync
+  MPI_CHECK(MPI_Win_lock_all(MPI_MODE_NOCHECK, win));
+  shared_window[ptr] = {win, shared_serial++};
+  shared_released.erase(ptr);
+
+  return ptr;
+}
+
+void comm_shared_free(void *ptr)
+{
+  auto it = shared_window.find(ptr);
+  if (it == shared_window.end()) {
+    if (shared_released.erase(ptr) == 0) host_free(ptr);
+    return;
+  }
+
+  MPI_CHECK(MPI_Win_unlock_all(it->second.win));
+  MPI_CHECK(MPI_Win_free(&it->second.win));
+  shared_window.erase(it);
+}
+
+bool comm_shared(void *ptr) { return shared_window.find(ptr) != shared_window.end(); }
+
+void *comm_shared_neighbor(void *ptr, int dim, int dir)
+{
+  auto it = shared_window.find(ptr);
+  if (it == shared_window.end()) return nullptr;
+
+  int neighbor = node_neighbor[dir > 0 ? 1 : 0][dim];
+  if (neighbor == MPI_UNDEFINED) return nullptr;
+
+  MPI_Aint nbytes;
+  int disp_unit;
+  void *base;
+  MPI_CHECK(MPI_Win_shared_query(it->second.win, neighbor, &nbytes, &disp_unit, &base));
+  return base;
+}
+
+void comm_shared_barrier(void)
+{
+  if (node_comm == MPI_COMM_NULL) return;
+
+  for (auto &w : shared_window) MPI_CHECK(MPI_Win_sync(w.second.win));
+  MPI_CHECK(MPI_Barrier(node_comm));
+  for (auto &w : shared_window) MPI_CHECK(MPI_Win_sync(w.second.win));
+}
+
+void comm_shared_finalize(void)
+{
+  if (shared_window.size() > 0) {
+    warningQuda("Freeing %lu shared host buffers still allocated at finalize", shared_window.size());
+
+    // MPI_Win_free is collective, so free in allocation order
+    std::vector<std::pair<size_t, void *>> order;
+    for (auto &w : shared_window) order.emplace_back(w.second.serial, w.first);
+    std::sort(order.begin(), order.end());
+    for (auto &o : order) {
+      MPI_Win &win = shared_window[o.second].win;
+      MPI_CHECK(MPI_Win_unlock_all(win));
+      MPI_CHECK(MPI_Win_free(&win));
+      shared_released.insert(o.second);
+    }
+    shared_window.clear();
+  }
+
+  if (node_comm != MPI_COMM_NULL) MPI_CHECK(MPI_Comm_free(&node_comm));
+}
+
+/**
+   Deterministic sum: each element is summed exactly as a fixed-point
+   integer, so the result does not depend on the number of ranks or on
+   the order in which MPI combines them, and costs a single allreduce.
+ */
+static void deterministic_reduce(double *data, size_t size)
 {
-  std::sort(array, array + n); // sort reduction into ascending order for deterministic reduction
-  return std::accumulate(array, array + n, 0.0);
+  std::vector<int64_t> acc(size * comm_exact_sum_length());
+  comm_exact_sum_encode(acc.data(), data, size);
+  MPI_CHECK(MPI_Allreduce(MPI_IN_PLACE, acc.data(), acc.size(), MPI_INT64_T, MPI_SUM, MPI_COMM_HANDLE));
+  comm_exact_sum_decode(data, acc.data(), size);
 }
 
 void comm_allreduce(double* data)
@@ -244,15 +422,46 @@ void comm_allreduce(double* data)
     MPI_CHECK(MPI_Allreduce(data, &recvbuf, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_HANDLE));
     *data = recvbuf;
   } else {
-    const size_t n = comm_size();
-    double *recv_buf = (double *)safe_malloc(n * sizeof(double));
-    MPI_CHECK(MPI_Allgather(data, 1, MPI_DOUBLE, recv_buf, 1, MPI_DOUBLE, MPI_COMM_HANDLE));
-    *data = deterministic_reduce(recv_buf, n);
-    host_free(recv_buf);
+    deterministic_reduce(data, 1);
   }
 }
 
 
+ReduceHandle *comm_iallreduce_array(double *data, size_t size)
+{
+  ReduceHandle *rh = new ReduceHandle;
+  rh->data = data;
+  rh->size = size;
+  if (!comm_deterministic_reduce()) {
+    MPI_CHECK(MPI_Iallreduce(MPI_IN_PLACE, data, size, MPI_DOUBLE, MPI_SUM, MPI_COMM_HANDLE, &rh->request));
+  } else {
+    rh->acc.resize(size * comm_exact_sum_length());
+    comm_exact_sum_encode(rh->acc.data(), data, size);
+    MPI_CHECK(MPI_Iallreduce(MPI_IN_PLACE, rh->acc.data(), rh->acc.size(), MPI_INT64_T, MPI_SUM, MPI_COMM_HANDLE,
+                             &rh->request));
+  }
+  return rh;
+}
+
+ReduceHandle *comm_iallreduce(double *data) { return comm_iallreduce_array(data, 1); }
+
+void comm_reduce_wait(ReduceHandle *&rh)
+{
+  if (!rh) return;
+  MPI_CHECK(MPI_Wait(&rh->request, MPI_STATUS_IGNORE));
+  if (!rh->acc.empty()) comm_exact_sum_decode(rh->data, rh->acc.data(), rh->size);
+  delete rh;
+  rh = nullptr;
+}
+
+int comm_reduce_query(ReduceHandle *rh)
+{
+  if (!rh) return 1;
+  int query;
+  MPI_CHECK(MPI_Test(&rh->request, &query, MPI_STATUS_IGNORE));
+  return query;
+}
+
 void comm_allreduce_max(double* data)
 {
   double recvbuf;
@@ -275,19 +484,7 @@ void comm_allreduce_array(double* data, size_t size)
     memcpy(data, recvbuf, size * sizeof(double));
     delete[] recvbuf;
   } else {
-    size_t n = comm_size();
-    double *recv_buf = new double[size * n];
-    MPI_CHECK(MPI_Allgather(data, size, MPI_DOUBLE, recv_buf, size, MPI_DOUBLE, MPI_COMM_HANDLE));
-
-    double *recv_trans = new double[size * n];
-    for (size_t i = 0; i < n; i++) {
-      for (size_t j = 0; j < size; j++) { recv_trans[j * n + i] = recv_buf[i * size + j]; }
-    }
-
-    for (size_t i = 0; i < size; i++) { data[i] = deterministic_reduce(recv_trans + i * n, n); }
-
-    delete[] recv_buf;
-    delete[] recv_trans;
+    deterministic_reduce(data, size);
   }
 }
 
@@ -1,6 +1,8 @@
 #include <qmp.h>
 #include <algorithm>
 #include <numeric>
+#include <limits>
+#include <vector>
 #include <quda_internal.h>
 #include <comm_quda.h>
 #include <mpi_comm_handle.h>
@@ -37,6 +39,16 @@ struct MsgHandle_s {
 #include <mpi.h>
 #endif
 
+/**
+   QMP has no non-blocking reductions, so these are done with MPI
+ */
+struct ReduceHandle_s {
+  MPI_Request request;
+  double *data;
+  size_t size;
+  std::vector<int64_t> acc; // exact accumulators, when reducing deterministically
+};
+
 // There are more efficient ways to do the following,
 // but it doesn't really matter since this function should be
 // called just once.
@@ -82,6 +94,46 @@ void comm_gather_gpuid(int *gpuid_recv_buf) {
 #endif
 }
 
+void comm_gather_nbytes(size_t *nbytes_recv_buf, size_t nbytes)
+{
+#ifdef USE_MPI_GATHER
+  MPI_CHECK(MPI_Allgather(&nbytes, sizeof(size_t), MPI_BYTE, nbytes_recv_buf, sizeof(size_t), MPI_BYTE, MPI_COMM_HANDLE));
+#else
+  // Abuse reductions to emulate all-gather
+  for (int i = 0; i < comm_size(); i++) {
+    double data = (i == comm_rank()) ? nbytes : 0;
+    QMP_sum_double(&data);
+    nbytes_recv_buf[i] = data;
+  }
+#endif
+}
+
+void comm_gatherv(void *recv_buf, const void *send_buf, const size_t *nbytes)
+{
+#ifdef USE_MPI_GATHER
+  std::vector<int> counts(comm_size()), displs(comm_size());
+  size_t offset = 0;
+  for (int i = 0; i < comm_size(); i++) {
+    if (offset + nbytes[i] > static_cast<size_t>(std::numeric_limits<int>::max()))
+      errorQuda("Gathered message size exceeds the MPI limit");
+    counts[i] = nbytes[i];
+    displs[i] = offset;
+    offset += nbytes[i];
+  }
+  MPI_CHECK(MPI_Gatherv(send_buf, counts[comm_rank()], MPI_BYTE, recv_buf, counts.data(), displs.data(), MPI_BYTE, 0,
+                        MPI_COMM_HANDLE));
+#else
+  // Abuse reductions to emulate gather, one byte at a time
+  char *recv = static_cast<char *>(recv_buf);
+  for (int i = 0; i < comm_size(); i++) {
+    for (size_t j = 0; j < nbytes[i]; j++) {
+      int data = (i == comm_rank()) ? static_cast<const char *>(send_buf)[j] : 0;
+      QMP_sum_int(&data);
+      if (comm_rank() == 0) *recv++ = data;
+    }
+  }
+#endif
+}
 
 void comm_init(int ndim, const int *dims, QudaCommsMap rank_from_coords, void *map_data)
 {
@@ -220,10 +272,29 @@ int comm_query(MsgHandle *mh)
   return (QMP_is_complete(mh->handle) == QMP_TRUE);
 }
 
-template <typename T> T deterministic_reduce(T *array, int n)
+// shared-memory halos are only implemented with MPI: QMP keeps every
+// exchange on its messaging path
+
+void *comm_shared_malloc(size_t nbytes) { return safe_malloc(nbytes); }
+
+void comm_shared_free(void *ptr) { host_free(ptr); }
+
+bool comm_shared(void *) { return false; }
+
+void *comm_shared_neighbor(void *, int, int) { return NULL; }
+
+void comm_shared_barrier(void) {}
+
+void comm_shared_finalize(void) {}
+
+/** Deterministic sum using exact accumulators, see comm_exact_sum_encode */
+static void deterministic_reduce(double *data, size_t size)
 {
-  std::sort(array, array + n); // sort reduction into ascending order for deterministic reduction
-  return std::accumulate(array, array + n, 0.0);
+  // we need to break out of QMP for the deterministic floating point reductions
+  std::vector<int64_t> acc(size * comm_exact_sum_length());
+  comm_exact_sum_encode(acc.data(), data, size);
+  MPI_CHECK(MPI_Allreduce(MPI_IN_PLACE, acc.data(), acc.size(), MPI_INT64_T, MPI_SUM, MPI_COMM_HANDLE));
+  comm_exact_sum_decode(data, acc.data(), size);
 }
 
 void comm_allreduce(double* data)
@@ -231,16 +302,46 @@ void comm_allreduce(double* data)
   if (!comm_deterministic_reduce()) {
     QMP_CHECK(QMP_sum_double(data));
   } else {
-    // we need to break out of QMP for the deterministic floating point reductions
-    const size_t n = comm_size();
-    double *recv_buf = (double *)safe_malloc(n * sizeof(double));
-    MPI_CHECK(MPI_Allgather(data, 1, MPI_DOUBLE, recv_buf, 1, MPI_DOUBLE, MPI_COMM_HANDLE));
-    *data = deterministic_reduce(recv_buf, n);
-    host_free(recv_buf);
+    deterministic_reduce(data, 1);
   }
 }
 
 
+ReduceHandle *comm_iallreduce_array(double *data, size_t size)
+{
+  ReduceHandle *rh = new ReduceHandle;
+  rh->data = data;
+  rh->size = size;
+  if (!comm_deterministic_reduce()) {
+    MPI_CHECK(MPI_Iallreduce(MPI_IN_PLACE, data, size, MPI_DOUBLE, MPI_SUM, MPI_COMM_HANDLE, &rh->request));
+  } else {
+    rh->acc.resize(size * comm_exact_sum_length());
+    comm_exact_sum_encode(rh->acc.data(), data, size);
+    MPI_CHECK(MPI_Iallreduce(MPI_IN_PLACE, rh->acc.data(), rh->acc.size(), MPI_INT64_T, MPI_SUM, MPI_COMM_HANDLE,
+                             &rh->request));
+  }
+  return rh;
+}
+
+ReduceHandle *comm_iallreduce(double *data) { return comm_iallreduce_array(data, 1); }
+
+void comm_reduce_wait(ReduceHandle *&rh)
+{
+  if (!rh) return;
+  MPI_CHECK(MPI_Wait(&rh->request, MPI_STATUS_IGNORE));
+  if (!rh->acc.empty()) comm_exact_sum_decode(rh->data, rh->acc.data(), rh->size);
+  delete rh;
+  rh = nullptr;
+}
+
+int comm_reduce_query(ReduceHandle *rh)
+{
+  if (!rh) return 1;
+  int query;
+  MPI_CHECK(MPI_Test(&rh->request, &query, MPI_STATUS_IGNORE));
+  return query;
+}
+
 void comm_allreduce_max(double* data)
 {
   QMP_CHECK( QMP_max_double(data) );
@@ -257,20 +358,7 @@ void comm_allreduce_array(double* data, size_t size)
   if (!comm_deterministic_reduce()) {
     QMP_CHECK(QMP_sum_double_array(data, size));
   } else {
-    // we need to break out of QMP for the deterministic floating point reductions
-    size_t n = comm_size();
-    double *recv_buf = new double[size * n];
-    MPI_CHECK(MPI_Allgather(data, size, MPI_DOUBLE, recv_buf, size, MPI_DOUBLE, MPI_COMM_HANDLE));
-
-    double *recv_trans = new double[size * n];
-    for (size_t i = 0; i < n; i++) {
-      for (size_t j = 0; j < size; j++) { recv_trans[j * n + i] = recv_buf[i * size + j]; }
-    }
-
-    for (size_t i = 0; i < size; i++) { data[i] = deterministic_reduce(recv_trans + i * n, n); }
-
-    delete[] recv_buf;
-    delete[] recv_trans;
+    deterministic_reduce(data, size);
   }
 }
 
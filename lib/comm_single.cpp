@@ -5,6 +5,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <comm_quda.h>
+#include <malloc_quda.h>
 
 void comm_init(int ndim, const int *dims, QudaCommsMap rank_from_coords, void *map_data)
 {
@@ -23,6 +24,13 @@ void comm_gather_gpuid(int *gpuid_recv_buf) {
   gpuid_recv_buf[0] = comm_gpuid();
 }
 
+void comm_gather_nbytes(size_t *nbytes_recv_buf, size_t nbytes) { nbytes_recv_buf[0] = nbytes; }
+
+void comm_gatherv(void *recv_buf, const void *send_buf, const size_t *nbytes)
+{
+  memcpy(recv_buf, send_buf, nbytes[0]);
+}
+
 MsgHandle *comm_declare_send_displaced(void *buffer, const int displacement[], size_t nbytes)
 { return NULL; }
 
@@ -45,6 +53,18 @@ void comm_wait(MsgHandle *mh) {}
 
 int comm_query(MsgHandle *mh) { return 1; }
 
+void *comm_shared_malloc(size_t nbytes) { return safe_malloc(nbytes); }
+
+void comm_shared_free(void *ptr) { host_free(ptr); }
+
+bool comm_shared(void *ptr) { return false; }
+
+void *comm_shared_neighbor(void *ptr, int dim, int dir) { return NULL; }
+
+void comm_shared_barrier(void) {}
+
+void comm_shared_finalize(void) {}
+
 void comm_allreduce(double* data) {}
 
 void comm_allreduce_max(double* data) {}
@@ -59,6 +79,15 @@ void comm_allreduce_int(int* data) {}
 
 void comm_allreduce_xor(uint64_t *data) {}
 
+// with a single process the sum is already complete, so there is nothing to wait for
+ReduceHandle *comm_iallreduce(double *data) { return NULL; }
+
+ReduceHandle *comm_iallreduce_array(double *data, size_t size) { return NULL; }
+
+void comm_reduce_wait(ReduceHandle *&rh) { rh = NULL; }
+
+int comm_reduce_query(ReduceHandle *rh) { return 1; }
+
 void comm_broadcast(void *data, size_t nbytes) {}
 
 void comm_barrier(void) {}
@@ -274,8 +274,9 @@ namespace quda {
       for (int i=0; i<nDimComms; i++) {
 	fwdGhostFaceBuffer[i] = safe_malloc(ghostFaceBytes[i]);
 	backGhostFaceBuffer[i] = safe_malloc(ghostFaceBytes[i]);
-	fwdGhostFaceSendBuffer[i] = safe_malloc(ghostFaceBytes[i]);
-	backGhostFaceSendBuffer[i] = safe_malloc(ghostFaceBytes[i]);
+	// neighbors on this node read the send faces directly
+	fwdGhostFaceSendBuffer[i] = comm_shared_malloc(ghostFaceBytes[i]);
+	backGhostFaceSendBuffer[i] = comm_shared_malloc(ghostFaceBytes[i]);
       }
       initGhostFaceBuffer = 1;
     }
@@ -289,8 +290,8 @@ namespace quda {
     for(int i=0; i < 4; i++){  // make nDimComms static?
       host_free(fwdGhostFaceBuffer[i]); fwdGhostFaceBuffer[i] = NULL;
       host_free(backGhostFaceBuffer[i]); backGhostFaceBuffer[i] = NULL;
-      host_free(fwdGhostFaceSendBuffer[i]); fwdGhostFaceSendBuffer[i] = NULL;
-      host_free(backGhostFaceSendBuffer[i]);  backGhostFaceSendBuffer[i] = NULL;
+      comm_shared_free(fwdGhostFaceSendBuffer[i]); fwdGhostFaceSendBuffer[i] = NULL;
+      comm_shared_free(backGhostFaceSendBuffer[i]);  backGhostFaceSendBuffer[i] = NULL;
     } 
     initGhostFaceBuffer = 0;
   }
@@ -140,10 +140,11 @@ namespace quda {
     if ( (link_direction == QUDA_LINK_BIDIRECTIONAL || link_direction == QUDA_LINK_FORWARDS) && geometry != QUDA_COARSE_GEOMETRY)
       errorQuda("Cannot request exchange of forward links on non-coarse geometry");
 
+    // shared so that neighbors on this node can read the links directly
     void *send[2*QUDA_MAX_DIM];
     for (int d=0; d<nDim; d++) {
-      send[d] = safe_malloc(nFace*surface[d]*nInternal*precision);
-      if (geometry == QUDA_COARSE_GEOMETRY) send[d+4] = safe_malloc(nFace*surface[d]*nInternal*precision);
+      send[d] = comm_shared_malloc(nFace*surface[d]*nInternal*precision);
+      if (geometry == QUDA_COARSE_GEOMETRY) send[d+4] = comm_shared_malloc(nFace*surface[d]*nInternal*precision);
     }
 
     if (link_direction == QUDA_LINK_BACKWARDS || link_direction == QUDA_LINK_BIDIRECTIONAL) {
@@ -160,7 +161,7 @@ namespace quda {
       exchange(ghost+nDim, send+nDim, QUDA_FORWARDS);
     }
 
-    for (int d=0; d<geometry; d++) host_free(send[d]);
+    for (int d=0; d<geometry; d++) comm_shared_free(send[d]);
   }
 
   // This does the opposite of exchangeGhost and sends back the ghost
@@ -194,7 +195,7 @@ namespace quda {
     for (int d=0; d<nDim; d++) {
       if (!(comm_dim_partitioned(d) || (no_comms_fill && R[d])) ) continue;
       bytes[d] = surface[d] * R[d] * geometry * nInternal * precision;
-      send[d] = safe_malloc(2 * bytes[d]);
+      send[d] = comm_shared_malloc(2 * bytes[d]);
       recv[d] = safe_malloc(2 * bytes[d]);
     }
 
@@ -204,31 +205,48 @@ namespace quda {
       extractExtendedGaugeGhost(*this, d, R, send, true);
 
       if (comm_dim_partitioned(d)) {
-	// do the exchange
-	MsgHandle *mh_recv_back;
-	MsgHandle *mh_recv_fwd;
-	MsgHandle *mh_send_fwd;
-	MsgHandle *mh_send_back;
-	
-	mh_recv_back = comm_declare_receive_relative(recv[d], d, -1, bytes[d]);
-	mh_recv_fwd  = comm_declare_receive_relative(((char*)recv[d])+bytes[d], d, +1, bytes[d]);
-	mh_send_back = comm_declare_send_relative(send[d], d, -1, bytes[d]);
-	mh_send_fwd  = comm_declare_send_relative(((char*)send[d])+bytes[d], d, +1, bytes[d]);
-	
-	comm_start(mh_recv_back);
-	comm_start(mh_recv_fwd);
-	comm_start(mh_send_fwd);
-	comm_start(mh_send_back);
-	
-	comm_wait(mh_send_fwd);
-	comm_wait(mh_send_back);
-	comm_wait(mh_recv_back);
-	comm_wait(mh_recv_fwd);
-	
-	comm_free(mh_send_fwd);
-	comm_free(mh_send_back);
-	comm_free(mh_recv_back);
-	comm_free(mh_recv_fwd);
+	// do the exchange, reading the faces of neighbors on this node
+	// directly from their send buffers
+	char *shm_back = static_cast<char*>(comm_shared_neighbor(send[d], d, -1));
+	char *shm_fwd = static_cast<char*>(comm_shared_neighbor(send[d], d, +1));
+
+	MsgHandle *mh_recv_back = nullptr;
+	MsgHandle *mh_recv_fwd = nullptr;
+	MsgHandle *mh_send_fwd = nullptr;
+	MsgHandle *mh_send_back = nullptr;
+
+	if (!shm_back) {
+	  mh_recv_back = comm_declare_receive_relative(recv[d], d, -1, bytes[d]);
+	  mh_send_back = comm_declare_send_relative(send[d], d, -1, bytes[d]);
+	  comm_start(mh_recv_back);
+	  comm_start(mh_send_back);
+	}
+	if (!shm_fwd) {
+	  mh_recv_fwd  = comm_declare_receive_relative(((char*)recv[d])+bytes[d], d, +1, bytes[d]);
+	  mh_send_fwd  = comm_declare_send_relative(((char*)send[d])+bytes[d], d, +1, bytes[d]);
+	  comm_start(mh_recv_fwd);
+	  comm_start(mh_send_fwd);
+	}
+
+	if (comm_shared(send[d])) {
+	  comm_shared_barrier();
+	  if (shm_back) memcpy(recv[d], shm_back + bytes[d], bytes[d]);
+	  if (shm_fwd) memcpy(static_cast<char*>(recv[d]) + bytes[d], shm_fwd, bytes[d]);
+	  comm_shared_barrier();
+	}
+
+	if (mh_send_fwd) {
+	  comm_wait(mh_send_fwd);
+	  comm_wait(mh_recv_fwd);
+	  comm_free(mh_send_fwd);
+	  comm_free(mh_recv_fwd);
+	}
+	if (mh_send_back) {
+	  comm_wait(mh_send_back);
+	  comm_wait(mh_recv_back);
+	  comm_free(mh_send_back);
+	  comm_free(mh_recv_back);
+	}
       } else {
 	memcpy(static_cast<char*>(recv[d])+bytes[d], send[d], bytes[d]);
 	memcpy(recv[d], static_cast<char*>(send[d])+bytes[d], bytes[d]);
@@ -240,7 +258,7 @@ namespace quda {
 
     for (int d=0; d<nDim; d++) {
       if (!(comm_dim_partitioned(d) || (no_comms_fill && R[d])) ) continue;
-      host_free(send[d]);
+      comm_shared_free(send[d]);
       host_free(recv[d]);
     }
 
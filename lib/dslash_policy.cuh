@@ -1989,7 +1989,7 @@ public:
      TuneKey key = dslash.tuneKey();
      strcat(key.aux, comm_dim_topology_string());
      strcat(key.aux, comm_config_string()); // any change in P2P/GDR will be stored as a separate tunecache entry
-     strcat(key.aux, policy_string);        // any change in policies enabled will be stored as a separate entry
+     key.appendAux(policy_string);          // any change in policies enabled will be stored as a separate entry
      dslashParam.kernel_type = kernel_type;
      return key;
    }
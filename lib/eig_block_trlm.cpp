@@ -11,6 +11,7 @@
 #include <color_spinor_field.h>
 #include <blas_quda.h>
 #include <util_quda.h>
+#include <reduce_batch.h>
 
 #include <Eigen/Eigenvalues>
 #include <Eigen/Dense>
@@ -308,16 +309,24 @@ namespace quda
     // Column major order
     bool orthed = false;
     int k = 0, kmax = 3;
+    std::vector<ReduceBatch::handle<Complex>> cnorm_h(block_size);
     while (!orthed && k < kmax) {
       // Compute R_{k}
       if (getVerbosity() >= QUDA_DEBUG_VERBOSE) printfQuda("Orthing k = %d\n", k);
       for (int b = 0; b < block_size; b++) {
-        double norm = sqrt(blas::norm2(*r[b]));
+        // The norm of r[b] and its overlaps with the later vectors are
+        // independent, so they share one global reduction
+        ReduceBatch batch;
+        auto norm2_h = batch.add(blas::norm2(*r[b]));
+        for (int c = b + 1; c < block_size; c++) cnorm_h[c] = batch.add(blas::cDotProduct(*r[b], *r[c]));
+        batch.flush();
+
+        double norm = sqrt(batch.get(norm2_h));
         blas::ax(1.0 / norm, *r[b]);
         jth_block[b * (block_size + 1)] = norm;
         for (int c = b + 1; c < block_size; c++) {
 
-          Complex cnorm = blas::cDotProduct(*r[b], *r[c]);
+          Complex cnorm = batch.get(cnorm_h[c]) / norm;
           blas::caxpy(-cnorm, *r[b], *r[c]);
 
           idx = c * block_size + b;
@@ -12,6 +12,7 @@
 #include <blas_quda.h>
 #include <util_quda.h>
 #include <vector_io.h>
+#include <reduce_batch.h>
 
 #include <Eigen/Eigenvalues>
 #include <Eigen/Dense>
@@ -441,13 +442,22 @@ namespace quda
     vecs_ptr.reserve(size);
     for (int i = 0; i < size; i++) vecs_ptr.push_back(vecs[i]);
 
+    // Row-oriented MGS: once i is final, normalise it and project it
+    // out of every later vector.  The norm of i and all of its overlaps
+    // are independent, so each row costs a single global reduction.
+    std::vector<ReduceBatch::handle<Complex>> cnorm_h(size);
     for (int i = 0; i < size; i++) {
-      for (int j = 0; j < i; j++) {
-        Complex cnorm = blas::cDotProduct(*vecs_ptr[j], *vecs_ptr[i]); // <j|i> with i normalised.
-        blas::caxpy(-cnorm, *vecs_ptr[j], *vecs_ptr[i]);               // i = i - proj_{j}(i) = i - <j|i> * i
-      }
-      double norm = sqrt(blas::norm2(*vecs_ptr[i]));
+      ReduceBatch batch;
+      auto norm2_h = batch.add(blas::norm2(*vecs_ptr[i]));
+      for (int j = i + 1; j < size; j++) cnorm_h[j] = batch.add(blas::cDotProduct(*vecs_ptr[i], *vecs_ptr[j]));
+      batch.flush();
+
+      double norm = sqrt(batch.get(norm2_h));
       blas::ax(1.0 / norm, *vecs_ptr[i]); // i/<i|i>
+      for (int j = i + 1; j < size; j++) {
+        Complex cnorm = batch.get(cnorm_h[j]) / norm;    // <i|j> with i normalised.
+        blas::caxpy(-cnorm, *vecs_ptr[i], *vecs_ptr[j]); // j = j - proj_{i}(j) = j - <i|j> * i
+      }
     }
   }
 
@@ -624,14 +634,20 @@ namespace quda
       // than make the direct relation (sigma_i)^2 = |lambda_i|
       //--------------------------------------------------------------------------
 
-      // Lambda already contains the square root of the eigenvalue of the norm op.
-      Complex lambda = evals[i];
-
       // M*Rev_i = M*Rsv_i = sigma_i Lsv_i
       mat.Expose()->M(*evecs[n_conv + i], *evecs[i]);
+    }
+
+    // sigma_i = sqrt(sigma_i (Lsv_i)^dag * sigma_i * Lsv_i ), with all the norms in one global reduction
+    ReduceBatch batch;
+    std::vector<ReduceBatch::handle<double>> sigma2_h(n_conv);
+    for (int i = 0; i < n_conv; i++) sigma2_h[i] = batch.add(blas::norm2(*evecs[n_conv + i]));
+    batch.flush();
 
-      // sigma_i = sqrt(sigma_i (Lsv_i)^dag * sigma_i * Lsv_i )
-      sigma_tmp[i] = sqrt(blas::norm2(*evecs[n_conv + i]));
+    for (int i = 0; i < n_conv; i++) {
+      // Lambda already contains the square root of the eigenvalue of the norm op.
+      Complex lambda = evals[i];
+      sigma_tmp[i] = sqrt(batch.get(sigma2_h[i]));
 
       // Normalise the Lsv: sigma_i Lsv_i -> Lsv_i
       blas::ax(1.0 / sigma_tmp[i], *evecs[n_conv + i]);
@@ -701,11 +717,17 @@ namespace quda
     std::vector<ColorSpinorField *> temp;
     temp.push_back(ColorSpinorField::Create(csParamClone));
 
+    // the norms do not depend on the mat-vecs, so reduce them together up front
+    ReduceBatch batch;
+    std::vector<ReduceBatch::handle<double>> norm2_h(size);
+    for (int i = 0; i < size; i++) norm2_h[i] = batch.add(blas::norm2(*evecs[i]));
+    batch.flush();
+
     for (int i = 0; i < size; i++) {
       // r = A * v_i
       matVec(mat, *temp[0], *evecs[i]);
       // lambda_i = v_i^dag A v_i / (v_i^dag * v_i)
-      evals[i] = blas::cDotProduct(*evecs[i], *temp[0]) / sqrt(blas::norm2(*evecs[i]));
+      evals[i] = blas::cDotProduct(*evecs[i], *temp[0]) / sqrt(batch.get(norm2_h[i]));
       // Measure ||lambda_i*v_i - A*v_i||
       Complex n_unit(-1.0, 0.0);
       blas::caxpby(evals[i], *evecs[i], n_unit, *temp[0]);
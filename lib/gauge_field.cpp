@@ -206,30 +206,42 @@ namespace quda {
       }
     }
 
+    const int disp = dir == QUDA_FORWARDS ? +1 : -1;
+
+    // a neighbor on this node reads the links straight out of a send
+    // buffer from comm_shared_malloc, so only remote neighbors need messages
+    void *shm_recv[4] = { };
+    bool shared = false;
+
     for (int i=0; i<nDimComms; i++) {
       if (!comm_dim_partitioned(i)) continue;
-      if (dir == QUDA_FORWARDS) {
-	mh_send[i] = comm_declare_send_relative(send[i], i, +1, bytes[i]);
-	mh_recv[i] = comm_declare_receive_relative(receive[i], i, -1, bytes[i]);
-      } else if (dir == QUDA_BACKWARDS) {
-	mh_send[i] = comm_declare_send_relative(send[i], i, -1, bytes[i]);
-	mh_recv[i] = comm_declare_receive_relative(receive[i], i, +1, bytes[i]);
-      } else {
-	errorQuda("Unsuported dir=%d", dir);
-      }
-
+      if (dir != QUDA_FORWARDS && dir != QUDA_BACKWARDS) errorQuda("Unsuported dir=%d", dir);
+      shared = shared || comm_shared(send[i]);
+      shm_recv[i] = comm_shared_neighbor(send[i], i, -disp);
+      // the neighbor we send to may be remote even when the one we receive from is not
+      bool shm_send = comm_shared_neighbor(send[i], i, +disp) != nullptr;
+      mh_send[i] = shm_send ? nullptr : comm_declare_send_relative(send[i], i, +disp, bytes[i]);
+      mh_recv[i] = shm_recv[i] ? nullptr : comm_declare_receive_relative(receive[i], i, -disp, bytes[i]);
     }
 
     for (int i=0; i<nDimComms; i++) {
       if (!comm_dim_partitioned(i)) continue;
-      comm_start(mh_send[i]);
-      comm_start(mh_recv[i]);
+      if (mh_send[i]) comm_start(mh_send[i]);
+      if (mh_recv[i]) comm_start(mh_recv[i]);
+    }
+
+    if (shared) {
+      comm_shared_barrier(); // the neighbors' links are extracted
+      for (int i=0; i<nDimComms; i++) {
+	if (comm_dim_partitioned(i) && shm_recv[i]) memcpy(receive[i], shm_recv[i], bytes[i]);
+      }
+      comm_shared_barrier(); // our links have been read
     }
 
     for (int i=0; i<nDimComms; i++) {
       if (!comm_dim_partitioned(i)) continue;
-      comm_wait(mh_send[i]);
-      comm_wait(mh_recv[i]);
+      if (mh_send[i]) comm_wait(mh_send[i]);
+      if (mh_recv[i]) comm_wait(mh_recv[i]);
     }
 
     if (Location() == QUDA_CUDA_FIELD_LOCATION) {
@@ -243,8 +255,8 @@ namespace quda {
 
     for (int i=0; i<nDimComms; i++) {
       if (!comm_dim_partitioned(i)) continue;
-      comm_free(mh_send[i]);
-      comm_free(mh_recv[i]);
+      if (mh_send[i]) comm_free(mh_send[i]);
+      if (mh_recv[i]) comm_free(mh_recv[i]);
     }
 
   }
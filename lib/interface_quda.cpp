@@ -705,6 +705,7 @@ void loadGaugeQuda(void *h_gauge, QudaGaugeParam *param)
   // create an extended preconditioning field
   cudaGaugeField* extended = nullptr;
   if (param->overlap){
+    ProfileScope scope("extended");
     int R[4]; // domain-overlap widths in different directions
     for (int i=0; i<4; ++i) R[i] = param->overlap*commDimPartitioned(i);
     extended = createExtendedGauge(*precondition, R, profileGauge);
@@ -751,6 +752,7 @@ void loadGaugeQuda(void *h_gauge, QudaGaugeParam *param)
 
   if (extendedGaugeResident) {
     // updated the resident gauge field if needed
+    ProfileScope scope("extended");
     const int *R_ = extendedGaugeResident->R();
     const int R[] = { R_[0], R_[1], R_[2], R_[3] };
     QudaReconstructType recon = extendedGaugeResident->Reconstruct();
@@ -1401,6 +1403,9 @@ void endQuda(void)
 
     profileInit2End.Print();
     TimeProfile::PrintGlobal();
+#ifdef QUDA_HOST_PROFILE
+    ProfileTree::Print();
+#endif
 
     printLaunchTimer();
     printAPIProfile();
@@ -1410,6 +1415,7 @@ void endQuda(void)
     printfQuda("\n");
   }
 
+  pool::flush_host();
   assertAllMemFree();
 
   device::destroy();
@@ -2224,6 +2230,7 @@ void eigensolveQuda(void **host_evecs, double _Complex *host_evals, QudaEigParam
   profileEigensolve.TPSTOP(QUDA_PROFILE_INIT);
 
   if (!eig_param->use_norm_op && !eig_param->use_dagger) {
+    ProfileScope scope("solve");
     DiracM m(dirac);
     if (eig_param->arpack_check) {
       arpack_solve(host_evecs_, evals, m, eig_param, profileEigensolve);
@@ -2233,6 +2240,7 @@ void eigensolveQuda(void **host_evecs, double _Complex *host_evals, QudaEigParam
       delete eig_solve;
     }
   } else if (!eig_param->use_norm_op && eig_param->use_dagger) {
+    ProfileScope scope("solve");
     DiracMdag m(dirac);
     if (eig_param->arpack_check) {
       arpack_solve(host_evecs_, evals, m, eig_param, profileEigensolve);
@@ -2242,6 +2250,7 @@ void eigensolveQuda(void **host_evecs, double _Complex *host_evals, QudaEigParam
       delete eig_solve;
     }
   } else if (eig_param->use_norm_op && !eig_param->use_dagger) {
+    ProfileScope scope("solve");
     DiracMdagM m(dirac);
     if (eig_param->arpack_check) {
       arpack_solve(host_evecs_, evals, m, eig_param, profileEigensolve);
@@ -2251,6 +2260,7 @@ void eigensolveQuda(void **host_evecs, double _Complex *host_evals, QudaEigParam
       delete eig_solve;
     }
   } else if (eig_param->use_norm_op && eig_param->use_dagger) {
+    ProfileScope scope("solve");
     DiracMMdag m(dirac);
     if (eig_param->arpack_check) {
       arpack_solve(host_evecs_, evals, m, eig_param, profileEigensolve);
@@ -2807,6 +2817,7 @@ void invertQuda(void *hp_x, void *hp_b, QudaInvertParam *param)
   } else if (!mat_solution && direct_solve) { // perform the first of two solves: A^dag y = b
     DiracMdag m(dirac), mSloppy(diracSloppy), mPre(diracPre);
     SolverParam solverParam(*param);
+    ProfileScope scope("solve");
     Solver *solve = Solver::create(solverParam, m, mSloppy, mPre, profileInvert);
     (*solve)(*out, *in);
     blas::copy(*in, *out);
@@ -2857,6 +2868,7 @@ void invertQuda(void *hp_x, void *hp_b, QudaInvertParam *param)
       profileInvert.TPSTOP(QUDA_PROFILE_CHRONO);
     }
 
+    ProfileScope scope("solve");
     Solver *solve = Solver::create(solverParam, m, mSloppy, mPre, profileInvert);
     (*solve)(*out, *in);
     delete solve;
@@ -2908,11 +2920,13 @@ void invertQuda(void *hp_x, void *hp_b, QudaInvertParam *param)
     // if using a Schwarz preconditioner with a normal operator then we must use the DiracMdagMLocal operator
     if (param->inv_type_precondition != QUDA_INVALID_INVERTER && param->schwarz_type != QUDA_INVALID_SCHWARZ) {
       DiracMdagMLocal mPreLocal(diracPre);
+      ProfileScope scope("solve");
       Solver *solve = Solver::create(solverParam, m, mSloppy, mPreLocal, profileInvert);
       (*solve)(*out, *in);
       delete solve;
       solverParam.updateInvertParam(*param);
     } else {
+      ProfileScope scope("solve");
       Solver *solve = Solver::create(solverParam, m, mSloppy, mPre, profileInvert);
       (*solve)(*out, *in);
       delete solve;
@@ -2922,6 +2936,7 @@ void invertQuda(void *hp_x, void *hp_b, QudaInvertParam *param)
     DiracMMdag m(dirac), mSloppy(diracSloppy), mPre(diracPre);
     cudaColorSpinorField tmp(*out);
     SolverParam solverParam(*param);
+    ProfileScope scope("solve");
     Solver *solve = Solver::create(solverParam, m, mSloppy, mPre, profileInvert);
     (*solve)(tmp, *in); // y = (M M^\dag) b
     dirac.Mdag(*out, tmp);  // x = M^dag y
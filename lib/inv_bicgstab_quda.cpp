@@ -8,6 +8,7 @@
 #include <invert_quda.h>
 #include <util_quda.h>
 #include <color_spinor_field.h>
+#include <reduce_batch.h>
 
 namespace quda {
 
@@ -201,8 +202,13 @@ namespace quda {
 
       Complex r0v;
       if (param.pipeline) {
-	r0v = blas::cDotProduct(r0, v);
-	if (k>0) rho = blas::cDotProduct(r0, r);
+	// (r0,v) and (r0,r) are independent so share one global reduction
+	ReduceBatch batch;
+	auto r0v_h = batch.add(blas::cDotProduct(r0, v));
+	auto rho_h = batch.add(k > 0 ? blas::cDotProduct(r0, r) : Complex(0.0));
+	batch.flush();
+	r0v = batch.get(r0v_h);
+	if (k>0) rho = batch.get(rho_h);
       } else {
 	r0v = blas::cDotProduct(r0, v);
       }
@@ -216,13 +222,18 @@ namespace quda {
     
       int updateR = 0;
       if (param.pipeline) {
-	// omega = (t, r) / (t, t)
-	omega_t2 = blas::cDotProductNormA(t, rSloppy);
+	// omega = (t, r) / (t, t), with (r,r) and (r0,t) in the same global reduction
+	ReduceBatch batch;
+	auto omega_t2_h = batch.add(blas::cDotProductNormA(t, rSloppy));
+	auto s2_h = batch.add(blas::norm2(rSloppy));
+	auto r0t_h = batch.add(blas::cDotProduct(r0, t));
+	batch.flush();
+	omega_t2 = batch.get(omega_t2_h);
 	Complex tr = Complex(omega_t2.x, omega_t2.y);
 	double t2 = omega_t2.z;
 	omega = tr / t2;
-	double s2 = blas::norm2(rSloppy);
-	Complex r0t = blas::cDotProduct(r0, t);
+	double s2 = batch.get(s2_h);
+	Complex r0t = batch.get(r0t_h);
 	beta = -r0t / r0v;
 	r2 = s2 - real(omega * conj(tr)) ;
 
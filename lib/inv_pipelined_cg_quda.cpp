@@ -0,0 +1,286 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+
+#include <quda_internal.h>
+#include <color_spinor_field.h>
+#include <blas_quda.h>
+#include <dslash_quda.h>
+#include <invert_quda.h>
+#include <util_quda.h>
+
+/**
+   Pipelined CG following P. Ghysels and W. Vanroose, "Hiding global
+   synchronization latency in the preconditioned Conjugate Gradient
+   algorithm", Parallel Computing 40 (2014).  Alongside the residual r
+   the solver recurs w = A r, s = A p and z = A s, so that both inner
+   products of an iteration, (r,r) and (w,r), are available at its
+   start.  They are computed in one fused local reduction, and the
+   global sum is then left in flight while q = A w is applied.
+*/
+
+namespace quda
+{
+
+  using namespace blas;
+
+  PipelinedCG::PipelinedCG(const DiracMatrix &mat, const DiracMatrix &matSloppy, SolverParam &param,
+                           TimeProfile &profile) :
+    Solver(mat, matSloppy, matSloppy, param, profile)
+  {
+  }
+
+  PipelinedCG::~PipelinedCG() {}
+
+  void PipelinedCG::operator()(ColorSpinorField &x, ColorSpinorField &b)
+  {
+    if (checkLocation(x, b) != QUDA_CUDA_FIELD_LOCATION) errorQuda("Not supported");
+    if (param.residual_type & QUDA_HEAVY_QUARK_RESIDUAL) errorQuda("Heavy-quark residual not supported");
+
+    profile.TPSTART(QUDA_PROFILE_INIT);
+
+    double b2 = blas::norm2(b);
+
+    // Check to see that we're not trying to invert on a zero-field source
+    if (b2 == 0 && param.compute_null_vector == QUDA_COMPUTE_NULL_VECTOR_NO) {
+      profile.TPSTOP(QUDA_PROFILE_INIT);
+      printfQuda("Warning: inverting on zero-field source\n");
+      x = b;
+      param.true_res = 0.0;
+      param.true_res_hq = 0.0;
+      return;
+    }
+
+    ColorSpinorParam csParam(b);
+    csParam.create = QUDA_NULL_FIELD_CREATE;
+    ColorSpinorField *rp = ColorSpinorField::Create(b, csParam);
+    csParam.create = QUDA_ZERO_FIELD_CREATE;
+    ColorSpinorField *yp = ColorSpinorField::Create(b, csParam);
+    ColorSpinorField &r = *rp;
+    ColorSpinorField &y = *yp;
+
+    // high-precision temporary for the reliable updates
+    ColorSpinorField *tmp3p = ColorSpinorField::Create(b, csParam);
+    ColorSpinorField &tmp3 = *tmp3p;
+
+    // compute initial residual
+    double r2 = 0.0;
+    if (param.use_init_guess == QUDA_USE_INIT_GUESS_YES) {
+      // Compute r = b - A * x
+      mat(r, x, y, tmp3);
+      r2 = blas::xmyNorm(b, r);
+      if (b2 == 0) b2 = r2;
+      // y contains the original guess.
+      blas::copy(y, x);
+    } else {
+      blas::copy(r, b);
+      r2 = b2;
+      blas::zero(y);
+    }
+
+    csParam.setPrecision(param.precision_sloppy);
+
+    ColorSpinorField *r_sloppy;
+    if (param.precision_sloppy == x.Precision()) {
+      r_sloppy = &r;
+    } else {
+      csParam.create = QUDA_COPY_FIELD_CREATE;
+      r_sloppy = ColorSpinorField::Create(r, csParam);
+    }
+
+    ColorSpinorField *x_sloppy;
+    if (param.precision_sloppy == x.Precision() || !param.use_sloppy_partial_accumulator) {
+      x_sloppy = &x;
+    } else {
+      csParam.create = QUDA_COPY_FIELD_CREATE;
+      x_sloppy = ColorSpinorField::Create(x, csParam);
+    }
+
+    ColorSpinorField &xSloppy = *x_sloppy;
+    ColorSpinorField &rSloppy = *r_sloppy;
+
+    blas::zero(x);
+    if (&x != &xSloppy) blas::zero(xSloppy);
+
+    // the pipelined recurrences: w = A r, q = A w, p, s = A p and z = A s
+    csParam.create = QUDA_ZERO_FIELD_CREATE;
+    ColorSpinorField *wp = ColorSpinorField::Create(rSloppy, csParam);
+    ColorSpinorField *qp = ColorSpinorField::Create(rSloppy, csParam);
+    ColorSpinorField *pp = ColorSpinorField::Create(rSloppy, csParam);
+    ColorSpinorField *sp = ColorSpinorField::Create(rSloppy, csParam);
+    ColorSpinorField *zp = ColorSpinorField::Create(rSloppy, csParam);
+    ColorSpinorField &w = *wp;
+    ColorSpinorField &q = *qp;
+    ColorSpinorField &p = *pp;
+    ColorSpinorField &s = *sp;
+    ColorSpinorField &z = *zp;
+
+    // temporaries for the sloppy operator
+    ColorSpinorField *tmpp = ColorSpinorField::Create(rSloppy, csParam);
+    ColorSpinorField *tmp2p = !mat.isStaggered() ? ColorSpinorField::Create(rSloppy, csParam) : tmpp;
+    ColorSpinorField &tmp = *tmpp;
+    ColorSpinorField &tmp2 = *tmp2p;
+
+    matSloppy(w, rSloppy, tmp, tmp2);
+
+    profile.TPSTOP(QUDA_PROFILE_INIT);
+    profile.TPSTART(QUDA_PROFILE_PREAMBLE);
+
+    const double stop = stopping(param.tol, b2, param.residual_type); // stopping condition of solver
+    const bool global_reduction = commGlobalReduction();
+
+    double alpha = 0.0, alpha_old = 0.0, beta = 0.0;
+    double r2_old = 0.0;
+    double3 rw; // (r,w) and (r,r), the target of the non-blocking reduction
+
+    double rNorm = sqrt(r2);
+    double r0Norm = rNorm;
+    double maxrx = rNorm;
+    double maxrr = rNorm;
+    const double delta = param.delta;
+
+    const int maxResIncrease = param.max_res_increase; // check if we reached the limit of our tolerance
+    const int maxResIncreaseTotal = param.max_res_increase_total;
+    int resIncrease = 0;
+    int resIncreaseTotal = 0;
+
+    int k = 0;
+    int rUpdate = 0;
+    bool replaced = false; // whether the residual was just replaced by a reliable update
+
+    profile.TPSTOP(QUDA_PROFILE_PREAMBLE);
+    profile.TPSTART(QUDA_PROFILE_COMPUTE);
+    blas::flops = 0;
+
+    while (k < param.maxiter) {
+
+      // fused local reduction, whose global sum is overlapped with q = A w
+      commGlobalReductionSet(false);
+      rw = cDotProductNormA(rSloppy, w);
+      commGlobalReductionSet(global_reduction);
+      ReduceHandle *reduce = reduceDoubleArrayAsync(reinterpret_cast<double *>(&rw), 3);
+      matSloppy(q, w, tmp, tmp2);
+      reduceWait(reduce);
+
+      r2 = rw.z;
+      PrintStats("PipelinedCG", k, r2, b2, 0.0);
+      if (convergence(r2, 0.0, stop, param.tol_hq) && (replaced || delta < param.tol)) break;
+
+      rNorm = sqrt(r2);
+      if (rNorm > maxrx) maxrx = rNorm;
+      if (rNorm > maxrr) maxrr = rNorm;
+
+      int updateX = (rNorm < delta * r0Norm && r0Norm <= maxrx) ? 1 : 0;
+      int updateR = ((rNorm < delta * maxrr && r0Norm <= maxrr) || updateX) ? 1 : 0;
+
+      // force a reliable update if we are within target tolerance (only if doing reliable updates)
+      if (convergence(r2, 0.0, stop, param.tol_hq) && delta >= param.tol) updateX = 1;
+
+      if (!replaced && (updateR || updateX)) {
+        // residual replacement: recompute r in high precision, and
+        // the recurred products s = A p and z = A s; w and q are
+        // recomputed at the top of the loop along with the reduction
+        xpy(xSloppy, y);
+        mat(r, y, x, tmp3); // x is just a temporary here
+        r2 = xmyNorm(b, r);
+        if (&rSloppy != &r) copy(rSloppy, r);
+        zero(xSloppy);
+
+        // break-out check if we have reached the limit of the precision
+        if (sqrt(r2) > r0Norm && updateX) {
+          resIncrease++;
+          resIncreaseTotal++;
+          warningQuda("PipelinedCG: new reliable residual norm %e is greater than previous reliable residual norm %e "
+                      "(total #inc %i)",
+                      sqrt(r2), r0Norm, resIncreaseTotal);
+          if (resIncrease > maxResIncrease or resIncreaseTotal > maxResIncreaseTotal) break;
+        } else {
+          resIncrease = 0;
+        }
+
+        rNorm = sqrt(r2);
+        maxrr = rNorm;
+        maxrx = rNorm;
+        r0Norm = rNorm;
+        ++rUpdate;
+
+        matSloppy(w, rSloppy, tmp, tmp2);
+        matSloppy(s, p, tmp, tmp2);
+        matSloppy(z, s, tmp, tmp2);
+        replaced = true;
+        continue;
+      }
+
+      beta = k > 0 ? r2 / r2_old : 0.0;
+      xpay(q, beta, z);       // z = q + beta * z
+      xpay(w, beta, s);       // s = w + beta * s
+      xpay(rSloppy, beta, p); // p = r + beta * p
+
+      if (k == 0) {
+        alpha = r2 / rw.x;
+      } else if (replaced) {
+        // the recurrence for (p,Ap) assumes unperturbed residuals, so take it directly
+        alpha = r2 / reDotProduct(p, s);
+      } else {
+        alpha = r2 / (rw.x - beta * r2 / alpha_old);
+      }
+
+      axpy(alpha, p, xSloppy); // x += alpha * p
+      axpy(-alpha, s, rSloppy); // r -= alpha * s
+      axpy(-alpha, z, w);       // w -= alpha * z
+
+      r2_old = r2;
+      alpha_old = alpha;
+      replaced = false;
+      k++;
+    }
+
+    if (&x != &xSloppy) copy(x, xSloppy);
+    xpy(y, x); // x += y
+
+    profile.TPSTOP(QUDA_PROFILE_COMPUTE);
+    profile.TPSTART(QUDA_PROFILE_EPILOGUE);
+
+    param.secs = profile.Last(QUDA_PROFILE_COMPUTE);
+    double gflops = (blas::flops + mat.flops() + matSloppy.flops()) * 1e-9;
+    param.gflops = gflops;
+    param.iter += k;
+
+    if (k == param.maxiter) warningQuda("Exceeded maximum iterations %d", param.maxiter);
+
+    if (getVerbosity() >= QUDA_VERBOSE) printfQuda("PipelinedCG: Reliable updates = %d\n", rUpdate);
+
+    if (param.compute_true_res) {
+      // compute the true residual
+      mat(r, x, y, tmp3);
+      param.true_res = sqrt(xmyNorm(b, r) / b2);
+      param.true_res_hq = 0.0;
+    }
+
+    PrintSummary("PipelinedCG", k, r2, b2, stop, param.tol_hq);
+
+    // reset the flops counters
+    blas::flops = 0;
+    mat.flops();
+    matSloppy.flops();
+
+    profile.TPSTOP(QUDA_PROFILE_EPILOGUE);
+    profile.TPSTART(QUDA_PROFILE_FREE);
+
+    if (tmp2p != tmpp) delete tmp2p;
+    delete tmpp;
+    delete zp;
+    delete sp;
+    delete pp;
+    delete qp;
+    delete wp;
+    if (&xSloppy != &x) delete x_sloppy;
+    if (&rSloppy != &r) delete r_sloppy;
+    delete tmp3p;
+    delete yp;
+    delete rp;
+
+    profile.TPSTOP(QUDA_PROFILE_FREE);
+  }
+
+} // namespace quda
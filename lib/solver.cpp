@@ -104,6 +104,10 @@ namespace quda {
       report("PCG");
       solver = new PreconCG(mat, matSloppy, matPrecon, param, profile);
       break;
+    case QUDA_PIPELINED_CG_INVERTER:
+      report("PIPELINED CG");
+      solver = new PipelinedCG(mat, matSloppy, param, profile);
+      break;
     case QUDA_MPCG_INVERTER:
       report("MPCG");
       solver = new MPCG(mat, param, profile);
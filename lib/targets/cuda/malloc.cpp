@@ -2,8 +2,17 @@
 #include <cstdio>
 #include <string>
 #include <map>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+#include <vector>
 #include <unistd.h>   // for getpagesize()
 #include <execinfo.h> // for backtrace
+#ifdef __APPLE__
+#include <malloc/malloc.h> // for malloc_size
+#else
+#include <malloc.h> // for malloc_usable_size
+#endif
 #include <quda_internal.h>
 
 #ifdef USE_QDPJIT
@@ -23,8 +32,8 @@ namespace quda
   {
 
   public:
-    std::string func;
-    std::string file;
+    const char *func; // the allocation macros pass __func__ and __FILE__, so these are never freed
+    const char *file;
     int line;
     size_t size;
     size_t base_size;
@@ -32,37 +41,81 @@ namespace quda
     backward::StackTrace st;
 #endif
 
-    MemAlloc() : line(-1), size(0), base_size(0) {}
+    MemAlloc() : func(""), file(""), line(-1), size(0), base_size(0) {}
 
-    MemAlloc(std::string func, std::string file, int line) : func(func), file(file), line(line), size(0), base_size(0)
+    MemAlloc(const char *func, const char *file, int line) : func(func), file(file), line(line), size(0), base_size(0)
     {
-#ifdef QUDA_BACKWARDSCPP
-      st.load_here(32);
-      st.skip_n_firsts(1);
-#endif
     }
 
-    MemAlloc &operator=(const MemAlloc &a)
+    /**
+       @brief Record the call stack of the allocation.  This is only
+       done for the allocations whose record is kept, since unwinding
+       the stack is the most expensive part of the tracking.
+     */
+    void load_stack()
     {
-      if (&a != this) {
-        func = a.func;
-        file = a.file;
-        line = a.line;
-        size = a.size;
-        base_size = a.base_size;
 #ifdef QUDA_BACKWARDSCPP
-        st = a.st;
+      st.load_here(32);
+      st.skip_n_firsts(2);
 #endif
-      }
-      return *this;
     }
   };
 
-  static std::map<void *, MemAlloc> alloc[N_ALLOC_TYPE];
-  static long total_bytes[N_ALLOC_TYPE] = {0};
-  static long max_total_bytes[N_ALLOC_TYPE] = {0};
-  static long total_host_bytes, max_total_host_bytes;
-  static long total_pinned_bytes, max_total_pinned_bytes;
+  /**
+     The allocation tracking has three tiers, selected with the
+     environment variable QUDA_MEMORY_TRACKING:
+     - full (default): every allocation is recorded with its call
+       site, so that leaks and invalid frees are reported exactly
+     - counters: only the per-type totals and peaks are kept, which
+       are lock-free atomics; device and page-locked allocations still
+       keep their size so that they can be freed, while the size of
+       host allocations is taken from the C library
+     - sampled: as counters, but every Nth allocation is also
+       recorded in full, where N is set by QUDA_MEMORY_TRACKING_SAMPLE
+       (default 64)
+     In the counters and sampled tiers invalid frees of safe_malloc
+     memory are not detected and leaks are only reported as totals.
+   */
+  enum class TrackMode { FULL, COUNTERS, SAMPLED };
+
+  static TrackMode track_mode_init()
+  {
+    char *mode = getenv("QUDA_MEMORY_TRACKING");
+    if (!mode || strcmp(mode, "full") == 0) return TrackMode::FULL;
+    if (strcmp(mode, "counters") == 0) return TrackMode::COUNTERS;
+    if (strcmp(mode, "sampled") == 0) return TrackMode::SAMPLED;
+    errorQuda("Unknown QUDA_MEMORY_TRACKING=%s, expected full, counters or sampled", mode);
+    return TrackMode::FULL;
+  }
+
+  static TrackMode track_mode()
+  {
+    static const TrackMode mode = track_mode_init();
+    return mode;
+  }
+
+  static unsigned long track_sample_init()
+  {
+    char *sample = getenv("QUDA_MEMORY_TRACKING_SAMPLE");
+    long n = sample ? atol(sample) : 64;
+    if (n < 1) errorQuda("Invalid QUDA_MEMORY_TRACKING_SAMPLE=%s", sample);
+    return n;
+  }
+
+  static unsigned long track_sample()
+  {
+    static const unsigned long sample = track_sample_init();
+    return sample;
+  }
+
+  static std::map<void *, MemAlloc> alloc[N_ALLOC_TYPE];                // allocation records
+  static std::unordered_map<void *, size_t> alloc_size[N_ALLOC_TYPE]; // sizes, when not all allocations are recorded
+  static std::atomic<long> total_bytes[N_ALLOC_TYPE];
+  static std::atomic<long> max_total_bytes[N_ALLOC_TYPE];
+  static std::atomic<long> total_count[N_ALLOC_TYPE]; // number of live allocations
+  static std::atomic<long> total_host_bytes, max_total_host_bytes;
+  static std::atomic<long> total_pinned_bytes, max_total_pinned_bytes;
+  static std::atomic<unsigned long> sample_count;
 
   long device_allocated_peak() { return max_total_bytes[DEVICE]; }
 
@@ -86,6 +139,8 @@ namespace quda
     free(strings);
   }
 
+  static const char *type_str[] = {"Device", "Device Pinned", "Host  ", "Pinned", "Mapped", "Managed"};
+
   static void print_alloc_header()
   {
     printfQuda("Type    Pointer          Size             Location\n");
@@ -94,14 +149,13 @@ namespace quda
 
   static void print_alloc(AllocType type)
   {
-    const char *type_str[] = {"Device", "Device Pinned", "Host  ", "Pinned", "Mapped", "Managed"};
     std::map<void *, MemAlloc>::iterator entry;
 
     for (entry = alloc[type].begin(); entry != alloc[type].end(); entry++) {
       void *ptr = entry->first;
       MemAlloc a = entry->second;
-      printfQuda("%s  %15p  %15lu  %s(), %s:%d\n", type_str[type], ptr, (unsigned long)a.base_size, a.func.c_str(),
-                 a.file.c_str(), a.line);
+      printfQuda("%s  %15p  %15lu  %s(), %s:%d\n", type_str[type], ptr, (unsigned long)a.base_size, a.func, a.file,
+                 a.line);
 #ifdef QUDA_BACKWARDSCPP
       if (getRankVerbosity()) {
         backward::Printer p;
@@ -111,30 +165,225 @@ namespace quda
     }
   }
 
-  static void track_malloc(const AllocType &type, const MemAlloc &a, void *ptr)
+  // guards the allocation records, since host allocations may be made from multiple threads
+  static std::mutex track_mutex;
+
+  /**
+     @brief Size of a host allocation as reported by the C library,
+     used in place of a record when not every allocation is recorded.
+     This is at least the requested size, and is the same at
+     allocation and free, which is all the counters need.
+   */
+  static size_t host_usable_size(void *ptr)
+  {
+#ifdef __APPLE__
+    return malloc_size(ptr);
+#else
+    return malloc_usable_size(ptr);
+#endif
+  }
+
+  static void update_peak(std::atomic<long> &peak, long value)
   {
-    total_bytes[type] += a.base_size;
-    if (total_bytes[type] > max_total_bytes[type]) { max_total_bytes[type] = total_bytes[type]; }
-    if (type != DEVICE && type != DEVICE_PINNED) {
-      total_host_bytes += a.base_size;
-      if (total_host_bytes > max_total_host_bytes) { max_total_host_bytes = total_host_bytes; }
-    }
-    if (type == PINNED || type == MAPPED) {
-      total_pinned_bytes += a.base_size;
-      if (total_pinned_bytes > max_total_pinned_bytes) { max_total_pinned_bytes = total_pinned_bytes; }
-    }
-    alloc[type][ptr] = a;
+    long old = peak.load(std::memory_order_relaxed);
+    while (value > old && !peak.compare_exchange_weak(old, value, std::memory_order_relaxed)) { }
   }
 
-  static void track_free(const AllocType &type, void *ptr)
+  static void count_malloc(const AllocType &type, long size)
   {
-    size_t size = alloc[type][ptr].base_size;
+    total_count[type]++;
+    update_peak(max_total_bytes[type], total_bytes[type] += size);
+    if (type != DEVICE && type != DEVICE_PINNED) { update_peak(max_total_host_bytes, total_host_bytes += size); }
+    if (type == PINNED || type == MAPPED) { update_peak(max_total_pinned_bytes, total_pinned_bytes += size); }
+  }
+
+  static void count_free(const AllocType &type, long size)
+  {
+    total_count[type]--;
     total_bytes[type] -= size;
     if (type != DEVICE && type != DEVICE_PINNED) { total_host_bytes -= size; }
     if (type == PINNED || type == MAPPED) { total_pinned_bytes -= size; }
-    alloc[type].erase(ptr);
+  }
+
+  static void track_malloc(const AllocType &type, MemAlloc &a, void *ptr)
+  {
+    const TrackMode mode = track_mode();
+    if (mode == TrackMode::FULL) {
+      count_malloc(type, a.base_size);
+      a.load_stack();
+      std::lock_guard<std::mutex> lock(track_mutex);
+      alloc[type][ptr] = a;
+      return;
+    }
+
+    const size_t size = type == HOST ? host_usable_size(ptr) : a.base_size;
+    count_malloc(type, size);
+    const bool sample = mode == TrackMode::SAMPLED && sample_count++ % track_sample() == 0;
+    if (sample) a.load_stack();
+    if (type != HOST || sample) {
+      std::lock_guard<std::mutex> lock(track_mutex);
+      if (type != HOST) alloc_size[type][ptr] = size;
+      if (sample) alloc[type][ptr] = a;
+    }
+  }
+
+  /**
+   * @return the size of the tracked allocation, which is then
+   * untracked.  For host allocations in the counters and sampled
+   * tiers this is the usable size reported by the C library.
+   */
+  static size_t track_free(const AllocType &type, void *ptr)
+  {
+    const TrackMode mode = track_mode();
+    size_t size;
+    if (mode == TrackMode::FULL) {
+      std::lock_guard<std::mutex> lock(track_mutex);
+      auto it = alloc[type].find(ptr);
+      size = it != alloc[type].end() ? it->second.base_size : 0;
+      if (it != alloc[type].end()) alloc[type].erase(it);
+    } else if (type == HOST) {
+      size = host_usable_size(ptr);
+      if (mode == TrackMode::SAMPLED) {
+        std::lock_guard<std::mutex> lock(track_mutex);
+        alloc[type].erase(ptr);
+      }
+    } else {
+      std::lock_guard<std::mutex> lock(track_mutex);
+      auto it = alloc_size[type].find(ptr);
+      size = it != alloc_size[type].end() ? it->second : 0;
+      if (it != alloc_size[type].end()) alloc_size[type].erase(it);
+      alloc[type].erase(ptr);
+    }
+    count_free(type, size);
+    return size;
   }
 
+  /**
+     @brief Whether ptr is a live allocation of the given type.  Host
+     allocations can only be checked when every allocation is
+     recorded, otherwise any pointer is taken to be valid.
+   */
+  static bool is_tracked(const AllocType &type, void *ptr)
+  {
+    const TrackMode mode = track_mode();
+    if (mode != TrackMode::FULL && type == HOST) return true;
+    std::lock_guard<std::mutex> lock(track_mutex);
+    return mode == TrackMode::FULL ? alloc[type].count(ptr) > 0 : alloc_size[type].count(ptr) > 0;
+  }
+
+  namespace pool
+  {
+
+    /**
+       Whether to use a size-class pool allocator for host memory.
+       This is read on first use rather than in init(), since host
+       allocations are made before initQuda, and every block must
+       come from the pool for its class to be recovered on free.
+     */
+    static bool host_memory_pool()
+    {
+      static const bool enabled = [] {
+        char *enable_host_pool = getenv("QUDA_ENABLE_HOST_MEMORY_POOL");
+        return !enable_host_pool || strcmp(enable_host_pool, "0") != 0;
+      }();
+      return enabled;
+    }
+
+    /** Host allocations are rounded up to size classes, four per
+        power of two from 256 bytes (256, 320, 384, 448, 512, 640,
+        ...), so at most a fifth of an allocation is wasted. */
+    static const int host_class_min_log2 = 8;
+    static const int n_host_class = 4 * (64 - host_class_min_log2);
+
+    static int host_size_class(size_t size)
+    {
+      if (size <= (1ul << host_class_min_log2)) return 0;
+      int k = 63 - __builtin_clzl(size - 1); // size is in (2^k, 2^(k+1)]
+      size_t step = 1ul << (k - 2);
+      int m = (size - (1ul << k) + step - 1) / step; // 1..4
+      return 4 * (k - host_class_min_log2) + m;
+    }
+
+    static size_t host_class_size(int c)
+    {
+      if (c == 0) return 1ul << host_class_min_log2;
+      int k = host_class_min_log2 + (c - 1) / 4;
+      return (1ul << k) + ((c - 1) % 4 + 1) * (1ul << (k - 2));
+    }
+
+    /** Cache of inactive host-memory allocations, one stack per size
+        class so that the most recently freed (and so most likely
+        still resident) block is reused first. */
+    static std::vector<void *> hostCache[n_host_class];
+    static std::mutex host_mutex;
+    static size_t host_cached_bytes = 0; // bytes held in hostCache
+    static size_t host_active_bytes = 0; // bytes handed out from the pool
+    static size_t host_peak_bytes = 0;   // high-water mark of active plus cached bytes
+    static size_t host_active_peak = 0;  // high-water mark of active bytes, the limit on the cache
+
+    /**
+       @brief Return a block of at least size bytes from the host pool
+       @param[in,out] size Requested size, rounded up to the size of the block
+     */
+    static void *host_pool_malloc(size_t &size)
+    {
+      const int c = host_size_class(size);
+      size = host_class_size(c);
+
+      void *ptr = nullptr;
+      {
+        std::lock_guard<std::mutex> lock(host_mutex);
+        if (!hostCache[c].empty()) {
+          ptr = hostCache[c].back();
+          hostCache[c].pop_back();
+          host_cached_bytes -= size;
+        }
+        host_active_bytes += size;
+        host_active_peak = std::max(host_active_peak, host_active_bytes);
+        host_peak_bytes = std::max(host_peak_bytes, host_active_bytes + host_cached_bytes);
+      }
+
+      if (!ptr) ptr = malloc(size);
+      return ptr;
+    }
+
+    /**
+       @brief Return a block to the host pool.  The size may be the
+       usable size reported by the C library, which can exceed the
+       class size, so the block goes to the largest class that fits.
+       The cache is kept no larger than the peak active usage by
+       evicting the largest blocks of other classes, so that a change
+       in the allocation pattern does not leave stale blocks pinning
+       memory.
+     */
+    static void host_pool_free(void *ptr, size_t size)
+    {
+      int c = host_size_class(size);
+      if (host_class_size(c) > size) c--;
+      size = host_class_size(c);
+
+      std::lock_guard<std::mutex> lock(host_mutex);
+      host_active_bytes -= size;
+      hostCache[c].push_back(ptr);
+      host_cached_bytes += size;
+
+      for (int e = n_host_class - 1; e >= 0 && host_cached_bytes > host_active_peak; e--) {
+        if (e == c) continue;
+        while (!hostCache[e].empty() && host_cached_bytes > host_active_peak) {
+          free(hostCache[e].back());
+          hostCache[e].pop_back();
+          host_cached_bytes -= host_class_size(e);
+        }
+      }
+      if (host_cached_bytes > host_active_peak) { // only blocks of this class left
+        free(hostCache[c].back());
+        hostCache[c].pop_back();
+        host_cached_bytes -= size;
+      }
+    }
+
+  } // namespace pool
+
   /**
    * Under CUDA 4.0, cudaHostRegister seems to require that both the
    * beginning and end of the buffer be aligned on page boundaries.
@@ -158,8 +407,7 @@ namespace quda
     int align = posix_memalign(&ptr, page_size, a.base_size);
     if (!ptr || align != 0) {
 #endif
-      errorQuda("Failed to allocate aligned host memory of size %zu (%s:%d in %s())\n", size, a.file.c_str(), a.line,
-                a.func.c_str());
+      errorQuda("Failed to allocate aligned host memory of size %zu (%s:%d in %s())\n", size, a.file, a.line, a.func);
     }
     return ptr;
   }
@@ -271,7 +519,7 @@ namespace quda
     MemAlloc a(func, file, line);
     a.size = a.base_size = size;
 
-    void *ptr = malloc(size);
+    void *ptr = pool::host_memory_pool() ? pool::host_pool_malloc(a.base_size) : malloc(size);
     if (!ptr) { errorQuda("Failed to allocate host memory of size %zu (%s:%d in %s())\n", size, file, line, func); }
     track_malloc(HOST, a, ptr);
 #ifdef HOST_DEBUG
@@ -374,7 +622,7 @@ namespace quda
 
 #ifndef QDP_USE_CUDA_MANAGED_MEMORY
     if (!ptr) { errorQuda("Attempt to free NULL device pointer (%s:%d in %s())\n", file, line, func); }
-    if (!alloc[DEVICE].count(ptr)) {
+    if (!is_tracked(DEVICE, ptr)) {
       errorQuda("Attempt to free invalid device pointer (%s:%d in %s())\n", file, line, func);
     }
     cudaError_t err = cudaFree(ptr);
@@ -398,7 +646,7 @@ namespace quda
     }
 
     if (!ptr) { errorQuda("Attempt to free NULL device pointer (%s:%d in %s())\n", file, line, func); }
-    if (!alloc[DEVICE_PINNED].count(ptr)) {
+    if (!is_tracked(DEVICE_PINNED, ptr)) {
       errorQuda("Attempt to free invalid device pointer (%s:%d in %s())\n", file, line, func);
     }
     CUresult err = cuMemFree((CUdeviceptr)ptr);
@@ -414,7 +662,7 @@ namespace quda
   void managed_free_(const char *func, const char *file, int line, void *ptr)
   {
     if (!ptr) { errorQuda("Attempt to free NULL managed pointer (%s:%d in %s())\n", file, line, func); }
-    if (!alloc[MANAGED].count(ptr)) {
+    if (!is_tracked(MANAGED, ptr)) {
       errorQuda("Attempt to free invalid managed pointer (%s:%d in %s())\n", file, line, func);
     }
     cudaError_t err = cudaFree(ptr);
@@ -430,15 +678,14 @@ namespace quda
   void host_free_(const char *func, const char *file, int line, void *ptr)
   {
     if (!ptr) { errorQuda("Attempt to free NULL host pointer (%s:%d in %s())\n", file, line, func); }
-    if (alloc[HOST].count(ptr)) {
-      track_free(HOST, ptr);
-      free(ptr);
-    } else if (alloc[PINNED].count(ptr)) {
+    // page-locked allocations are checked first, since host allocations are
+    // only recorded individually in the full tracking tier
+    if (is_tracked(PINNED, ptr)) {
       cudaError_t err = cudaHostUnregister(ptr);
       if (err != cudaSuccess) { errorQuda("Failed to unregister pinned memory (%s:%d in %s())\n", file, line, func); }
       track_free(PINNED, ptr);
       free(ptr);
-    } else if (alloc[MAPPED].count(ptr)) {
+    } else if (is_tracked(MAPPED, ptr)) {
 #ifdef HOST_ALLOC
       cudaError_t err = cudaFreeHost(ptr);
       if (err != cudaSuccess) { errorQuda("Failed to free host memory (%s:%d in %s())\n", file, line, func); }
@@ -450,6 +697,12 @@ namespace quda
       free(ptr);
 #endif
       track_free(MAPPED, ptr);
+    } else if (is_tracked(HOST, ptr)) {
+      size_t size = track_free(HOST, ptr);
+      if (pool::host_memory_pool())
+        pool::host_pool_free(ptr, size);
+      else
+        free(ptr);
     } else {
       printfQuda("ERROR: Attempt to free invalid host pointer (%s:%d in %s())\n", file, line, func);
       print_trace();
@@ -464,22 +717,35 @@ namespace quda
     printfQuda("Managed memory used = %.1f MB\n", max_total_bytes[MANAGED] / (double)(1 << 20));
     printfQuda("Page-locked host memory used = %.1f MB\n", max_total_pinned_bytes / (double)(1 << 20));
     printfQuda("Total host memory used >= %.1f MB\n", max_total_host_bytes / (double)(1 << 20));
+    if (pool::host_memory_pool())
+      printfQuda("Host memory pool high-water mark = %.1f MB\n", pool::host_pool_peak() / (double)(1 << 20));
   }
 
   void assertAllMemFree()
   {
-    if (!alloc[DEVICE].empty() || !alloc[DEVICE_PINNED].empty() || !alloc[HOST].empty() || !alloc[PINNED].empty()
-        || !alloc[MAPPED].empty()) {
+    const AllocType types[] = {DEVICE, DEVICE_PINNED, HOST, PINNED, MAPPED};
+    bool leak = false;
+    for (auto type : types) leak = leak || total_count[type] != 0;
+    if (!leak) return;
+
+    if (track_mode() == TrackMode::FULL) {
       warningQuda("The following internal memory allocations were not freed.");
-      printfQuda("\n");
-      print_alloc_header();
-      print_alloc(DEVICE);
-      print_alloc(DEVICE_PINNED);
-      print_alloc(HOST);
-      print_alloc(PINNED);
-      print_alloc(MAPPED);
-      printfQuda("\n");
+    } else {
+      warningQuda("The following internal memory allocations were not freed (see QUDA_MEMORY_TRACKING).");
+      for (auto type : types) {
+        if (total_count[type] != 0)
+          printfQuda("%s  %ld allocations, %ld bytes\n", type_str[type], total_count[type].load(),
+                     total_bytes[type].load());
+      }
+      bool sampled = false;
+      for (auto type : types) sampled = sampled || !alloc[type].empty();
+      if (!sampled) return;
+      printfQuda("Of which the following were sampled:\n");
     }
+    printfQuda("\n");
+    print_alloc_header();
+    for (auto type : types) print_alloc(type);
+    printfQuda("\n");
   }
 
   QudaFieldLocation get_pointer_location(const void *ptr)
@@ -571,6 +837,13 @@ namespace quda
           warningQuda("Not using pinned memory pool allocator");
           pinned_memory_pool = false;
         }
+
+        // host memory pool
+        if (host_memory_pool()) {
+          warningQuda("Using host memory pool allocator");
+        } else {
+          warningQuda("Not using host memory pool allocator");
+        }
         pool_init = true;
       }
     }
@@ -679,6 +952,27 @@ namespace quda
       }
     }
 
+    void trim_host(size_t bytes)
+    {
+      std::lock_guard<std::mutex> lock(host_mutex);
+      // free the largest blocks first
+      for (int c = n_host_class - 1; c >= 0 && host_cached_bytes > bytes; c--) {
+        while (!hostCache[c].empty() && host_cached_bytes > bytes) {
+          free(hostCache[c].back());
+          hostCache[c].pop_back();
+          host_cached_bytes -= host_class_size(c);
+        }
+      }
+    }
+
+    void flush_host() { trim_host(0); }
+
+    size_t host_pool_peak()
+    {
+      std::lock_guard<std::mutex> lock(host_mutex);
+      return host_peak_bytes;
+    }
+
   } // namespace pool
 
 } // namespace quda
@@ -2,19 +2,28 @@
 #include <comm_quda.h>
 #include <quda.h>     // for QUDA_VERSION_STRING
 #include <sys/stat.h> // for stat()
+#include <sys/mman.h> // for mmap()
 #include <fcntl.h>
+#include <sys/file.h> // for flock()
+#include <cerrno>
+#include <cstdint>
 #include <cfloat> // for FLT_MAX
+#include <cmath>
 #include <ctime>
 #include <fstream>
 #include <typeinfo>
 #include <map>
+#include <unordered_map>
 #include <list>
+#include <vector>
 #include <unistd.h>
 #include <uint_to_char.h>
 
+#include <algorithm>
 #include <deque>
 #include <queue>
 #include <functional>
+#include <numeric>
 
 //#define LAUNCH_TIMER
 extern char *gitversion;
@@ -41,6 +50,8 @@ namespace quda
     long mapped_bytes;
     long host_bytes;
 
+    Timer::clock::time_point timestamp; // when the entry was recorded
+
     TraceKey() {}
 
     TraceKey(const TuneKey &key, float time) :
@@ -51,6 +62,7 @@ namespace quda
       mapped_bytes(mapped_allocated_peak()),
       host_bytes(host_allocated_peak())
     {
+      timestamp = Timer::clock::now();
     }
 
     TraceKey(const TraceKey &trace) :
@@ -59,7 +71,8 @@ namespace quda
       device_bytes(trace.device_bytes),
       pinned_bytes(trace.pinned_bytes),
       mapped_bytes(trace.mapped_bytes),
-      host_bytes(trace.host_bytes)
+      host_bytes(trace.host_bytes),
+      timestamp(trace.timestamp)
     {
     }
 
@@ -72,6 +85,7 @@ namespace quda
         pinned_bytes = trace.pinned_bytes;
         mapped_bytes = trace.mapped_bytes;
         host_bytes = trace.host_bytes;
+        timestamp = trace.timestamp;
       }
       return *this;
     }
@@ -119,8 +133,108 @@ namespace quda
   static const std::string quda_hash = QUDA_HASH; // defined in lib/Makefile
   static std::string resource_path;
   static map tunecache;
-  static map::iterator it;
-  static size_t initial_cache_size = 0;
+  static bool version_check = true;
+
+  /**
+     Open-addressing hash index into the tunecache, used for the
+     lookup on every tuneLaunch.  The std::map owns the entries and
+     its ordering is kept for deterministic serialization; since map
+     nodes are stable under insertion, the index only needs updating
+     when a new key is added.  Slots are probed linearly on the
+     precomputed TuneKey hash, and the full key is only compared when
+     the hashes match.
+   */
+  class TuneCacheIndex
+  {
+    struct Slot {
+      uint64_t hash;
+      map::value_type *entry;
+    };
+
+    std::vector<Slot> slots;
+    size_t count = 0;
+
+    void place(map::value_type *entry)
+    {
+      const size_t mask = slots.size() - 1;
+      for (size_t i = entry->first.hash & mask;; i = (i + 1) & mask) {
+        if (!slots[i].entry) {
+          slots[i] = {entry->first.hash, entry};
+          return;
+        }
+      }
+    }
+
+    void grow()
+    {
+      std::vector<Slot> old(slots.empty() ? 1024 : 2 * slots.size(), Slot {0, nullptr});
+      std::swap(old, slots);
+      for (auto &slot : old)
+        if (slot.entry) place(slot.entry);
+    }
+
+  public:
+    /**
+       @brief Return the cached parameters for key, or nullptr if the
+       key is not in the tunecache
+     */
+    TuneParam *find(const TuneKey &key) const
+    {
+      if (slots.empty()) return nullptr;
+      const size_t mask = slots.size() - 1;
+      for (size_t i = key.hash & mask; slots[i].entry; i = (i + 1) & mask) {
+        if (slots[i].hash == key.hash && slots[i].entry->first == key) return &slots[i].entry->second;
+      }
+      return nullptr;
+    }
+
+    /**
+       @brief Index a newly inserted tunecache entry
+     */
+    void insert(map::iterator entry)
+    {
+      if (2 * (count + 1) > slots.size()) grow(); // keep the load factor below 1/2
+      place(&*entry);
+      count++;
+    }
+  };
+
+  static TuneCacheIndex tunecache_index;
+
+  /**
+     @brief Hash of the name and aux strings of a key, i.e., of
+     everything but the volume.  Used to find entries for the same
+     kernel at other volumes when warm starting.
+   */
+  static uint64_t nameAuxHash(const TuneKey &key)
+  {
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (const char *s : {key.name, key.aux}) {
+      do {
+        h = (h ^ static_cast<unsigned char>(*s)) * 0x100000001b3ull;
+      } while (*s++);
+    }
+    return h;
+  }
+
+  // tunecache entries grouped by name and aux, in insertion order
+  static std::unordered_map<uint64_t, std::vector<const map::value_type *>> volume_index;
+
+  /**
+     @brief Insert or overwrite a tunecache entry, keeping the indices
+     up to date
+   */
+  static map::value_type &setTuneCache(const TuneKey &key, const TuneParam &param)
+  {
+    auto entry = tunecache.insert(map::value_type(key, param));
+    if (entry.second) {
+      tunecache_index.insert(entry.first);
+      volume_index[nameAuxHash(key)].push_back(&*entry.first);
+    } else {
+      entry.first->second = param;
+    }
+    return *entry.first;
+  }
 
 #define STR_(x) #x
 #define STR(x) STR_(x)
@@ -139,6 +253,11 @@ namespace quda
   void disableProfileCount() { profile_count = false; }
   void enableProfileCount() { profile_count = true; }
 
+  // how launch parameters were obtained, reported in the profile
+  static long tune_hits = 0;
+  static long tune_seeded = 0;
+  static long tune_full = 0;
+
   const map &getTuneCache() { return tunecache; }
 
   /**
@@ -170,25 +289,24 @@ namespace quda
       if (check < 0 || check >= key.name_n) errorQuda("Error writing name string (check=%d)", check);
       check = snprintf(key.aux, key.aux_n, "%s", a.c_str());
       if (check < 0 || check >= key.aux_n) errorQuda("Error writing aux string (check=%d)", check);
+      key.rehash();
       ls >> param.grid.x >> param.grid.y >> param.grid.z >> param.shared_bytes >> param.aux.x >> param.aux.y
         >> param.aux.z >> param.aux.w >> param.time;
       ls.ignore(1);               // throw away tab before comment
       getline(ls, param.comment); // assume anything remaining on the line is a comment
       param.comment += "\n";      // our convention is to include the newline, since ctime() likes to do this
-      tunecache[key] = param;
+      setTuneCache(key, param);
     }
   }
 
   /**
    * Serialize tunecache to an ostream, useful for writing to a file or sending to other nodes.
    */
-  static void serializeTuneCache(std::ostream &out)
+  static void serializeTuneCache(std::ostream &out, const map &cache = tunecache)
   {
-    map::iterator entry;
-
-    for (entry = tunecache.begin(); entry != tunecache.end(); entry++) {
-      TuneKey key = entry->first;
-      TuneParam param = entry->second;
+    for (auto entry = cache.begin(); entry != cache.end(); entry++) {
+      const TuneKey &key = entry->first;
+      const TuneParam &param = entry->second;
 
       out << std::setw(16) << key.volume << "\t" << key.name << "\t" << key.aux << "\t";
       out << param.block.x << "\t" << param.block.y << "\t" << param.block.z << "\t";
@@ -199,6 +317,415 @@ namespace quda
     }
   }
 
+  /**
+     @brief Version string of this build that is recorded in, and
+     checked against, the tunecache files
+   */
+  static const char *buildVersion()
+  {
+#ifdef GITVERSION
+    return gitversion;
+#else
+    return quda_version.c_str();
+#endif
+  }
+
+  /**
+   * Write the human-readable tunecache, header and all, to an ostream.
+   */
+  static void writeTuneCacheTSV(std::ostream &out, const map &cache)
+  {
+    time_t now;
+    time(&now);
+    out << "tunecache\t" << quda_version << "\t" << buildVersion() << "\t" << quda_hash << "\t# Last updated "
+        << ctime(&now) << std::endl;
+    out << std::setw(16) << "volume"
+        << "\tname\taux\tblock.x\tblock.y\tblock.z\tgrid.x\tgrid.y\tgrid.z\tshared_bytes\taux.x\taux.y\taux."
+           "z\taux.w\ttime\tcomment"
+        << std::endl;
+    serializeTuneCache(out, cache);
+  }
+
+  /*
+     Binary tunecache format.
+
+     The tunecache is kept in two binary files in QUDA_RESOURCE_PATH,
+     both of which start with the same header:
+     - tunecache.bin is a compacted snapshot, and is only ever replaced
+       as a whole (written to a temporary file and renamed), and
+     - tunecache.journal is append-only: each saveTuneCache appends
+       the newly tuned entries with a single O_APPEND write.
+     Journal entries override snapshot entries on load.  Once the
+     journal grows beyond journal_compact_bytes, the job that saves
+     merges it into a new snapshot.  Appends and compaction both hold
+     tunecache.lock, an flock() on a file in the resource path, so an
+     append can never land in a journal that compaction has already
+     read.  Appends wait for the lock, whereas a job that finds it
+     held at compaction time leaves compaction to a later save.
+
+     The header is the magic string, the format version, a byte-order
+     mark and the null-terminated QUDA version, build version and
+     build hash strings.  Each entry is a record: a 32-bit payload
+     size and a 32-bit FNV-1a checksum of the payload, followed by the
+     payload itself.  The payload holds the null-terminated volume,
+     name and aux strings of the key, the 32-bit integer launch
+     parameters (block, grid, shared_bytes, aux), the time as a float
+     and the null-terminated comment.  A record that is truncated or
+     fails its checksum, e.g., from a torn write on a filesystem
+     without atomic appends, ends the file; the entries lost this way
+     are simply re-tuned.
+
+     Files are memory-mapped and decoded in place when loaded.  If no
+     snapshot exists, tunecache.tsv is imported instead, and the next
+     save writes the first snapshot.  Every compaction also rewrites
+     tunecache.tsv, so the human-readable view is kept up to date.
+   */
+  static const char tunecache_magic[8] = {'Q', 'U', 'D', 'A', 'T', 'U', 'N', 'E'};
+  static const uint32_t tunecache_format = 1;
+  static const uint32_t tunecache_byte_order = 0x01020304;
+  static const size_t journal_compact_bytes = 1 << 20;
+
+  /** entries that have been tuned since the last save */
+  static std::vector<const map::value_type *> journal_pending;
+
+  static uint32_t recordChecksum(const char *data, size_t size)
+  {
+    uint32_t h = 0x811c9dc5u;
+    for (size_t i = 0; i < size; i++) h = (h ^ static_cast<unsigned char>(data[i])) * 0x01000193u;
+    return h;
+  }
+
+  template <typename T> static void appendBinary(std::string &buf, const T &value)
+  {
+    buf.append(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+
+  static void appendBinaryString(std::string &buf, const char *str) { buf.append(str, strlen(str) + 1); }
+
+  static void appendTuneCacheHeader(std::string &buf)
+  {
+    buf.append(tunecache_magic, sizeof(tunecache_magic));
+    appendBinary(buf, tunecache_format);
+    appendBinary(buf, tunecache_byte_order);
+    appendBinaryString(buf, quda_version.c_str());
+    appendBinaryString(buf, buildVersion());
+    appendBinaryString(buf, quda_hash.c_str());
+  }
+
+  static void appendTuneCacheRecord(std::string &buf, const TuneKey &key, const TuneParam &param)
+  {
+    std::string payload;
+    appendBinaryString(payload, key.volume);
+    appendBinaryString(payload, key.name);
+    appendBinaryString(payload, key.aux);
+    const int32_t launch[] = {static_cast<int32_t>(param.block.x), static_cast<int32_t>(param.block.y),
+                              static_cast<int32_t>(param.block.z), static_cast<int32_t>(param.grid.x),
+                              static_cast<int32_t>(param.grid.y),  static_cast<int32_t>(param.grid.z),
+                              param.shared_bytes, param.aux.x, param.aux.y, param.aux.z, param.aux.w};
+    appendBinary(payload, launch);
+    appendBinary(payload, param.time);
+    appendBinaryString(payload, param.comment.c_str());
+
+    appendBinary(buf, static_cast<uint32_t>(payload.size()));
+    appendBinary(buf, recordChecksum(payload.data(), payload.size()));
+    buf += payload;
+  }
+
+  /**
+     @brief Bounds-checked cursor over a memory-mapped tunecache file
+   */
+  class BinaryReader
+  {
+    const char *ptr;
+    const char *end;
+
+  public:
+    BinaryReader(const char *ptr, size_t size) : ptr(ptr), end(ptr + size) { }
+
+    bool done() const { return ptr == end; }
+
+    template <typename T> bool read(T &value)
+    {
+      if (static_cast<size_t>(end - ptr) < sizeof(T)) return false;
+      memcpy(&value, ptr, sizeof(T));
+      ptr += sizeof(T);
+      return true;
+    }
+
+    /** return the null-terminated string at the cursor, or nullptr if it is longer than max_length */
+    const char *readString(size_t max_length)
+    {
+      const char *nul = static_cast<const char *>(memchr(ptr, '\0', std::min<size_t>(end - ptr, max_length + 1)));
+      if (!nul) return nullptr;
+      const char *str = ptr;
+      ptr = nul + 1;
+      return str;
+    }
+
+    /** return a reader for the next size bytes, advancing past them */
+    bool sub(size_t size, BinaryReader &reader)
+    {
+      if (static_cast<size_t>(end - ptr) < size) return false;
+      reader = BinaryReader(ptr, size);
+      ptr += size;
+      return true;
+    }
+
+    const char *data() const { return ptr; }
+  };
+
+  static bool readTuneCacheRecord(BinaryReader &file, TuneKey &key, TuneParam &param)
+  {
+    uint32_t size, checksum;
+    BinaryReader record(nullptr, 0);
+    if (!file.read(size) || !file.read(checksum) || !file.sub(size, record)) return false;
+    if (recordChecksum(record.data(), size) != checksum) return false;
+
+    const char *volume = record.readString(TuneKey::volume_n - 1);
+    const char *name = volume ? record.readString(TuneKey::name_n - 1) : nullptr;
+    const char *aux = name ? record.readString(TuneKey::aux_n - 1) : nullptr;
+    int32_t launch[11];
+    if (!aux || !record.read(launch) || !record.read(param.time)) return false;
+    const char *comment = record.readString(size);
+    if (!comment || !record.done()) return false;
+
+    key = TuneKey(volume, name, aux);
+    param.block = dim3(launch[0], launch[1], launch[2]);
+    param.grid = dim3(launch[3], launch[4], launch[5]);
+    param.shared_bytes = launch[6];
+    param.aux = make_int4(launch[7], launch[8], launch[9], launch[10]);
+    param.comment = comment;
+    param.n_calls = 0;
+    return true;
+  }
+
+  static void versionMismatch(const std::string &path, const char *what)
+  {
+    errorQuda("Cache file %s does not match current QUDA %s. \nPlease delete this file or set the "
+              "QUDA_RESOURCE_PATH environment variable to point to a new path.",
+              path.c_str(), what);
+  }
+
+  /**
+     @brief Read a binary tunecache file (snapshot or journal) into
+     cache, later entries overriding earlier ones.
+     @return The number of entries read, or -1 if the file does not exist
+   */
+  static long readBinaryTuneCache(const std::string &path, map &cache, bool version_check)
+  {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) return -1;
+
+    struct stat fstatus;
+    if (fstat(fd, &fstatus) || fstatus.st_size == 0) {
+      close(fd);
+      return 0;
+    }
+    const size_t size = fstatus.st_size;
+    void *mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) errorQuda("Unable to map %s", path.c_str());
+
+    BinaryReader file(static_cast<const char *>(mapped), size);
+    char magic[sizeof(tunecache_magic)];
+    uint32_t format, byte_order;
+    if (!file.read(magic) || memcmp(magic, tunecache_magic, sizeof(magic))) errorQuda("Bad format in %s", path.c_str());
+    if (!file.read(format) || format != tunecache_format) errorQuda("Unsupported format version in %s", path.c_str());
+    if (!file.read(byte_order) || byte_order != tunecache_byte_order)
+      errorQuda("Cache file %s was written on a machine with a different byte order", path.c_str());
+
+    const char *version = file.readString(size);
+    const char *build = version ? file.readString(size) : nullptr;
+    const char *hash = build ? file.readString(size) : nullptr;
+    if (!hash) errorQuda("Bad format in %s", path.c_str());
+    if (version_check && (quda_version != version || strcmp(build, buildVersion())))
+      versionMismatch(path, "version");
+    if (version_check && quda_hash != hash) versionMismatch(path, "build");
+
+    long count = 0;
+    TuneKey key;
+    TuneParam param;
+    while (!file.done()) {
+      if (!readTuneCacheRecord(file, key, param)) {
+        warningQuda("Ignoring truncated or corrupt entries at the end of %s", path.c_str());
+        break;
+      }
+      cache[key] = param;
+      count++;
+    }
+
+    munmap(mapped, size);
+    return count;
+  }
+
+  /**
+     @brief Write data to path by way of a temporary file that is
+     renamed into place, so that readers never see a partial file
+   */
+  static bool writeFileAtomic(const std::string &path, const std::string &data)
+  {
+    const std::string tmp_path = path + "." + std::to_string(getpid());
+    std::ofstream file(tmp_path.c_str(), std::ios::binary);
+    file.write(data.data(), data.size());
+    file.close();
+    if (!file || rename(tmp_path.c_str(), path.c_str())) {
+      remove(tmp_path.c_str());
+      return false;
+    }
+    return true;
+  }
+
+  /**
+     @brief Take tunecache.lock.  The lock file is removed on release,
+     so once flock() is granted we check that the file we hold is
+     still the one at lock_path, and retry if its previous holder
+     removed it while we were waiting.  On filesystems without flock()
+     support (e.g., Lustre mounted without "-o flock") we warn once
+     and carry on unlocked.
+     @param[in] wait Whether to block until the lock is free
+     @return Descriptor holding the lock, or -1 if it was not taken
+   */
+  static int lockTuneCache(bool wait)
+  {
+    const std::string lock_path = resource_path + "/tunecache.lock";
+    while (true) {
+      int fd = open(lock_path.c_str(), O_WRONLY | O_CREAT, 0666);
+      if (fd == -1) return -1;
+
+      if (flock(fd, wait ? LOCK_EX : LOCK_EX | LOCK_NB)) {
+        const int err = errno;
+        if (err == EINTR) {
+          close(fd);
+          continue;
+        }
+        if (err == ENOSYS || err == EOPNOTSUPP || err == ENOLCK) {
+          static bool warned = false;
+          if (!warned)
+            warningQuda("flock() is not supported on %s; tunecache updates are not serialized", lock_path.c_str());
+          warned = true;
+          return fd;
+        }
+        close(fd);
+        return -1;
+      }
+
+      struct stat held, current;
+      if (fstat(fd, &held) == 0 && stat(lock_path.c_str(), &current) == 0 && held.st_dev == current.st_dev
+          && held.st_ino == current.st_ino)
+        return fd;
+      close(fd);
+    }
+  }
+
+  /**
+     @brief Release tunecache.lock.  The file is removed before it is
+     unlocked, so that a waiter can tell that it has lost the race.
+   */
+  static void unlockTuneCache(int fd)
+  {
+    remove((resource_path + "/tunecache.lock").c_str());
+    close(fd);
+  }
+
+  /**
+     @brief Append the entries tuned since the last save to the
+     journal, creating it (header first) if needed.  This holds
+     tunecache.lock, so it cannot race with compaction.
+     @return Size of the journal after the append, or 0 on failure
+   */
+  static size_t appendTuneCacheJournal()
+  {
+    const std::string journal_path = resource_path + "/tunecache.journal";
+
+    int lock_handle = lockTuneCache(true);
+    if (lock_handle == -1) return 0;
+
+    int fd = open(journal_path.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0666);
+    struct stat jstat;
+    if (fd == -1 || fstat(fd, &jstat)) {
+      if (fd != -1) close(fd);
+      unlockTuneCache(lock_handle);
+      return 0;
+    }
+
+    std::string records;
+    if (jstat.st_size == 0) appendTuneCacheHeader(records);
+    for (auto entry : journal_pending) appendTuneCacheRecord(records, entry->first, entry->second);
+
+    // one write where possible, so that a torn append loses as little as possible
+    const char *data = records.data();
+    size_t remaining = records.size();
+    size_t size = 0;
+    while (remaining > 0) {
+      ssize_t written = write(fd, data, remaining);
+      if (written == -1 && errno == EINTR) continue;
+      if (written <= 0) break;
+      data += written;
+      remaining -= written;
+    }
+    if (remaining == 0 && fstat(fd, &jstat) == 0) size = jstat.st_size;
+    close(fd);
+    unlockTuneCache(lock_handle);
+    return size;
+  }
+
+  /**
+     @brief Merge the snapshot, the journal and the in-memory
+     tunecache into a new snapshot, and reset the journal.  The whole
+     merge is done under tunecache.lock, which keeps appends out
+     between the journal being read and it being removed; if the lock
+     is held by another job then compaction is skipped.
+   */
+  static void compactTuneCache(size_t journal_size)
+  {
+    const std::string snapshot_path = resource_path + "/tunecache.bin";
+    const std::string journal_path = resource_path + "/tunecache.journal";
+    const std::string compact_path = journal_path + "." + std::to_string(getpid());
+
+    int lock_handle = lockTuneCache(false);
+    if (lock_handle == -1) {
+      if (journal_size > 4 * journal_compact_bytes) {
+        warningQuda("Unable to lock %s/tunecache.lock for compaction of %s (%lu bytes)", resource_path.c_str(),
+                    journal_path.c_str(), journal_size);
+      } else if (getVerbosity() >= QUDA_VERBOSE) {
+        printfQuda("Tunecache compaction skipped since %s/tunecache.lock is held by another job\n",
+                   resource_path.c_str());
+      }
+      return;
+    }
+
+    // move the journal aside, to be removed once the snapshot that absorbs it is in place
+    bool have_journal = rename(journal_path.c_str(), compact_path.c_str()) == 0;
+
+    map merged;
+    readBinaryTuneCache(snapshot_path, merged, version_check);
+    if (have_journal) readBinaryTuneCache(compact_path, merged, version_check);
+    merged.insert(tunecache.begin(), tunecache.end()); // only adds entries the files do not have
+
+    std::string snapshot;
+    appendTuneCacheHeader(snapshot);
+    for (auto &entry : merged) appendTuneCacheRecord(snapshot, entry.first, entry.second);
+
+    std::stringstream tsv;
+    writeTuneCacheTSV(tsv, merged);
+
+    if (getVerbosity() >= QUDA_SUMMARIZE)
+      printfQuda("Saving %lu sets of cached parameters to %s\n", merged.size(), snapshot_path.c_str());
+
+    if (writeFileAtomic(snapshot_path, snapshot)) {
+      if (have_journal) remove(compact_path.c_str());
+      if (!writeFileAtomic(resource_path + "/tunecache.tsv", tsv.str()))
+        warningQuda("Unable to write %s/tunecache.tsv", resource_path.c_str());
+    } else {
+      warningQuda("Unable to write %s", snapshot_path.c_str());
+      // put the journal back; no job can have started a new one while we hold the lock
+      if (have_journal && rename(compact_path.c_str(), journal_path.c_str()))
+        warningQuda("Journal entries are left in %s", compact_path.c_str());
+    }
+
+    unlockTuneCache(lock_handle);
+  }
+
   template <class T> struct less_significant : std::binary_function<T, T, bool> {
     inline bool operator()(const T &lhs, const T &rhs)
     {
@@ -270,6 +797,8 @@ namespace quda
     out << std::endl << "# Total time spent in kernels = " << total_time << " seconds" << std::endl;
     async_out << std::endl
               << "# Total time spent in asynchronous execution = " << async_total_time << " seconds" << std::endl;
+    out << "# Tunecache hits = " << tune_hits << ", warm-started tunes = " << tune_seeded
+        << ", full tunes = " << tune_full << std::endl;
   }
 
   /**
@@ -299,6 +828,187 @@ namespace quda
     }
   }
 
+  /**
+   * Write a null-terminated string as a JSON string literal.
+   */
+  static void writeJSONString(std::ostream &out, const char *str)
+  {
+    out << '"';
+    for (const char *c = str; *c; c++) {
+      switch (*c) {
+      case '"': out << "\\\""; break;
+      case '\\': out << "\\\\"; break;
+      case '\n': out << "\\n"; break;
+      case '\t': out << "\\t"; break;
+      default:
+        if (static_cast<unsigned char>(*c) < 0x20) {
+          char code[8];
+          snprintf(code, sizeof(code), "\\u%04x", *c);
+          out << code;
+        } else {
+          out << *c;
+        }
+      }
+    }
+    out << '"';
+  }
+
+  static bool isPolicy(const TuneKey &key)
+  {
+    return strncmp(key.aux, "policy", 6) == 0 && strncmp(key.aux, "policy_kernel", 13) != 0;
+  }
+
+  /**
+   * Serialize the profile as JSON: the same entries as the TSV
+   * profiles, synchronous and asynchronous, in decreasing order of
+   * total time.
+   */
+  static void serializeProfileJSON(std::ostream &out, const std::string &label)
+  {
+    std::vector<const map::value_type *> entries;
+    double total_time = 0.0;
+    double async_total_time = 0.0;
+    for (auto &entry : tunecache) {
+      const TuneParam &param = entry.second;
+      if (param.n_calls == 0 || strncmp(entry.first.aux, "nested_policy", 6) == 0) continue;
+      entries.push_back(&entry);
+      (isPolicy(entry.first) ? async_total_time : total_time) += param.n_calls * param.time;
+    }
+    std::stable_sort(entries.begin(), entries.end(), [](const map::value_type *a, const map::value_type *b) {
+      return a->second.n_calls * a->second.time > b->second.n_calls * b->second.time;
+    });
+
+    out << std::setprecision(9);
+    out << "{\n  \"label\": ";
+    writeJSONString(out, label.c_str());
+    out << ",\n  \"version\": ";
+    writeJSONString(out, quda_version.c_str());
+    out << ",\n  \"build\": ";
+    writeJSONString(out, buildVersion());
+    out << ",\n  \"hash\": ";
+    writeJSONString(out, quda_hash.c_str());
+    out << ",\n  \"rank\": " << comm_rank();
+    out << ",\n  \"total_time\": " << total_time;
+    out << ",\n  \"async_total_time\": " << async_total_time;
+    out << ",\n  \"tunecache\": {\"hits\": " << tune_hits << ", \"warm_started\": " << tune_seeded
+        << ", \"full\": " << tune_full << "}";
+    out << ",\n  \"kernels\": [";
+
+    for (auto it = entries.begin(); it != entries.end(); it++) {
+      const TuneKey &key = (*it)->first;
+      const TuneParam &param = (*it)->second;
+      const bool async = isPolicy(key);
+      const double time = param.n_calls * param.time;
+
+      // the comment is stored with its leading "# " and trailing newline
+      std::string comment = param.comment;
+      if (comment.compare(0, 2, "# ") == 0) comment.erase(0, 2);
+      while (!comment.empty() && comment.back() == '\n') comment.pop_back();
+
+      out << (it == entries.begin() ? "\n" : ",\n") << "    {\"volume\": ";
+      writeJSONString(out, key.volume);
+      out << ", \"name\": ";
+      writeJSONString(out, key.name);
+      out << ", \"aux\": ";
+      writeJSONString(out, key.aux);
+      out << ", \"async\": " << (async ? "true" : "false");
+      out << ", \"calls\": " << param.n_calls << ", \"time_per_call\": " << param.time;
+      out << ", \"total_time\": " << time;
+      out << ", \"percentage\": " << 100 * time / (async ? async_total_time : total_time);
+      out << ", \"block\": [" << param.block.x << ", " << param.block.y << ", " << param.block.z << "]";
+      out << ", \"grid\": [" << param.grid.x << ", " << param.grid.y << ", " << param.grid.z << "]";
+      out << ", \"shared_bytes\": " << param.shared_bytes;
+      out << ", \"aux_param\": [" << param.aux.x << ", " << param.aux.y << ", " << param.aux.z << ", " << param.aux.w
+          << "]";
+      out << ", \"comment\": ";
+      writeJSONString(out, comment.c_str());
+      out << "}";
+    }
+    out << "\n  ]\n}\n";
+  }
+
+  /**
+   * Serialize the trace of this rank in the Chrome trace-event format
+   * (viewable in Perfetto or chrome://tracing).  Kernels from the
+   * trace list are placed on thread 0, with their tuned time as the
+   * duration, posted trace points as instant events and the
+   * allocation counters as counter events.  The intervals recorded
+   * by each TimeProfile get a thread of their own.  Timestamps are
+   * microseconds since the start of this rank.
+   */
+  static void serializeTraceEvents(std::ostream &out)
+  {
+    const int rank = comm_rank();
+    bool first = true;
+    auto event = [&](const char *ph, const char *name, int tid) {
+      out << (first ? "\n" : ",\n") << "  {\"ph\": \"" << ph << "\", \"pid\": " << rank << ", \"tid\": " << tid
+          << ", \"name\": ";
+      writeJSONString(out, name);
+      first = false;
+    };
+
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\": \"ms\", \"otherData\": {\"version\": ";
+    writeJSONString(out, quda_version.c_str());
+    out << ", \"build\": ";
+    writeJSONString(out, buildVersion());
+    out << ", \"hash\": ";
+    writeJSONString(out, quda_hash.c_str());
+    out << ", \"rank\": " << rank << "},\n\"traceEvents\": [";
+
+    event("M", "process_name", 0);
+    out << ", \"args\": {\"name\": \"rank " << rank << "\"}}";
+    event("M", "thread_name", 0);
+    out << ", \"args\": {\"name\": \"kernels\"}}";
+
+    long bytes[4] = {-1, -1, -1, -1};
+    for (auto &trace : trace_list) {
+      const TuneKey &key = trace.key;
+      const double ts = TimeProfile::TraceTime(trace.timestamp);
+      if (key.volume[0] == '\0') { // posted with postTrace()
+        event("i", key.name, 0);
+        out << ", \"s\": \"t\", \"ts\": " << ts << ", \"args\": {\"location\": ";
+        writeJSONString(out, key.aux);
+        out << "}}";
+      } else {
+        event("X", key.name, 0);
+        out << ", \"cat\": \"" << (strcmp(key.aux, "policy_kernel") == 0 ? "policy_kernel" : "kernel") << "\"";
+        out << ", \"ts\": " << ts << ", \"dur\": " << 1e6 * trace.time << ", \"args\": {\"volume\": ";
+        writeJSONString(out, key.volume);
+        out << ", \"aux\": ";
+        writeJSONString(out, key.aux);
+        out << "}}";
+      }
+
+      const long now[4] = {trace.device_bytes, trace.pinned_bytes, trace.mapped_bytes, trace.host_bytes};
+      if (!std::equal(now, now + 4, bytes)) {
+        event("C", "allocated", 0);
+        out << ", \"ts\": " << ts << ", \"args\": {\"device\": " << now[0] << ", \"pinned\": " << now[1]
+            << ", \"mapped\": " << now[2] << ", \"host\": " << now[3] << "}}";
+        std::copy(now, now + 4, bytes);
+      }
+    }
+
+    std::map<std::string, int> profile_tid;
+    for (auto &interval : TimeProfile::Events()) {
+      auto tid = profile_tid.find(interval.fname);
+      if (tid == profile_tid.end()) {
+        tid = profile_tid.insert({interval.fname, static_cast<int>(profile_tid.size()) + 1}).first;
+        event("M", "thread_name", tid->second);
+        out << ", \"args\": {\"name\": ";
+        writeJSONString(out, interval.fname.c_str());
+        out << "}}";
+      }
+      const double ts = TimeProfile::TraceTime(interval.start);
+      event("X", TimeProfile::Name(interval.idx).c_str(), tid->second);
+      out << ", \"cat\": ";
+      writeJSONString(out, interval.fname.c_str());
+      out << ", \"ts\": " << ts << ", \"dur\": " << TimeProfile::TraceTime(interval.stop) - ts << "}";
+    }
+
+    out << "\n]}\n";
+  }
+
   /**
    * Distribute the tunecache from node 0 to all other nodes.
    */
@@ -359,7 +1069,6 @@ namespace quda
       resource_path = path;
     }
 
-    bool version_check = true;
     char *override_version_env = getenv("QUDA_TUNE_VERSION_CHECK");
     if (override_version_env && strcmp(override_version_env, "0") == 0) {
       version_check = false;
@@ -370,11 +1079,18 @@ namespace quda
     if (comm_rank() == 0) {
 #endif
 
-      cache_path = resource_path;
-      cache_path += "/tunecache.tsv";
-      cache_file.open(cache_path.c_str());
+      map loaded;
+      cache_path = resource_path + "/tunecache.bin";
+      long n_snapshot = readBinaryTuneCache(cache_path, loaded, version_check);
 
-      if (cache_file) {
+      if (n_snapshot < 0) {
+        // no binary snapshot, so import the text format if present
+        cache_path = resource_path + "/tunecache.tsv";
+        cache_file.open(cache_path.c_str());
+      }
+
+      const bool have_tsv = cache_file.is_open();
+      if (have_tsv) {
 
         if (!cache_file.good()) errorQuda("Bad format in %s", cache_path.c_str());
         getline(cache_file, line);
@@ -382,27 +1098,11 @@ namespace quda
         ls >> token;
         if (token.compare("tunecache")) errorQuda("Bad format in %s", cache_path.c_str());
         ls >> token;
-        if (version_check && token.compare(quda_version))
-          errorQuda("Cache file %s does not match current QUDA version. \nPlease delete this file or set the "
-                    "QUDA_RESOURCE_PATH environment variable to point to a new path.",
-                    cache_path.c_str());
+        if (version_check && token.compare(quda_version)) versionMismatch(cache_path, "version");
         ls >> token;
-#ifdef GITVERSION
-        if (version_check && token.compare(gitversion))
-          errorQuda("Cache file %s does not match current QUDA version. \nPlease delete this file or set the "
-                    "QUDA_RESOURCE_PATH environment variable to point to a new path.",
-                    cache_path.c_str());
-#else
-      if (version_check && token.compare(quda_version))
-        errorQuda("Cache file %s does not match current QUDA version. \nPlease delete this file or set the "
-                  "QUDA_RESOURCE_PATH environment variable to point to a new path.",
-                  cache_path.c_str());
-#endif
+        if (version_check && token.compare(buildVersion())) versionMismatch(cache_path, "version");
         ls >> token;
-        if (version_check && token.compare(quda_hash))
-          errorQuda("Cache file %s does not match current QUDA build. \nPlease delete this file or set the "
-                    "QUDA_RESOURCE_PATH environment variable to point to a new path.",
-                    cache_path.c_str());
+        if (version_check && token.compare(quda_hash)) versionMismatch(cache_path, "build");
 
         if (!cache_file.good()) errorQuda("Bad format in %s", cache_path.c_str());
         getline(cache_file, line); // eat the blank line
@@ -413,13 +1113,18 @@ namespace quda
         deserializeTuneCache(cache_file);
 
         cache_file.close();
-        initial_cache_size = tunecache.size();
+      }
 
+      // journal entries override the snapshot
+      const std::string journal_path = resource_path + "/tunecache.journal";
+      long n_journal = readBinaryTuneCache(journal_path, loaded, version_check);
+      for (auto &entry : loaded) setTuneCache(entry.first, entry.second);
+
+      if (n_snapshot >= 0 || have_tsv || n_journal >= 0) {
         if (getVerbosity() >= QUDA_SUMMARIZE) {
-          printfQuda("Loaded %d sets of cached parameters from %s\n", static_cast<int>(initial_cache_size),
-                     cache_path.c_str());
+          printfQuda("Loaded %d sets of cached parameters from %s%s\n", static_cast<int>(tunecache.size()),
+                     cache_path.c_str(), n_journal > 0 ? " and its journal" : "");
         }
-
       } else {
         warningQuda("Cache file not found.  All kernels will be re-tuned (if tuning is enabled).");
       }
@@ -432,70 +1137,116 @@ namespace quda
   }
 
   /**
-   * Write tunecache to disk.
+     @brief Collect the entries tuned locally on the other processes
+     since the last save on process 0, so that they are saved too.
+     This matters whenever processes tune kernels that process 0
+     never sees, e.g., with uneven subvolumes.  Entries tuned
+     collectively are broadcast from process 0 and are never
+     gathered.  Entries are merged in rank order and only keys that
+     process 0 has not cached are added, so its live parameters are
+     never replaced.  If anything was added, the tunecache is
+     broadcast again so that every process holds the same entries.
+     This is collective over all processes.
    */
-  void saveTuneCache(bool error)
+  static void gatherTuneCache()
   {
-    time_t now;
-    int lock_handle;
-    std::string lock_path, cache_path;
-    std::ofstream cache_file;
+#ifdef MULTI_GPU
+    // process 0 already has its own entries
+    std::string records;
+    if (comm_rank() != 0) {
+      for (auto entry : journal_pending) appendTuneCacheRecord(records, entry->first, entry->second);
+      journal_pending.clear();
+    }
+
+    std::vector<size_t> nbytes(comm_size());
+    comm_gather_nbytes(nbytes.data(), records.size());
+    size_t total = std::accumulate(nbytes.begin(), nbytes.end(), static_cast<size_t>(0));
+    if (total == 0) return;
+
+    std::vector<char> gathered(comm_rank() == 0 ? total : 0);
+    comm_gatherv(gathered.data(), records.data(), nbytes.data());
+
+    int merged = 0;
+    if (comm_rank() == 0) {
+      BinaryReader reader(gathered.data(), total);
+      TuneKey key;
+      TuneParam param;
+      int received = 0;
+      while (!reader.done()) {
+        if (!readTuneCacheRecord(reader, key, param)) errorQuda("Corrupt tunecache entry received from another process");
+        received++;
+        if (tunecache_index.find(key)) continue;
+        journal_pending.push_back(&setTuneCache(key, param));
+        merged++;
+      }
+
+      if (getVerbosity() >= QUDA_VERBOSE)
+        printfQuda("Merged %d of %d sets of cached parameters tuned on other processes\n", merged, received);
+    }
+
+    comm_broadcast(&merged, sizeof(merged));
+    if (merged > 0) broadcastTuneCache();
+#endif
+  }
 
+  /**
+   * Write tunecache to disk.  The entries tuned since the last save
+   * are appended to the journal, which is compacted into the snapshot
+   * once it is large enough.  On error, the whole tunecache is written
+   * to tunecache_error.tsv instead.
+   */
+  void saveTuneCache(bool error)
+  {
     if (resource_path.empty()) return;
 
-      // FIXME: We should really check to see if any nodes have tuned a kernel that was not also tuned on node 0, since as things
-      //       stand, the corresponding launch parameters would never get cached to disk in this situation.  This will come up if we
-      //       ever support different subvolumes per GPU (as might be convenient for lattice volumes that don't divide evenly).
+    // collect the kernels tuned on other processes (this is collective, so not on error)
+    if (!error) gatherTuneCache();
 
 #ifdef MULTI_GPU
     if (comm_rank() == 0) {
 #endif
 
-      if (tunecache.size() == initial_cache_size && !error) return;
+      if (error) {
+        int lock_handle = lockTuneCache(false);
+        if (lock_handle == -1) {
+          warningQuda("Unable to lock %s/tunecache.lock.  Tuned launch parameters will not be cached to disk.",
+                      resource_path.c_str());
+          return;
+        }
 
-      // Acquire lock.  Note that this is only robust if the filesystem supports flock() semantics, which is true for
-      // NFS on recent versions of linux but not Lustre by default (unless the filesystem was mounted with "-o flock").
-      lock_path = resource_path + "/tunecache.lock";
-      lock_handle = open(lock_path.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0666);
-      if (lock_handle == -1) {
-        warningQuda("Unable to lock cache file.  Tuned launch parameters will not be cached to disk.  "
-                    "If you are certain that no other instances of QUDA are accessing this filesystem, "
-                    "please manually remove %s",
-                    lock_path.c_str());
+        std::string cache_path = resource_path + "/tunecache_error.tsv";
+        if (getVerbosity() >= QUDA_SUMMARIZE) {
+          printfQuda("Saving %d sets of cached parameters to %s\n", static_cast<int>(tunecache.size()),
+                     cache_path.c_str());
+        }
+        std::ofstream cache_file(cache_path.c_str());
+        writeTuneCacheTSV(cache_file, tunecache);
+        cache_file.close();
+
+        unlockTuneCache(lock_handle);
         return;
       }
-      char msg[] = "If no instances of applications using QUDA are running,\n"
-                   "this lock file shouldn't be here and is safe to delete.";
-      int stat = write(lock_handle, msg, sizeof(msg)); // check status to avoid compiler warning
-      if (stat == -1) warningQuda("Unable to write to lock file for some bizarre reason");
 
-      cache_path = resource_path + (error ? "/tunecache_error.tsv" : "/tunecache.tsv");
-      cache_file.open(cache_path.c_str());
+      // write the first snapshot, e.g., after importing tunecache.tsv, even if nothing new was tuned
+      struct stat snapshot_stat;
+      bool have_snapshot = stat((resource_path + "/tunecache.bin").c_str(), &snapshot_stat) == 0;
 
-      if (getVerbosity() >= QUDA_SUMMARIZE) {
-        printfQuda("Saving %d sets of cached parameters to %s\n", static_cast<int>(tunecache.size()), cache_path.c_str());
+      if (journal_pending.empty()) {
+        if (!have_snapshot && !tunecache.empty()) compactTuneCache(0);
+        return;
       }
 
-      time(&now);
-      cache_file << "tunecache\t" << quda_version;
-#ifdef GITVERSION
-      cache_file << "\t" << gitversion;
-#else
-    cache_file << "\t" << quda_version;
-#endif
-      cache_file << "\t" << quda_hash << "\t# Last updated " << ctime(&now) << std::endl;
-      cache_file << std::setw(16) << "volume"
-                 << "\tname\taux\tblock.x\tblock.y\tblock.z\tgrid.x\tgrid.y\tgrid.z\tshared_bytes\taux.x\taux.y\taux."
-                    "z\taux.w\ttime\tcomment"
-                 << std::endl;
-      serializeTuneCache(cache_file);
-      cache_file.close();
+      if (getVerbosity() >= QUDA_SUMMARIZE) {
+        printfQuda("Saving %lu new sets of cached parameters to %s/tunecache.journal\n", journal_pending.size(),
+                   resource_path.c_str());
+      }
 
-      // Release lock.
-      close(lock_handle);
-      remove(lock_path.c_str());
+      size_t journal_size = appendTuneCacheJournal();
+      if (journal_size == 0) warningQuda("Unable to append to %s/tunecache.journal", resource_path.c_str());
+      journal_pending.clear();
 
-      initial_cache_size = tunecache.size();
+      // compaction also picks up anything the append failed to write
+      if (journal_size == 0 || journal_size > journal_compact_bytes || !have_snapshot) compactTuneCache(journal_size);
 
 #ifdef MULTI_GPU
     } else {
@@ -514,6 +1265,7 @@ namespace quda
   // flush profile, setting counts to zero
   void flushProfile()
   {
+    tune_hits = tune_seeded = tune_full = 0;
     for (map::iterator entry = tunecache.begin(); entry != tunecache.end(); entry++) {
       // set all n_calls = 0
       TuneParam &param = entry->second;
@@ -526,11 +1278,26 @@ namespace quda
   {
     time_t now;
     int lock_handle;
-    std::string lock_path, profile_path, async_profile_path, trace_path;
-    std::ofstream profile_file, async_profile_file, trace_file;
+    std::string lock_path, profile_path, async_profile_path, trace_path, json_profile_path;
+    std::ofstream profile_file, async_profile_file, trace_file, json_profile_file;
 
     if (resource_path.empty()) return;
 
+    // profile counter for writing out unique profiles
+    static int count = 0;
+    const int index = count++;
+
+    char *profile_fname = getenv("QUDA_PROFILE_OUTPUT_BASE");
+
+    // every rank writes its own trace-event file, since the timestamps are per rank
+    if (traceEnabled()) {
+      std::string trace_json_path = resource_path + "/" + (profile_fname ? std::string(profile_fname) + "_" : "")
+        + "trace_" + std::to_string(index) + "_rank" + std::to_string(comm_rank()) + ".json";
+      std::ofstream trace_json_file(trace_json_path.c_str());
+      serializeTraceEvents(trace_json_file);
+      if (!trace_json_file) warningQuda("Failed to write trace events to %s", trace_json_path.c_str());
+    }
+
 #ifdef MULTI_GPU
     if (comm_rank() == 0) {
 #endif
@@ -551,28 +1318,24 @@ namespace quda
       int stat = write(lock_handle, msg, sizeof(msg)); // check status to avoid compiler warning
       if (stat == -1) warningQuda("Unable to write to lock file for some bizarre reason");
 
-      // profile counter for writing out unique profiles
-      static int count = 0;
-
-      char *profile_fname = getenv("QUDA_PROFILE_OUTPUT_BASE");
-
       if (!profile_fname) {
         warningQuda(
           "Environment variable QUDA_PROFILE_OUTPUT_BASE not set; writing to profile.tsv and profile_async.tsv");
-        profile_path = resource_path + "/profile_" + std::to_string(count) + ".tsv";
-        async_profile_path = resource_path + "/profile_async_" + std::to_string(count) + ".tsv";
-        if (traceEnabled()) trace_path = resource_path + "/trace_" + std::to_string(count) + ".tsv";
+        profile_path = resource_path + "/profile_" + std::to_string(index) + ".tsv";
+        async_profile_path = resource_path + "/profile_async_" + std::to_string(index) + ".tsv";
+        json_profile_path = resource_path + "/profile_" + std::to_string(index) + ".json";
+        if (traceEnabled()) trace_path = resource_path + "/trace_" + std::to_string(index) + ".tsv";
       } else {
-        profile_path = resource_path + "/" + profile_fname + "_" + std::to_string(count) + ".tsv";
-        async_profile_path = resource_path + "/" + profile_fname + "_" + std::to_string(count) + "_async.tsv";
+        profile_path = resource_path + "/" + profile_fname + "_" + std::to_string(index) + ".tsv";
+        async_profile_path = resource_path + "/" + profile_fname + "_" + std::to_string(index) + "_async.tsv";
+        json_profile_path = resource_path + "/" + profile_fname + "_" + std::to_string(index) + ".json";
         if (traceEnabled())
-          trace_path = resource_path + "/" + profile_fname + "_trace_" + std::to_string(count) + ".tsv";
+          trace_path = resource_path + "/" + profile_fname + "_trace_" + std::to_string(index) + ".tsv";
       }
 
-      count++;
-
       profile_file.open(profile_path.c_str());
       async_profile_file.open(async_profile_path.c_str());
+      json_profile_file.open(json_profile_path.c_str());
       if (traceEnabled()) trace_file.open(trace_path.c_str());
 
       if (getVerbosity() >= QUDA_SUMMARIZE) {
@@ -591,8 +1354,11 @@ namespace quda
 
         printfQuda("Saving %d sets of cached parameters to %s\n", n_entry, profile_path.c_str());
         printfQuda("Saving %d sets of cached profiles to %s\n", n_policy, async_profile_path.c_str());
+        printfQuda("Saving JSON profile to %s\n", json_profile_path.c_str());
         if (traceEnabled())
           printfQuda("Saving trace list with %lu entries to %s\n", trace_list.size(), trace_path.c_str());
+        printfQuda("Tunecache hits = %ld, warm-started tunes = %ld, full tunes = %ld\n", tune_hits, tune_seeded,
+                   tune_full);
       }
 
       time(&now);
@@ -628,9 +1394,11 @@ namespace quda
                          << "\tname\taux\tcomment" << std::endl;
 
       serializeProfile(profile_file, async_profile_file);
+      serializeProfileJSON(json_profile_file, Label);
 
       profile_file.close();
       async_profile_file.close();
+      json_profile_file.close();
 
       if (traceEnabled()) {
         trace_file << "trace"
@@ -661,6 +1429,197 @@ namespace quda
 #endif
   }
 
+  /**
+     Warm start for kernels that miss the tunecache, controlled by
+     QUDA_TUNE_WARM_START.  The volume is part of the key, so running
+     at a new local volume normally retunes every kernel from scratch
+     even though the best launch parameters rarely move far.  When
+     enabled, a miss is seeded from the entry for the same name and
+     aux at the nearest cached volume:
+
+     QUDA_TUNE_WARM_START=1: time the seed together with the launch
+     configurations near it (same aux, block, grid and shared memory
+     within a factor of two), at most warm_search_max in total
+     QUDA_TUNE_WARM_START=2: accept the seed, only timing it once
+
+     If there is no usable seed, or it fails to launch, the full
+     search is done as usual.
+   */
+  enum class WarmStart { OFF, SEARCH, ACCEPT };
+  static const int warm_search_max = 32;
+
+  static WarmStart warmStart()
+  {
+    static bool init = false;
+    static WarmStart warm_start = WarmStart::OFF;
+
+    if (!init) {
+      char *warm_start_env = getenv("QUDA_TUNE_WARM_START");
+      if (warm_start_env) {
+        if (strcmp(warm_start_env, "1") == 0) {
+          warm_start = WarmStart::SEARCH;
+        } else if (strcmp(warm_start_env, "2") == 0) {
+          warm_start = WarmStart::ACCEPT;
+        } else if (strcmp(warm_start_env, "0") != 0) {
+          warningQuda("Unrecognized QUDA_TUNE_WARM_START=%s, warm start disabled", warm_start_env);
+        }
+      }
+      init = true;
+    }
+    return warm_start;
+  }
+
+  /**
+     @brief Parse a volume string of the form "XxYxZxT"
+     @return The number of dimensions, or 0 if the string is not of
+     this form
+   */
+  static int parseVolume(const char *volume, double log_dim[])
+  {
+    int n = 0;
+    const char *s = volume;
+    while (n < TuneKey::volume_n) {
+      char *end;
+      long x = strtol(s, &end, 10);
+      if (end == s || x <= 0) return 0;
+      log_dim[n++] = std::log(static_cast<double>(x));
+      if (*end == '\0') return n;
+      if (*end != 'x') return 0;
+      s = end + 1;
+    }
+    return 0;
+  }
+
+  /**
+     @brief Find the tunecache entry for the same name and aux as key
+     whose volume is nearest, measured as the sum over dimensions of
+     the magnitude of the log of the size ratio.  Ties go to the entry
+     cached first.
+     @return The nearest entry, or nullptr if there is none
+   */
+  static const map::value_type *findWarmSeed(const TuneKey &key)
+  {
+    auto group = volume_index.find(nameAuxHash(key));
+    if (group == volume_index.end()) return nullptr;
+
+    double log_dim[TuneKey::volume_n], log_other[TuneKey::volume_n];
+    int n_dim = parseVolume(key.volume, log_dim);
+    if (n_dim == 0) return nullptr;
+
+    const map::value_type *seed = nullptr;
+    double seed_distance = 0.0;
+    for (auto entry : group->second) {
+      if (strcmp(entry->first.name, key.name) != 0 || strcmp(entry->first.aux, key.aux) != 0) continue;
+      if (parseVolume(entry->first.volume, log_other) != n_dim) continue;
+      double distance = 0.0;
+      for (int d = 0; d < n_dim; d++) distance += std::abs(log_dim[d] - log_other[d]);
+      if (!seed || distance < seed_distance) {
+        seed = entry;
+        seed_distance = distance;
+      }
+    }
+    return seed;
+  }
+
+  /**
+     @brief Find the warm-start seed for key and fit it to the
+     tunable.  Policy tuning is done by all processes together, with
+     collective applies, so the seed and hence the configurations that
+     are timed must be the same on every process; since the tunecache
+     may differ between processes, the seed of process 0 is used.
+     @param[out] seed The seed, if there is one
+     @param[out] seed_volume The volume the seed was tuned at
+     @return Whether there is a seed
+   */
+  static bool warmSeed(const Tunable &tunable, const TuneKey &key, TuneParam &seed, char *seed_volume)
+  {
+    bool seeded = false;
+    if (comm_rank() == 0 || !policyTuning()) {
+      const map::value_type *seed_entry = findWarmSeed(key);
+      if (seed_entry) {
+        seed = seed_entry->second;
+        seeded = tunable.seedTuneParam(seed);
+        strcpy(seed_volume, seed_entry->first.volume);
+      }
+    }
+
+#ifdef MULTI_GPU
+    if (policyTuning()) {
+      struct {
+        int seeded;
+        dim3 block;
+        dim3 grid;
+        int shared_bytes;
+        int4 aux;
+        char volume[TuneKey::volume_n];
+      } msg;
+      if (comm_rank() == 0) {
+        msg.seeded = seeded;
+        msg.block = seed.block;
+        msg.grid = seed.grid;
+        msg.shared_bytes = seed.shared_bytes;
+        msg.aux = seed.aux;
+        strcpy(msg.volume, seeded ? seed_volume : "");
+      }
+      comm_broadcast(&msg, sizeof(msg));
+      seeded = msg.seeded;
+      seed.block = msg.block;
+      seed.grid = msg.grid;
+      seed.shared_bytes = msg.shared_bytes;
+      seed.aux = msg.aux;
+      strcpy(seed_volume, msg.volume);
+    }
+#endif
+
+    return seeded;
+  }
+
+  /**
+     @brief Whether a launch configuration is in the neighborhood of
+     the seed that is searched with QUDA_TUNE_WARM_START=1
+   */
+  static bool nearSeed(const TuneParam &param, const TuneParam &seed)
+  {
+    auto near = [](unsigned int a, unsigned int b) { return a <= 2 * b && b <= 2 * a; };
+    return near(param.block.x, seed.block.x) && near(param.block.y, seed.block.y) && near(param.block.z, seed.block.z)
+      && near(param.grid.x, seed.grid.x) && near(param.grid.y, seed.grid.y) && near(param.grid.z, seed.grid.z)
+      && near(param.shared_bytes, seed.shared_bytes) && param.aux.x == seed.aux.x && param.aux.y == seed.aux.y
+      && param.aux.z == seed.aux.z && param.aux.w == seed.aux.w;
+  }
+
+  static bool sameLaunch(const TuneParam &a, const TuneParam &b)
+  {
+    return a.block.x == b.block.x && a.block.y == b.block.y && a.block.z == b.block.z && a.grid.x == b.grid.x
+      && a.grid.y == b.grid.y && a.grid.z == b.grid.z && a.shared_bytes == b.shared_bytes && a.aux.x == b.aux.x
+      && a.aux.y == b.aux.y && a.aux.z == b.aux.z && a.aux.w == b.aux.w;
+  }
+
+  /**
+     @brief Set param to the next configuration of a warm-started
+     search.  The tunable's own search space is walked (without
+     launching anything) and only configurations near the seed are
+     returned.
+     @param[in,out] walker Position in the full search space
+     @param[in,out] walker_done Whether the full search space has been exhausted
+     @param[in,out] n_timed Number of configurations timed so far
+     @return Whether there is another configuration to time
+   */
+  static bool advanceWarmParam(const Tunable &tunable, TuneParam &param, const TuneParam &seed, TuneParam &walker,
+                               bool &walker_done, int &n_timed)
+  {
+    if (warmStart() != WarmStart::SEARCH || n_timed >= warm_search_max) return false;
+    while (!walker_done) {
+      TuneParam candidate = walker;
+      walker_done = !tunable.advanceTuneParam(walker);
+      if (nearSeed(candidate, seed) && !sameLaunch(candidate, seed)) {
+        param = candidate;
+        n_timed++;
+        return true;
+      }
+    }
+    return false;
+  }
+
   static TimeProfile launchTimer("tuneLaunch");
 
   /**
@@ -676,7 +1635,7 @@ namespace quda
 #endif
 
     TuneKey key = tunable.tuneKey();
-    if (use_managed_memory()) strcat(key.aux, ",managed");
+    if (use_managed_memory()) key.appendAux(",managed");
     last_key = key;
     static TuneParam param;
 
@@ -686,17 +1645,17 @@ namespace quda
 #endif
 
     static const Tunable *active_tunable; // for error checking
-    it = tunecache.find(key);
+    TuneParam *cached = tunecache_index.find(key);
 
     // first check if we have the tuned value and return if we have it
-    if (enabled == QUDA_TUNE_YES && it != tunecache.end()) {
+    if (enabled == QUDA_TUNE_YES && cached) {
 
 #ifdef LAUNCH_TIMER
       launchTimer.TPSTOP(QUDA_PROFILE_PREAMBLE);
       launchTimer.TPSTART(QUDA_PROFILE_COMPUTE);
 #endif
 
-      TuneParam &param = it->second;
+      TuneParam &param = *cached;
 
       if (verbosity >= QUDA_DEBUG_VERBOSE) {
         printfQuda("Launching %s with %s at vol=%s with %s\n", key.name, key.aux, key.volume,
@@ -711,7 +1670,10 @@ namespace quda
       tunable.checkLaunchParam(param);
 
       // we could be tuning outside of the current scope
-      if (!tuning && profile_count) param.n_calls++;
+      if (!tuning && profile_count) {
+        param.n_calls++;
+        tune_hits++;
+      }
 
 #ifdef LAUNCH_TIMER
       launchTimer.TPSTOP(QUDA_PROFILE_EPILOGUE);
@@ -768,6 +1730,22 @@ namespace quda
         tune_timer.Start(__func__, __FILE__, __LINE__);
 
         tunable.initTuneParam(param);
+
+        // seed from the nearest cached volume if warm starting
+        TuneParam seed;
+        char seed_volume[TuneKey::volume_n];
+        bool seeded = warmStart() != WarmStart::OFF && warmSeed(tunable, key, seed, seed_volume);
+        TuneParam walker = param;
+        bool walker_done = false;
+        int n_timed = 1;
+        if (seeded) {
+          if (verbosity >= QUDA_DEBUG_VERBOSE) {
+            printfQuda("Warm starting %s with %s at vol=%s from vol=%s\n", key.name, key.aux, key.volume,
+                       seed_volume);
+          }
+          param = seed;
+        }
+
         while (tuning) {
           cudaDeviceSynchronize();
           cudaGetLastError(); // clear error counter
@@ -816,7 +1794,18 @@ namespace quda
               }
             }
           }
-          tuning = tunable.advanceTuneParam(param);
+          if (seeded) {
+            tuning = advanceWarmParam(tunable, param, seed, walker, walker_done, n_timed);
+            if (!tuning && best_time == FLT_MAX) { // nothing near the seed launched, so fall back to the full search
+              if (verbosity >= QUDA_VERBOSE)
+                printfQuda("Warm start failed for %s with %s at vol=%s\n", key.name, key.aux, key.volume);
+              seeded = false;
+              tunable.initTuneParam(param);
+              tuning = true;
+            }
+          } else {
+            tuning = tunable.advanceTuneParam(param);
+          }
           tunable.jitifyError() = CUDA_SUCCESS;
         }
 
@@ -831,9 +1820,14 @@ namespace quda
         }
         time(&now);
         best_param.comment = "# " + tunable.perfString(best_time);
+        if (seeded) best_param.comment += ", warm start from vol=" + std::string(seed_volume);
         best_param.comment += ", tuning took " + std::to_string(tune_timer.Last()) + " seconds at ";
         best_param.comment += ctime(&now); // includes a newline
         best_param.time = best_time;
+        if (seeded)
+          tune_seeded++;
+        else
+          tune_full++;
 
         cudaEventDestroy(start);
         cudaEventDestroy(end);
@@ -841,15 +1835,16 @@ namespace quda
         if (verbosity >= QUDA_DEBUG_VERBOSE) printfQuda("PostTune %s\n", key.name);
         tunable.postTune();
         param = best_param;
-        tunecache[key] = best_param;
+        auto &entry = setTuneCache(key, best_param);
+        // entries tuned collectively are broadcast below, so process 0 alone saves them
+        if (comm_rank() == 0 || !(commGlobalReduction() || policyTuning())) journal_pending.push_back(&entry);
       }
       if (commGlobalReduction() || policyTuning()) broadcastTuneCache();
 
       // check this process is getting the key that is expected
-      if (tunecache.find(key) == tunecache.end()) {
-        errorQuda("Failed to find key entry (%s:%s:%s)", key.name, key.volume, key.aux);
-      }
-      param = tunecache[key]; // read this now for all processes
+      cached = tunecache_index.find(key);
+      if (!cached) errorQuda("Failed to find key entry (%s:%s:%s)", key.name, key.volume, key.aux);
+      param = *cached; // read this now for all processes
 
       if (traceEnabled() >= 2) {
         TraceKey trace_entry(key, param.time);
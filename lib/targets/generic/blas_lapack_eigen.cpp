@@ -1,5 +1,9 @@
 #include <blas_lapack.h>
+#include <algorithm>
+#include <complex>
+#include <vector>
 #include <Eigen/LU>
+#include <Eigen/Eigenvalues>
 
 //#define _DEBUG
 
@@ -22,30 +26,150 @@ namespace quda
 
       using namespace Eigen;
 
-      template <typename EigenMatrix, typename Float>
-      void invertEigen(std::complex<Float> *A_eig, std::complex<Float> *Ainv_eig, int n, uint64_t batch)
+      /**
+         @brief Print the time and flop rate of a batched operation
+         started at start, if the verbosity is high enough.
+       */
+      static void reportPerformance(const char *name, const timeval &start, long long flops)
       {
-        EigenMatrix res = EigenMatrix::Zero(n, n);
-        EigenMatrix inv = EigenMatrix::Zero(n, n);
-        for (int j = 0; j < n; j++) {
-          for (int k = 0; k < n; k++) { res(k, j) = A_eig[batch * n * n + j * n + k]; }
+        if (getVerbosity() < QUDA_VERBOSE) return;
+
+        timeval stop;
+        gettimeofday(&stop, NULL);
+        long dsh = stop.tv_sec - start.tv_sec;
+        long dush = stop.tv_usec - start.tv_usec;
+        double timeh = dsh + 0.000001 * dush;
+
+        int threads = 1;
+#ifdef _OPENMP
+        threads = omp_get_max_threads();
+#endif
+        printfQuda("CPU: %s completed in %f seconds using %d threads with GFLOPS = %f\n", name, timeh, threads,
+                   1e-9 * flops / timeh);
+      }
+
+      /**
+         @brief Host view of an argument of a batched operation.  If the
+         data are on the device they are staged through pinned host
+         memory: copied in on construction if the argument is read, and
+         copied back on destruction if it is written.
+       */
+      class HostBuffer
+      {
+        void *ptr;
+        void *ptr_h;
+        const size_t bytes;
+        const bool staged;
+        const bool output;
+
+      public:
+        HostBuffer(void *ptr, size_t bytes, QudaFieldLocation location, bool input, bool output) :
+          ptr(ptr),
+          ptr_h(ptr),
+          bytes(bytes),
+          staged(location == QUDA_CUDA_FIELD_LOCATION),
+          output(output)
+        {
+          if (staged) {
+            ptr_h = pool_pinned_malloc(bytes);
+            if (input) qudaMemcpy(ptr_h, ptr, bytes, cudaMemcpyDeviceToHost);
+          }
         }
 
-        inv = res.inverse();
+        HostBuffer(const HostBuffer &) = delete;
+        HostBuffer &operator=(const HostBuffer &) = delete;
 
-        for (int j = 0; j < n; j++) {
-          for (int k = 0; k < n; k++) { Ainv_eig[batch * n * n + j * n + k] = inv(k, j); }
+        ~HostBuffer()
+        {
+          if (staged) {
+            if (output) qudaMemcpy(ptr, ptr_h, bytes, cudaMemcpyHostToDevice);
+            pool_pinned_free(ptr_h);
+          }
+        }
+
+        template <typename T> T *get() const { return static_cast<T *>(ptr_h); }
+      };
+
+      /**
+         @brief Invert a batch of n x n column-major matrices.  The
+         matrices are accessed in place through Eigen::Map, so there is
+         no element-wise copy in or out of temporary Eigen matrices.
+         Each thread factorizes into a single LU workspace that is
+         reused for its whole share of the batch, and the inverse is
+         solved for directly in the output array.  When the input may be
+         overwritten the LU factorization is done in place in the input
+         array and no workspace is needed at all.
+         @tparam N Compile-time matrix dimension, or Dynamic
+         @param[out] Ainv Array of inverse matrices
+         @param[in,out] A Array of input matrices
+         @param[in] n Matrix dimension (must equal N if N is fixed)
+         @param[in] batch Number of matrices
+         @param[in] overwrite_input Whether A may be used as LU storage
+       */
+      template <int N, typename Float>
+      void invertEigen(std::complex<Float> *Ainv, std::complex<Float> *A, int n, uint64_t batch, bool overwrite_input)
+      {
+        using matrix = Matrix<std::complex<Float>, N, N, ColMajor>;
+        const uint64_t stride = static_cast<uint64_t>(n) * n;
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+          if (overwrite_input) {
+#ifdef _OPENMP
+#pragma omp for
+#endif
+            for (uint64_t i = 0; i < batch; i++) {
+              Map<matrix> a(A + i * stride, n, n);
+              PartialPivLU<Ref<matrix>> lu(a);
+              Map<matrix>(Ainv + i * stride, n, n) = lu.inverse();
+            }
+          } else {
+            PartialPivLU<matrix> lu(n);
+#ifdef _OPENMP
+#pragma omp for
+#endif
+            for (uint64_t i = 0; i < batch; i++) {
+              lu.compute(Map<const matrix>(A + i * stride, n, n));
+              Map<matrix>(Ainv + i * stride, n, n) = lu.inverse();
+            }
+          }
         }
 
         // Check result:
 #ifdef _DEBUG
-        EigenMatrix unit = EigenMatrix::Identity(n, n);
-        EigenMatrix prod = res * inv;
-        Float L2norm = ((prod - unit).norm() / (n * n));
-        printfQuda("Eigen: Norm of (A * Ainv - I) batch %lu = %e\n", batch, L2norm);
+        if (!overwrite_input) {
+          for (uint64_t i = 0; i < batch; i++) {
+            Map<const matrix> a(A + i * stride, n, n);
+            Map<const matrix> ainv(Ainv + i * stride, n, n);
+            Float L2norm = ((a * ainv - matrix::Identity(n, n)).norm() / (n * n));
+            printfQuda("Eigen: Norm of (A * Ainv - I) batch %lu = %e\n", i, L2norm);
+          }
+        }
 #endif
       }
 
+      /**
+         @brief Dispatch the batched inversion to a fixed-size
+         instantiation for the matrix dimensions used by the multigrid
+         coarse clover (2 x Nvec), falling back to dynamic sizes
+         otherwise.  Fixed sizes are limited to matrices that are small
+         enough to live on the thread stack; beyond that the Map-based
+         dynamic path is just as fast.
+       */
+      template <typename Float>
+      void invertEigen(std::complex<Float> *Ainv, std::complex<Float> *A, int n, uint64_t batch, bool overwrite_input)
+      {
+        switch (n) {
+        case 12: invertEigen<12>(Ainv, A, n, batch, overwrite_input); break;
+        case 24: invertEigen<24>(Ainv, A, n, batch, overwrite_input); break;
+        case 48: invertEigen<48>(Ainv, A, n, batch, overwrite_input); break;
+        case 64: invertEigen<64>(Ainv, A, n, batch, overwrite_input); break;
+        default: invertEigen<Dynamic>(Ainv, A, n, batch, overwrite_input);
+        }
+      }
+
       long long BatchInvertMatrix(void *Ainv, void *A, const int n, const uint64_t batch, QudaPrecision prec,
                                   QudaFieldLocation location)
       {
@@ -56,52 +180,314 @@ namespace quda
         void *A_h = (location == QUDA_CUDA_FIELD_LOCATION ? pool_pinned_malloc(size) : A);
         void *Ainv_h = (location == QUDA_CUDA_FIELD_LOCATION ? pool_pinned_malloc(size) : Ainv);
         if (location == QUDA_CUDA_FIELD_LOCATION) { qudaMemcpy(A_h, A, size, cudaMemcpyDeviceToHost); }
+        // the host copy of a device field is scratch, so we can factorize it in place
+        const bool overwrite_input = (location == QUDA_CUDA_FIELD_LOCATION);
 
         long long flops = 0;
-        timeval start, stop;
+        timeval start;
         gettimeofday(&start, NULL);
 
         if (prec == QUDA_SINGLE_PRECISION) {
-          std::complex<float> *A_eig = (std::complex<float> *)A_h;
-          std::complex<float> *Ainv_eig = (std::complex<float> *)Ainv_h;
+          invertEigen((std::complex<float> *)Ainv_h, (std::complex<float> *)A_h, n, batch, overwrite_input);
+          flops += batch * FLOPS_CGETRF(n, n);
+        } else if (prec == QUDA_DOUBLE_PRECISION) {
+          invertEigen((std::complex<double> *)Ainv_h, (std::complex<double> *)A_h, n, batch, overwrite_input);
+          flops += batch * FLOPS_ZGETRF(n, n);
+        } else {
+          errorQuda("%s not implemented for precision = %d", __func__, prec);
+        }
+
+        reportPerformance("Batched matrix inversion", start, flops);
+
+        if (location == QUDA_CUDA_FIELD_LOCATION) {
+          qudaMemcpy((void *)Ainv, Ainv_h, size, cudaMemcpyHostToDevice);
+          pool_pinned_free(Ainv_h);
+          pool_pinned_free(A_h);
+        }
+
+        return flops;
+      }
+
+
+      /**
+         @brief Evaluate c = alpha * a * op(b) (+ c if accumulate) for
+         the runtime operation on b.
+       */
+      template <typename MatC, typename ExprA, typename MatB, typename Scalar>
+      void gemmOpB(MatC &c, const ExprA &a, const MatB &b, Op trans_b, const Scalar &alpha, bool accumulate)
+      {
+        switch (trans_b) {
+        case Op::N:
+          if (accumulate) c.noalias() += alpha * a * b;
+          else c.noalias() = alpha * a * b;
+          break;
+        case Op::T:
+          if (accumulate) c.noalias() += alpha * a * b.transpose();
+          else c.noalias() = alpha * a * b.transpose();
+          break;
+        case Op::C:
+          if (accumulate) c.noalias() += alpha * a * b.adjoint();
+          else c.noalias() = alpha * a * b.adjoint();
+          break;
+        }
+      }
+
+      template <typename Float>
+      void gemmEigen(std::complex<Float> *A, std::complex<Float> *B, std::complex<Float> *C, const GEMMParam &param)
+      {
+        using matrix = Matrix<std::complex<Float>, Dynamic, Dynamic, ColMajor>;
+        using cmap = Map<const matrix, Unaligned, OuterStride<>>;
+        using map = Map<matrix, Unaligned, OuterStride<>>;
+
+        const std::complex<Float> alpha(param.alpha.real(), param.alpha.imag());
+        const std::complex<Float> beta(param.beta.real(), param.beta.imag());
+        const bool accumulate = (beta != std::complex<Float>(0.0));
+
+        // stored dimensions of A and B before the operation is applied
+        const int a_rows = param.trans_a == Op::N ? param.m : param.k;
+        const int a_cols = param.trans_a == Op::N ? param.k : param.m;
+        const int b_rows = param.trans_b == Op::N ? param.k : param.n;
+        const int b_cols = param.trans_b == Op::N ? param.n : param.k;
 
 #ifdef _OPENMP
 #pragma omp parallel for
 #endif
-          for (uint64_t i = 0; i < batch; i++) { invertEigen<MatrixXcf, float>(A_eig, Ainv_eig, n, i); }
+        for (uint64_t i = 0; i < param.batch; i++) {
+          cmap a(A + i * param.stride_a, a_rows, a_cols, OuterStride<>(param.lda));
+          cmap b(B + i * param.stride_b, b_rows, b_cols, OuterStride<>(param.ldb));
+          map c(C + i * param.stride_c, param.m, param.n, OuterStride<>(param.ldc));
+
+          // as in BLAS, C is not read when beta is zero
+          if (accumulate && beta != std::complex<Float>(1.0)) c *= beta;
+
+          switch (param.trans_a) {
+          case Op::N: gemmOpB(c, a, b, param.trans_b, alpha, accumulate); break;
+          case Op::T: gemmOpB(c, a.transpose(), b, param.trans_b, alpha, accumulate); break;
+          case Op::C: gemmOpB(c, a.adjoint(), b, param.trans_b, alpha, accumulate); break;
+          }
+        }
+      }
+
+      long long BatchGEMM(void *A, void *B, void *C, const GEMMParam &param, QudaFieldLocation location)
+      {
+        if (getVerbosity() >= QUDA_VERBOSE)
+          printfQuda("BatchGEMM (generic - Eigen): m = %d, n = %d, k = %d, batch = %lu\n", param.m, param.n, param.k,
+                     param.batch);
+
+        if (param.m < 0 || param.n < 0 || param.k < 0)
+          errorQuda("Invalid dimensions m = %d, n = %d, k = %d", param.m, param.n, param.k);
+        const int a_rows = param.trans_a == Op::N ? param.m : param.k;
+        const int b_rows = param.trans_b == Op::N ? param.k : param.n;
+        if (param.lda < std::max(1, a_rows) || param.ldb < std::max(1, b_rows) || param.ldc < std::max(1, param.m))
+          errorQuda("Invalid leading dimensions lda = %d, ldb = %d, ldc = %d", param.lda, param.ldb, param.ldc);
+
+        // extent of each batched field, from the start of the first
+        // matrix to the end of the last
+        const int a_cols = param.trans_a == Op::N ? param.k : param.m;
+        const int b_cols = param.trans_b == Op::N ? param.n : param.k;
+        auto extent = [&](uint64_t stride, int ld, int cols) {
+          return param.batch == 0 || cols == 0 ? 0 : (param.batch - 1) * stride + (uint64_t)ld * (cols - 1) + ld;
+        };
+        const size_t bytes = 2 * param.precision;
+        HostBuffer A_h(A, extent(param.stride_a, param.lda, a_cols) * bytes, location, true, false);
+        HostBuffer B_h(B, extent(param.stride_b, param.ldb, b_cols) * bytes, location, true, false);
+        HostBuffer C_h(C, extent(param.stride_c, param.ldc, param.n) * bytes, location, true, true);
+
+        long long flops = 0;
+        timeval start;
+        gettimeofday(&start, NULL);
+
+        if (param.precision == QUDA_SINGLE_PRECISION) {
+          using T = std::complex<float>;
+          gemmEigen(A_h.get<T>(), B_h.get<T>(), C_h.get<T>(), param);
+          flops += param.batch * FLOPS_CGEMM(param.m, param.n, param.k);
+        } else if (param.precision == QUDA_DOUBLE_PRECISION) {
+          using T = std::complex<double>;
+          gemmEigen(A_h.get<T>(), B_h.get<T>(), C_h.get<T>(), param);
+          flops += param.batch * FLOPS_ZGEMM(param.m, param.n, param.k);
+        } else {
+          errorQuda("%s not implemented for precision = %d", __func__, param.precision);
+        }
+
+        reportPerformance("Batched GEMM", start, flops);
+
+        return flops;
+      }
+
+      template <typename Float> void luFactorEigen(std::complex<Float> *A, int *pivot, int n, uint64_t batch)
+      {
+        using matrix = Matrix<std::complex<Float>, Dynamic, Dynamic, ColMajor>;
+        const uint64_t stride = static_cast<uint64_t>(n) * n;
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+          // src[r]: original row that ends up in row r of P A
+          // row[r]: original row currently in row r while replaying the swaps, pos its inverse
+          std::vector<int> src(n), row(n), pos(n);
+
+#ifdef _OPENMP
+#pragma omp for
+#endif
+          for (uint64_t i = 0; i < batch; i++) {
+            Map<matrix> a(A + i * stride, n, n);
+            PartialPivLU<Ref<matrix>> lu(a);
+
+            // Eigen returns P as a permutation, (P A)[indices[r]] = A[r],
+            // so rebuild the sequence of row swaps that LAPACK returns
+            const auto &indices = lu.permutationP().indices();
+            for (int r = 0; r < n; r++) {
+              src[indices[r]] = r;
+              row[r] = pos[r] = r;
+            }
+            for (int r = 0; r < n; r++) {
+              const int j = pos[src[r]];
+              pivot[i * n + r] = j + 1;
+              std::swap(row[r], row[j]);
+              pos[row[r]] = r;
+              pos[row[j]] = j;
+            }
+          }
+        }
+      }
+
+      long long BatchLUFactor(void *A, int *pivot, const int n, const uint64_t batch, QudaPrecision prec,
+                              QudaFieldLocation location)
+      {
+        if (getVerbosity() >= QUDA_VERBOSE)
+          printfQuda("BatchLUFactor (generic - Eigen): n = %d, batch = %lu\n", n, batch);
+
+        HostBuffer A_h(A, 2 * n * n * batch * prec, location, true, true);
+        HostBuffer pivot_h(pivot, n * batch * sizeof(int), location, false, true);
+
+        long long flops = 0;
+        timeval start;
+        gettimeofday(&start, NULL);
+
+        if (prec == QUDA_SINGLE_PRECISION) {
+          luFactorEigen(A_h.get<std::complex<float>>(), pivot_h.get<int>(), n, batch);
           flops += batch * FLOPS_CGETRF(n, n);
         } else if (prec == QUDA_DOUBLE_PRECISION) {
-          std::complex<double> *A_eig = (std::complex<double> *)A_h;
-          std::complex<double> *Ainv_eig = (std::complex<double> *)Ainv_h;
+          luFactorEigen(A_h.get<std::complex<double>>(), pivot_h.get<int>(), n, batch);
+          flops += batch * FLOPS_ZGETRF(n, n);
+        } else {
+          errorQuda("%s not implemented for precision = %d", __func__, prec);
+        }
+
+        reportPerformance("Batched LU factorization", start, flops);
+
+        return flops;
+      }
+
+      template <typename Float>
+      void luSolveEigen(std::complex<Float> *B, const std::complex<Float> *LU, const int *pivot, int n, int nrhs,
+                        uint64_t batch)
+      {
+        using matrix = Matrix<std::complex<Float>, Dynamic, Dynamic, ColMajor>;
+        const uint64_t stride = static_cast<uint64_t>(n) * n;
 
 #ifdef _OPENMP
 #pragma omp parallel for
 #endif
-          for (uint64_t i = 0; i < batch; i++) { invertEigen<MatrixXcd, double>(A_eig, Ainv_eig, n, i); }
-          flops += batch * FLOPS_ZGETRF(n, n);
+        for (uint64_t i = 0; i < batch; i++) {
+          Map<const matrix> lu(LU + i * stride, n, n);
+          Map<matrix> b(B + i * n * nrhs, n, nrhs);
+
+          for (int r = 0; r < n; r++) {
+            const int j = pivot[i * n + r] - 1;
+            if (j != r) b.row(r).swap(b.row(j));
+          }
+          lu.template triangularView<UnitLower>().solveInPlace(b);
+          lu.template triangularView<Upper>().solveInPlace(b);
+        }
+      }
+
+      long long BatchLUSolve(void *B, void *LU, const int *pivot, const int n, const int nrhs, const uint64_t batch,
+                             QudaPrecision prec, QudaFieldLocation location)
+      {
+        if (getVerbosity() >= QUDA_VERBOSE)
+          printfQuda("BatchLUSolve (generic - Eigen): n = %d, nrhs = %d, batch = %lu\n", n, nrhs, batch);
+
+        HostBuffer B_h(B, 2 * n * nrhs * batch * prec, location, true, true);
+        HostBuffer LU_h(LU, 2 * n * n * batch * prec, location, true, false);
+        HostBuffer pivot_h(const_cast<int *>(pivot), n * batch * sizeof(int), location, true, false);
+
+        long long flops = 0;
+        timeval start;
+        gettimeofday(&start, NULL);
+
+        if (prec == QUDA_SINGLE_PRECISION) {
+          using T = std::complex<float>;
+          luSolveEigen(B_h.get<T>(), LU_h.get<T>(), pivot_h.get<int>(), n, nrhs, batch);
+          flops += batch * FLOPS_CGETRS(n, nrhs);
+        } else if (prec == QUDA_DOUBLE_PRECISION) {
+          using T = std::complex<double>;
+          luSolveEigen(B_h.get<T>(), LU_h.get<T>(), pivot_h.get<int>(), n, nrhs, batch);
+          flops += batch * FLOPS_ZGETRS(n, nrhs);
         } else {
           errorQuda("%s not implemented for precision = %d", __func__, prec);
         }
 
-        gettimeofday(&stop, NULL);
-        long dsh = stop.tv_sec - start.tv_sec;
-        long dush = stop.tv_usec - start.tv_usec;
-        double timeh = dsh + 0.000001 * dush;
+        reportPerformance("Batched LU solve", start, flops);
+
+        return flops;
+      }
+
+      template <typename Float> bool hermitianEigEigen(Float *evals, std::complex<Float> *A, int n, uint64_t batch)
+      {
+        using matrix = Matrix<std::complex<Float>, Dynamic, Dynamic, ColMajor>;
+        using vector = Matrix<Float, Dynamic, 1>;
+        const uint64_t stride = static_cast<uint64_t>(n) * n;
+        bool success = true;
 
-        if (getVerbosity() >= QUDA_VERBOSE) {
-          int threads = 1;
 #ifdef _OPENMP
-          threads = omp_get_num_threads();
+#pragma omp parallel reduction(&& : success)
 #endif
-          printfQuda("CPU: Batched matrix inversion completed in %f seconds using %d threads with GFLOPS = %f\n", timeh,
-                     threads, 1e-9 * flops / timeh);
+        {
+          SelfAdjointEigenSolver<matrix> eig(n);
+
+#ifdef _OPENMP
+#pragma omp for
+#endif
+          for (uint64_t i = 0; i < batch; i++) {
+            Map<matrix> a(A + i * stride, n, n);
+            eig.compute(a);
+            success = success && eig.info() == Success;
+            Map<vector>(evals + i * n, n) = eig.eigenvalues();
+            a = eig.eigenvectors();
+          }
         }
 
-        if (location == QUDA_CUDA_FIELD_LOCATION) {
-          pool_pinned_free(Ainv_h);
-          pool_pinned_free(A_h);
-          qudaMemcpy((void *)Ainv, Ainv_h, size, cudaMemcpyHostToDevice);
+        return success;
+      }
+
+      long long BatchHermitianEig(void *evals, void *A, const int n, const uint64_t batch, QudaPrecision prec,
+                                  QudaFieldLocation location)
+      {
+        if (getVerbosity() >= QUDA_VERBOSE)
+          printfQuda("BatchHermitianEig (generic - Eigen): n = %d, batch = %lu\n", n, batch);
+
+        HostBuffer A_h(A, 2 * n * n * batch * prec, location, true, true);
+        HostBuffer evals_h(evals, n * batch * prec, location, false, true);
+
+        long long flops = 0;
+        timeval start;
+        gettimeofday(&start, NULL);
+
+        bool success = false;
+        if (prec == QUDA_SINGLE_PRECISION) {
+          success = hermitianEigEigen(evals_h.get<float>(), A_h.get<std::complex<float>>(), n, batch);
+          flops += batch * FLOPS_CHEEV(n);
+        } else if (prec == QUDA_DOUBLE_PRECISION) {
+          success = hermitianEigEigen(evals_h.get<double>(), A_h.get<std::complex<double>>(), n, batch);
+          flops += batch * FLOPS_ZHEEV(n);
+        } else {
+          errorQuda("%s not implemented for precision = %d", __func__, prec);
         }
+        if (!success) errorQuda("Eigen-decomposition failed to converge");
+
+        reportPerformance("Batched Hermitian eigen-decomposition", start, flops);
 
         return flops;
       }
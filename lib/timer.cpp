@@ -1,5 +1,7 @@
 #include <quda_internal.h>
 #include <timer.h>
+#include <cstdlib>
+#include <cstring>
 
 namespace quda {
 
@@ -75,6 +77,14 @@ namespace quda {
   const int TimeProfile::nvtx_num_colors = sizeof(nvtx_colors)/sizeof(uint32_t);
 #endif
 
+  // intervals are recorded for the trace at either trace level (see traceEnabled())
+  bool TimeProfile::record_events = [] {
+    char *enable_trace_env = getenv("QUDA_ENABLE_TRACE");
+    return enable_trace_env && (strcmp(enable_trace_env, "1") == 0 || strcmp(enable_trace_env, "2") == 0);
+  }();
+  std::vector<TimeProfile::Event> TimeProfile::events;
+  Timer::clock::time_point TimeProfile::epoch = Timer::clock::now();
+
   Timer TimeProfile::global_profile[QUDA_PROFILE_COUNT];
   bool TimeProfile::global_switchOff[QUDA_PROFILE_COUNT] = {};
   int TimeProfile::global_total_level[QUDA_PROFILE_COUNT] = {};
@@ -111,4 +121,60 @@ namespace quda {
 
   }
 
+#ifdef QUDA_HOST_PROFILE
+  ProfileNode ProfileTree::root("root", nullptr);
+  ProfileNode *ProfileTree::current = &ProfileTree::root;
+
+  void ProfileTree::Close(const char *func, const char *file, int line)
+  {
+    current->timer.Stop(func, file, line);
+    current->parent->child_time += current->timer.last;
+    current = current->parent;
+  }
+
+  void ProfileTree::Exit(ProfileNode *node, const char *func, const char *file, int line)
+  {
+    // a scope that is no longer on the path to the root was already closed by an enclosing scope
+    ProfileNode *open = current;
+    while (open != &root && open != node) open = open->parent;
+    if (open != node || node == &root) return;
+
+    while (current != node) Close(func, file, line);
+    Close(func, file, line);
+  }
+
+  static void printProfileNode(const ProfileNode &node, int depth, double total)
+  {
+    const Timer &timer = node.timer;
+    if (timer.count == 0) return;
+
+    printfQuda("   %*s%-*s %12f %12f %7.3g%% %9d %12.3e %12.3e\n", 2 * depth, "", 40 - 2 * depth, node.name.c_str(),
+               timer.time, node.SelfTime(), 100 * node.SelfTime() / total, timer.count, 1e6 * timer.min,
+               1e6 * timer.max);
+
+    if (getVerbosity() >= QUDA_VERBOSE) {
+      char hist[1024] = "";
+      int n = 0;
+      for (int i = 0; i < Timer::n_bin && n < (int)sizeof(hist); i++) {
+        if (timer.histogram[i] > 0)
+          n += snprintf(hist + n, sizeof(hist) - n, " %g:%d", 1e6 * Timer::BinEdge(i), timer.histogram[i]);
+      }
+      printfQuda("   %*s  histogram (us:calls)%s\n", 2 * depth, "", hist);
+    }
+
+    for (auto &child : node.children) printProfileNode(*child, depth + 1, total);
+  }
+
+  void ProfileTree::Print()
+  {
+    double total = 0.0;
+    for (auto &child : root.children) total += child->timer.time;
+    if (total == 0.0) return;
+
+    printfQuda("\n   %-40s %12s %12s %8s %9s %12s %12s\n", "Host call tree", "total secs", "self secs", "self", "calls",
+               "min us", "max us");
+    for (auto &child : root.children) printProfileNode(*child, 0, total);
+  }
+#endif
+
 }
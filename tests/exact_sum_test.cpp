@@ -0,0 +1,231 @@
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <host_utils.h>
+#include <command_line_params.h>
+#include <comm_quda.h>
+
+#ifdef MPI_COMMS
+#include <mpi.h>
+#endif
+
+#include <gtest/gtest.h>
+
+// Tests of the exact accumulators behind the deterministic reductions
+// (QUDA_DETERMINISTIC_REDUCE=1).  The sums are compared bit for bit:
+// they must not depend on the order in which values are accumulated,
+// nor on how the values are spread over ranks, so the test is meant to
+// be run with 1, 2 and 4 ranks and gives the same answers each time.
+
+static uint64_t bits(double x)
+{
+  uint64_t b;
+  memcpy(&b, &x, sizeof(double));
+  return b;
+}
+
+#define EXPECT_BITWISE_EQ(a, b) EXPECT_EQ(bits(a), bits(b)) << (a) << " vs " << (b)
+
+// Digit-wise sum of the accumulators of values, in the order given
+static std::vector<int64_t> accumulate(const std::vector<double> &values)
+{
+  const size_t length = comm_exact_sum_length();
+  std::vector<int64_t> acc(length, 0);
+  std::vector<int64_t> a(length);
+  for (auto v : values) {
+    comm_exact_sum_encode(a.data(), &v, 1);
+    for (size_t k = 0; k < length; k++) acc[k] += a[k];
+  }
+  return acc;
+}
+
+static double exact_sum(const std::vector<double> &values)
+{
+  double sum;
+  comm_exact_sum_decode(&sum, accumulate(values).data(), 1);
+  return sum;
+}
+
+// Random values whose exponents span most of the double range
+static std::vector<double> wide_range_values(size_t n, unsigned seed)
+{
+  std::mt19937_64 rng(seed);
+  std::uniform_real_distribution<double> mantissa(0.5, 1.0);
+  std::uniform_int_distribution<int> exponent(-1070, 1000);
+  std::vector<double> values(n);
+  for (auto &v : values) v = (rng() & 1 ? -1 : 1) * std::ldexp(mantissa(rng), exponent(rng));
+  return values;
+}
+
+TEST(exact_sum, permutation)
+{
+  auto values = wide_range_values(10000, 1234);
+  // add pairs that cancel, and some subnormals
+  for (int i = 0; i < 1000; i++) values.push_back(-values[i]);
+  for (int i = 1; i < 100; i++) values.push_back(i * std::numeric_limits<double>::denorm_min());
+
+  const double reference = exact_sum(values);
+  std::mt19937 rng(42);
+  for (int i = 0; i < 20; i++) {
+    std::shuffle(values.begin(), values.end(), rng);
+    EXPECT_BITWISE_EQ(exact_sum(values), reference);
+  }
+  std::sort(values.begin(), values.end());
+  EXPECT_BITWISE_EQ(exact_sum(values), reference);
+  std::reverse(values.begin(), values.end());
+  EXPECT_BITWISE_EQ(exact_sum(values), reference);
+}
+
+TEST(exact_sum, cancellation)
+{
+  EXPECT_BITWISE_EQ(exact_sum({1e308, 1.0, -1e308}), 1.0);
+  EXPECT_BITWISE_EQ(exact_sum({1.0, 1e-16, -1.0}), 1e-16);
+  EXPECT_BITWISE_EQ(exact_sum({DBL_MAX, std::numeric_limits<double>::denorm_min(), -DBL_MAX}),
+                    std::numeric_limits<double>::denorm_min());
+  EXPECT_BITWISE_EQ(exact_sum({1e300, 1e-300, -1e300}), 1e-300);
+  EXPECT_BITWISE_EQ(exact_sum({0.1, 0.2, -0.3}), std::ldexp(1.0, -55)); // (0.1 + 0.2) - 0.3 gives 2^-54
+
+  // every value cancels except one small one, whatever the order
+  auto values = wide_range_values(5000, 5678);
+  const size_t n = values.size();
+  for (size_t i = 0; i < n; i++) values.push_back(-values[i]);
+  values.push_back(3.0 * std::numeric_limits<double>::denorm_min());
+  std::shuffle(values.begin(), values.end(), std::mt19937(7));
+  EXPECT_BITWISE_EQ(exact_sum(values), 3.0 * std::numeric_limits<double>::denorm_min());
+}
+
+TEST(exact_sum, rounding)
+{
+  const double two53 = std::ldexp(1.0, 53);
+  const double tiny = std::numeric_limits<double>::denorm_min();
+  EXPECT_BITWISE_EQ(exact_sum({two53, 1.0}), two53);                   // tie, to even
+  EXPECT_BITWISE_EQ(exact_sum({two53 + 2.0, 1.0}), two53 + 4.0);       // tie, to even
+  EXPECT_BITWISE_EQ(exact_sum({two53, 1.0, tiny}), two53 + 2.0);       // just above the tie
+  EXPECT_BITWISE_EQ(exact_sum({two53, 1.0, -tiny}), two53);            // just below the tie
+  EXPECT_BITWISE_EQ(exact_sum({-two53, -1.0, -tiny}), -(two53 + 2.0)); // and with negative sign
+}
+
+TEST(exact_sum, wide_exponents)
+{
+  // 2^0 + ... + 2^52 is exact, and 2^-1074 + ... + 2^1000 rounds to 2^1001
+  std::vector<double> values;
+  for (int e = 0; e <= 52; e++) values.push_back(std::ldexp(1.0, e));
+  EXPECT_BITWISE_EQ(exact_sum(values), std::ldexp(1.0, 53) - 1.0);
+  values.clear();
+  for (int e = -1074; e <= 1000; e++) values.push_back(std::ldexp(1.0, e));
+  EXPECT_BITWISE_EQ(exact_sum(values), std::ldexp(1.0, 1001));
+
+  EXPECT_BITWISE_EQ(exact_sum({DBL_MAX, -DBL_MAX / 2}), DBL_MAX / 2);
+  EXPECT_BITWISE_EQ(exact_sum({DBL_MAX, DBL_MAX}), std::numeric_limits<double>::infinity());
+  EXPECT_BITWISE_EQ(exact_sum({-DBL_MAX, -DBL_MAX}), -std::numeric_limits<double>::infinity());
+}
+
+TEST(exact_sum, subnormals)
+{
+  const double tiny = std::numeric_limits<double>::denorm_min();
+  EXPECT_BITWISE_EQ(exact_sum({tiny, tiny, tiny}), 3.0 * tiny);
+  EXPECT_BITWISE_EQ(exact_sum({DBL_MIN, -tiny}), std::nextafter(DBL_MIN, 0.0));
+  EXPECT_BITWISE_EQ(exact_sum({std::nextafter(DBL_MIN, 0.0), tiny}), DBL_MIN);
+  EXPECT_BITWISE_EQ(exact_sum(std::vector<double>(1 << 20, tiny)), std::ldexp(1.0, -1054));
+  EXPECT_BITWISE_EQ(exact_sum({tiny, -tiny}), 0.0);
+}
+
+TEST(exact_sum, special_values)
+{
+  const double inf = std::numeric_limits<double>::infinity();
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  EXPECT_BITWISE_EQ(exact_sum({inf, 1.0}), inf);
+  EXPECT_BITWISE_EQ(exact_sum({-inf, DBL_MAX}), -inf);
+  EXPECT_BITWISE_EQ(exact_sum({inf, inf}), inf);
+  EXPECT_TRUE(std::isnan(exact_sum({inf, -inf})));
+  EXPECT_TRUE(std::isnan(exact_sum({nan, 1.0})));
+  EXPECT_TRUE(std::isnan(exact_sum({nan, inf})));
+  EXPECT_TRUE(std::isnan(exact_sum({-inf, nan, inf})));
+}
+
+// Each rank accumulates its share of a fixed list of values, in its
+// own order, and the accumulators are summed across ranks.  The result
+// must match the serial sum whatever the number of ranks.
+TEST(exact_sum, distributed)
+{
+  const int rank = comm_rank();
+  const int size = comm_size();
+
+  auto values = wide_range_values(4096, 9012);
+  for (int i = 0; i < 512; i++) values.push_back(-values[2 * i]);
+  values.push_back(std::numeric_limits<double>::denorm_min());
+  const double reference = exact_sum(values);
+
+  std::vector<double> local;
+  for (size_t i = rank; i < values.size(); i += size) local.push_back(values[i]);
+  std::shuffle(local.begin(), local.end(), std::mt19937(100 + rank));
+  auto acc = accumulate(local);
+
+#ifdef MPI_COMMS
+  MPI_Allreduce(MPI_IN_PLACE, acc.data(), acc.size(), MPI_INT64_T, MPI_SUM, MPI_COMM_WORLD);
+#else
+  if (size > 1) GTEST_SKIP() << "summing accumulators across ranks is only exercised with MPI";
+#endif
+
+  double sum;
+  comm_exact_sum_decode(&sum, acc.data(), 1);
+  EXPECT_BITWISE_EQ(sum, reference);
+}
+
+// The deterministic comm_allreduce_array gives the correctly rounded
+// sum of every rank's contribution, whichever rank contributes what.
+TEST(exact_sum, allreduce)
+{
+  ASSERT_TRUE(comm_deterministic_reduce());
+  const int rank = comm_rank();
+  const int size = comm_size();
+
+  const double tiny = std::numeric_limits<double>::denorm_min();
+  const std::vector<double> extra = {1e308, -1e308, 1.0, tiny, -tiny, 1e-300, 1e16, -1e16};
+  const int n = 64;
+  std::vector<std::vector<double>> contribution(n, std::vector<double>(size));
+  for (int i = 0; i < n; i++) {
+    auto v = wide_range_values(size, 3456 + i);
+    for (int r = 0; r < size; r++) contribution[i][r] = i % 2 ? extra[(r + i) % extra.size()] : v[r];
+  }
+
+  for (int rotation = 0; rotation < size; rotation++) {
+    std::vector<double> data(n);
+    for (int i = 0; i < n; i++) data[i] = contribution[i][(rank + rotation) % size];
+    comm_allreduce_array(data.data(), n);
+    for (int i = 0; i < n; i++) EXPECT_BITWISE_EQ(data[i], exact_sum(contribution[i]));
+  }
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  auto app = make_app();
+  try {
+    app->parse(argc, argv);
+  } catch (const CLI::ParseError &e) {
+    return app->exit(e);
+  }
+
+  // the accumulators are what the deterministic reductions use
+  setenv("QUDA_DETERMINISTIC_REDUCE", "1", 1);
+  initComms(argc, argv, gridsize_from_cmdline);
+
+  // Ensure gtest prints only from rank 0
+  ::testing::TestEventListeners &listeners = ::testing::UnitTest::GetInstance()->listeners();
+  if (comm_rank() != 0) { delete listeners.Release(listeners.default_result_printer()); }
+
+  int test_rc = RUN_ALL_TESTS();
+  if (test_rc != 0) warningQuda("Tests failed");
+
+  finalizeComms();
+  return test_rc;
+}
@@ -117,12 +117,10 @@ int main(int argc, char **argv)
 
   // Vector construct START
   //-----------------------------------------------------------------------------------
-  quda::ColorSpinorField *check;
   quda::ColorSpinorParam cs_param;
   constructWilsonTestSpinorParam(&cs_param, &inv_param, &gauge_param);
-  check = quda::ColorSpinorField::Create(cs_param);
 
-  // Host arrays for solutions, sources, and check
+  // Host arrays for solutions and sources
   void **outMulti = (void **)malloc(inv_param.num_src * sizeof(void *));
   void **inMulti = (void **)malloc(inv_param.num_src * sizeof(void *));
   // QUDA host arrays
@@ -159,9 +157,7 @@ int main(int argc, char **argv)
 
   // Perform host side verification of inversion if requested
   if (verify_results) {
-    for (int i = 0; i < inv_param.num_src; i++) {
-      verifyInversion(outMulti[i], inMulti[i], check->V(), gauge_param, inv_param, gauge, clover, clover_inv);
-    }
+    verifyInversion(outMulti, inMulti, inv_param.num_src, gauge_param, inv_param, gauge, clover, clover_inv);
   }
   // QUDA invert test COMPLETE
   //----------------------------------------------------------------------------
@@ -170,7 +166,6 @@ int main(int argc, char **argv)
   delete rng;
 
   // Clean up memory allocations
-  delete check;
   free(outMulti);
   free(inMulti);
   for (int i = 0; i < inv_param.num_src; i++) {
@@ -5,8 +5,7 @@
 
 #include <host_utils.h>
 #include <command_line_params.h>
-#include <dslash_util.h>
-#include <blas_reference.h>
+#include <dslash_reference.h>
 #include <staggered_dslash_reference.h>
 #include <quda.h>
 #include <string.h>
@@ -21,7 +20,6 @@
 #endif
 
 #define MAX(a,b) ((a)>(b)?(a):(b))
-#define my_spinor_site_size 6
 
 void *qdp_fatlink[4];
 void *qdp_longlink[4];
@@ -29,12 +27,9 @@ void *qdp_longlink[4];
 void *fatlink;
 void *longlink;
 
-#ifdef MULTI_GPU
-void** ghost_fatlink, **ghost_longlink;
-#endif
+void **ghost_fatlink = nullptr, **ghost_longlink = nullptr;
 
 
-QudaPrecision cpu_prec = QUDA_DOUBLE_PRECISION;
 
 cpuColorSpinorField* in;
 cpuColorSpinorField* out;
@@ -179,7 +174,7 @@ invert_test(void)
   fatlink = malloc(4 * V * gauge_site_size * host_gauge_data_type_size);
   longlink = malloc(4 * V * gauge_site_size * host_gauge_data_type_size);
 
-  construct_fat_long_gauge_field(qdp_fatlink, qdp_longlink, 1, gaugeParam.cpu_prec,
+  constructFatLongGaugeField(qdp_fatlink, qdp_longlink, 1, gaugeParam.cpu_prec,
 				 &gaugeParam, dslash_type);
 
   for(int dir=0; dir<4; ++dir){
@@ -335,16 +330,34 @@ invert_test(void)
 
 
 
-#ifdef MULTI_GPU
-      // matdagmat_mg4dir(ref, qdp_fatlink, qdp_longlink, ghost_fatlink, ghost_longlink,
-      // out, mass, 0, inv_param.cpu_prec, gaugeParam.cpu_prec, tmp, QUDA_EVEN_PARITY);
-#else
-      matdagmat(ref->V(), qdp_fatlink, qdp_longlink, out->V(), mass, 0, inv_param.cpu_prec, gaugeParam.cpu_prec, tmp->V(), QUDA_EVEN_PARITY);
-#endif
+      {
+        // check all solutions at once, with the sources as the fifth dimension
+        ColorSpinorParam msrcParam(csParam);
+        msrcParam.x[4] = inv_param.num_src;
+        cpuColorSpinorField inMsrc(msrcParam), outMsrc(msrcParam), refMsrc(msrcParam), tmpMsrc(msrcParam);
+
+        const size_t bytes = Vh * my_spinor_site_size * inv_param.cpu_prec;
+        for (int i = 0; i < inv_param.num_src; i++) {
+          memcpy((char *)inMsrc.V() + i * bytes, inArray[i], bytes);
+          memcpy((char *)outMsrc.V() + i * bytes, outArray[i], bytes);
+        }
 
-      mxpy(in->V(), ref->V(), Vh * my_spinor_site_size, inv_param.cpu_prec);
-      nrm2 = norm_2(ref->V(), Vh * my_spinor_site_size, inv_param.cpu_prec);
-      src2 = norm_2(in->V(), Vh * my_spinor_site_size, inv_param.cpu_prec);
+        staggeredMatDagMat(&refMsrc, qdp_fatlink, qdp_longlink, ghost_fatlink, ghost_longlink, &outMsrc, mass, 0,
+                           inv_param.cpu_prec, gaugeParam.cpu_prec, &tmpMsrc, QUDA_EVEN_PARITY, dslash_type);
+
+        for (int i = 0; i < inv_param.num_src; i++) {
+          void *refi = (char *)refMsrc.V() + i * bytes;
+          double nrm2_i = mxpy_norm_2(inArray[i], refi, Vh * my_spinor_site_size, inv_param.cpu_prec);
+          double src2_i = norm_2(inArray[i], Vh * my_spinor_site_size, inv_param.cpu_prec);
+          printfQuda("Source %d residuals: (L2 relative) tol %g, host = %g\n", i, inv_param.tol, sqrt(nrm2_i / src2_i));
+          if (sqrt(nrm2_i / src2_i) > 10 * inv_param.tol) ret |= 1;
+          if (i == 0) {
+            memcpy(ref->V(), refi, bytes);
+            nrm2 = nrm2_i;
+            src2 = src2_i;
+          }
+        }
+      }
 
       for(int i=1; i < inv_param.num_src;i++) delete spinorOutArray[i];
       for(int i=1; i < inv_param.num_src;i++) delete spinorInArray[i];
@@ -365,14 +378,9 @@ invert_test(void)
       time0 += clock(); // stop the timer
       time0 /= CLOCKS_PER_SEC;
 
-#ifdef MULTI_GPU
-      // matdagmat_mg4dir(ref, qdp_fatlink, qdp_longlink, ghost_fatlink, ghost_longlink,
-      // out, mass, 0, inv_param.cpu_prec, gaugeParam.cpu_prec, tmp, QUDA_ODD_PARITY);
-#else
-      matdagmat(ref->V(), qdp_fatlink, qdp_longlink, out->V(), mass, 0, inv_param.cpu_prec, gaugeParam.cpu_prec, tmp->V(), QUDA_ODD_PARITY);
-#endif
-      mxpy(in->V(), ref->V(), Vh * my_spinor_site_size, inv_param.cpu_prec);
-      nrm2 = norm_2(ref->V(), Vh * my_spinor_site_size, inv_param.cpu_prec);
+      staggeredMatDagMat(ref, qdp_fatlink, qdp_longlink, ghost_fatlink, ghost_longlink, out, mass, 0, inv_param.cpu_prec,
+                         gaugeParam.cpu_prec, tmp, QUDA_ODD_PARITY, dslash_type);
+      nrm2 = mxpy_norm_2(in->V(), ref->V(), Vh * my_spinor_site_size, inv_param.cpu_prec);
       src2 = norm_2(in->V(), Vh * my_spinor_site_size, inv_param.cpu_prec);
 
       break;
@@ -419,7 +427,6 @@ invert_test(void)
 
         invertMultiShiftQuda(outArray, in->V(), &inv_param);
 
-        cudaDeviceSynchronize();
         time0 += clock(); // stop the timer
         time0 /= CLOCKS_PER_SEC;
 
@@ -443,16 +450,10 @@ invert_test(void)
         }
         for(int i=0;i < inv_param.num_offset;i++){
           printfQuda("%dth solution: mass=%f, ", i, masses[i]);
-#ifdef MULTI_GPU
-          // matdagmat_mg4dir(ref, qdp_fatlink, qdp_longlink, ghost_fatlink, ghost_longlink,
-          //     spinorOutArray[i], masses[i], 0, inv_param.cpu_prec,
-          //     gaugeParam.cpu_prec, tmp, parity);
-#else
-          matdagmat(ref->V(), qdp_fatlink, qdp_longlink, outArray[i], masses[i], 0, inv_param.cpu_prec, gaugeParam.cpu_prec, tmp->V(), parity);
-#endif
+          staggeredMatDagMat(ref, qdp_fatlink, qdp_longlink, ghost_fatlink, ghost_longlink, spinorOutArray[i],
+                             masses[i], 0, inv_param.cpu_prec, gaugeParam.cpu_prec, tmp, parity, dslash_type);
 
-          mxpy(in->V(), ref->V(), len * my_spinor_site_size, inv_param.cpu_prec);
-          double nrm2 = norm_2(ref->V(), len * my_spinor_site_size, inv_param.cpu_prec);
+          double nrm2 = mxpy_norm_2(in->V(), ref->V(), len * my_spinor_site_size, inv_param.cpu_prec);
           double src2 = norm_2(in->V(), len * my_spinor_site_size, inv_param.cpu_prec);
           double hqr = sqrt(blas::HeavyQuarkResidualNorm(*spinorOutArray[i], *ref).z);
           double l2r = sqrt(nrm2 / src2);
@@ -1,73 +1,378 @@
 #include <host_utils.h>
+#include <host_blas.h>
 #include <stdio.h>
 #include <comm_quda.h>
 
-template <typename Float>
-inline void aXpY(Float a, Float *x, Float *y, int len)
+#include <algorithm>
+#include <cmath>
+
+namespace quda
 {
-  for(int i=0; i < len; i++){ y[i] += a*x[i]; }
-}
 
-void axpy(double a, void *x, void *y, int len, QudaPrecision precision) { 
-  if( precision == QUDA_DOUBLE_PRECISION ) aXpY(a, (double *)x, (double *)y, len);
-  else aXpY((float)a, (float *)x, (float *)y, len);
-}
+  namespace host_blas
+  {
 
-// performs the operation x[i] *= a
-template <typename Float>
-inline void aX(Float a, Float *x, int len) {
-  for (int i=0; i<len; i++) x[i] *= a;
+    // Reductions sum chunk_size elements directly, in a vectorized
+    // loop, and combine the chunk sums with compensated summation over
+    // blocks of block_size elements, one block per task.  The block
+    // sums are then combined in order, so the result is the same for
+    // any number of threads.  Blocks are kept small so that there are
+    // enough of them to keep every thread busy at modest volumes; the
+    // block boundaries are fixed, so this does not affect the result.
+    constexpr size_t chunk_size = 1024;
+    constexpr size_t block_size = 16 * chunk_size;
+
+    /**
+       @brief Kahan-Babuska (Neumaier) compensated sum
+     */
+    class CompensatedSum
+    {
+      double sum = 0.0;
+      double c = 0.0;
+
+    public:
+      void operator+=(double x)
+      {
+        double t = sum + x;
+        c += std::abs(sum) >= std::abs(x) ? (sum - t) + x : (x - t) + sum;
+        sum = t;
+      }
+
+      double value() const { return sum + c; }
+    };
+
+    /**
+       @brief Reduce nsum quantities over n elements.  The functor
+       chunk(sum, begin, end) adds the contribution of elements [begin,
+       end) to sum[0, nsum), where begin and end are multiples of the
+       chunk size (bar the last end).
+     */
+    template <typename Chunk> static void reduce(double *result, int nsum, size_t n, Chunk chunk)
+    {
+      const long n_block = (n + block_size - 1) / block_size;
+      std::vector<double> partial(n_block * nsum);
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+      for (long b = 0; b < n_block; b++) {
+        std::vector<CompensatedSum> block_sum(nsum);
+        std::vector<double> sum(nsum);
+        const size_t end = std::min(n, (b + 1) * block_size);
+        for (size_t begin = b * block_size; begin < end; begin += chunk_size) {
+          std::fill(sum.begin(), sum.end(), 0.0);
+          chunk(sum.data(), begin, std::min(end, begin + chunk_size));
+          for (int k = 0; k < nsum; k++) block_sum[k] += sum[k];
+        }
+        for (int k = 0; k < nsum; k++) partial[b * nsum + k] = block_sum[k].value();
+      }
+
+      for (int k = 0; k < nsum; k++) {
+        CompensatedSum total;
+        for (long b = 0; b < n_block; b++) total += partial[b * nsum + k];
+        result[k] = total.value();
+      }
+      comm_allreduce_array(result, nsum);
+    }
+
+    template <typename Float> void ax(double a, Float *x, size_t n)
+    {
+      const Float a_ = a;
+#ifdef _OPENMP
+#pragma omp parallel for simd
+#endif
+      for (size_t i = 0; i < n; i++) x[i] *= a_;
+    }
+
+    template <typename Float> void axpy(double a, const Float *x, Float *y, size_t n)
+    {
+      const Float a_ = a;
+#ifdef _OPENMP
+#pragma omp parallel for simd
+#endif
+      for (size_t i = 0; i < n; i++) y[i] += a_ * x[i];
+    }
+
+    template <typename Float> void xpay(const Float *x, double a, Float *y, size_t n)
+    {
+      const Float a_ = a;
+#ifdef _OPENMP
+#pragma omp parallel for simd
+#endif
+      for (size_t i = 0; i < n; i++) y[i] = x[i] + a_ * y[i];
+    }
+
+    template <typename Float> void mxpy(const Float *x, Float *y, size_t n)
+    {
+#ifdef _OPENMP
+#pragma omp parallel for simd
+#endif
+      for (size_t i = 0; i < n; i++) y[i] -= x[i];
+    }
+
+    template <typename Float> void caxpy(const Complex &a, const Float *x, Float *y, size_t n)
+    {
+      const Float a_re = a.real(), a_im = a.imag();
+#ifdef _OPENMP
+#pragma omp parallel for simd
+#endif
+      for (size_t i = 0; i < n; i += 2) {
+        Float x_re = x[i], x_im = x[i + 1];
+        y[i + 0] += a_re * x_re - a_im * x_im;
+        y[i + 1] += a_re * x_im + a_im * x_re;
+      }
+    }
+
+    template <typename Float> void cxpay(const Float *x, const Complex &a, Float *y, size_t n)
+    {
+      const Float a_re = a.real(), a_im = a.imag();
+#ifdef _OPENMP
+#pragma omp parallel for simd
+#endif
+      for (size_t i = 0; i < n; i += 2) {
+        Float y_re = y[i], y_im = y[i + 1];
+        y[i + 0] = x[i + 0] + a_re * y_re - a_im * y_im;
+        y[i + 1] = x[i + 1] + a_re * y_im + a_im * y_re;
+      }
+    }
+
+    template <typename Float> double norm2(const Float *x, size_t n)
+    {
+      double result;
+      reduce(&result, 1, n, [=](double *sum, size_t begin, size_t end) {
+        double s = 0.0;
+#ifdef _OPENMP
+#pragma omp simd reduction(+ : s)
+#endif
+        for (size_t i = begin; i < end; i++) s += (double)x[i] * x[i];
+        sum[0] += s;
+      });
+      return result;
+    }
+
+    template <typename Float> double reDotProduct(const Float *x, const Float *y, size_t n)
+    {
+      double result;
+      reduce(&result, 1, n, [=](double *sum, size_t begin, size_t end) {
+        double s = 0.0;
+#ifdef _OPENMP
+#pragma omp simd reduction(+ : s)
+#endif
+        for (size_t i = begin; i < end; i++) s += (double)x[i] * y[i];
+        sum[0] += s;
+      });
+      return result;
+    }
+
+    template <typename Float> Complex cDotProduct(const Float *x, const Float *y, size_t n)
+    {
+      double result[2];
+      reduce(result, 2, n, [=](double *sum, size_t begin, size_t end) {
+        double re = 0.0, im = 0.0;
+#ifdef _OPENMP
+#pragma omp simd reduction(+ : re, im)
+#endif
+        for (size_t i = begin; i < end; i += 2) {
+          re += (double)x[i] * y[i] + (double)x[i + 1] * y[i + 1];
+          im += (double)x[i] * y[i + 1] - (double)x[i + 1] * y[i];
+        }
+        sum[0] += re;
+        sum[1] += im;
+      });
+      return Complex(result[0], result[1]);
+    }
+
+    template <typename Float> double axpyNorm(double a, const Float *x, Float *y, size_t n)
+    {
+      const Float a_ = a;
+      double result;
+      reduce(&result, 1, n, [=](double *sum, size_t begin, size_t end) {
+        double s = 0.0;
+#ifdef _OPENMP
+#pragma omp simd reduction(+ : s)
+#endif
+        for (size_t i = begin; i < end; i++) {
+          y[i] += a_ * x[i];
+          s += (double)y[i] * y[i];
+        }
+        sum[0] += s;
+      });
+      return result;
+    }
+
+    template <typename Float> double xmyNorm(const Float *x, Float *y, size_t n)
+    {
+      double result;
+      reduce(&result, 1, n, [=](double *sum, size_t begin, size_t end) {
+        double s = 0.0;
+#ifdef _OPENMP
+#pragma omp simd reduction(+ : s)
+#endif
+        for (size_t i = begin; i < end; i++) {
+          y[i] = x[i] - y[i];
+          s += (double)y[i] * y[i];
+        }
+        sum[0] += s;
+      });
+      return result;
+    }
+
+    template <typename Float> Complex caxpyDotzy(const Complex &a, const Float *x, Float *y, const Float *z, size_t n)
+    {
+      const Float a_re = a.real(), a_im = a.imag();
+      double result[2];
+      reduce(result, 2, n, [=](double *sum, size_t begin, size_t end) {
+        double re = 0.0, im = 0.0;
+#ifdef _OPENMP
+#pragma omp simd reduction(+ : re, im)
+#endif
+        for (size_t i = begin; i < end; i += 2) {
+          Float x_re = x[i], x_im = x[i + 1];
+          y[i + 0] += a_re * x_re - a_im * x_im;
+          y[i + 1] += a_re * x_im + a_im * x_re;
+          re += (double)z[i] * y[i] + (double)z[i + 1] * y[i + 1];
+          im += (double)z[i] * y[i + 1] - (double)z[i + 1] * y[i];
+        }
+        sum[0] += re;
+        sum[1] += im;
+      });
+      return Complex(result[0], result[1]);
+    }
+
+    // The block products walk the vectors one chunk at a time and form
+    // every product of the chunk while it is resident in cache, so each
+    // vector is read from memory only once.
+    template <typename Float>
+    void reDotProduct(double *result, const std::vector<Float *> &x, const std::vector<Float *> &y, size_t n)
+    {
+      const int nx = x.size(), ny = y.size();
+      reduce(result, nx * ny, n, [&](double *sum, size_t begin, size_t end) {
+        for (int i = 0; i < nx; i++) {
+          for (int j = 0; j < ny; j++) {
+            const Float *a = x[i], *b = y[j];
+            double s = 0.0;
+#ifdef _OPENMP
+#pragma omp simd reduction(+ : s)
+#endif
+            for (size_t k = begin; k < end; k++) s += (double)a[k] * b[k];
+            sum[i * ny + j] += s;
+          }
+        }
+      });
+    }
+
+    template <typename Float>
+    void cDotProduct(Complex *result, const std::vector<Float *> &x, const std::vector<Float *> &y, size_t n)
+    {
+      const int nx = x.size(), ny = y.size();
+      std::vector<double> result_(2 * nx * ny);
+      reduce(result_.data(), 2 * nx * ny, n, [&](double *sum, size_t begin, size_t end) {
+        for (int i = 0; i < nx; i++) {
+          for (int j = 0; j < ny; j++) {
+            const Float *a = x[i], *b = y[j];
+            double re = 0.0, im = 0.0;
+#ifdef _OPENMP
+#pragma omp simd reduction(+ : re, im)
+#endif
+            for (size_t k = begin; k < end; k += 2) {
+              re += (double)a[k] * b[k] + (double)a[k + 1] * b[k + 1];
+              im += (double)a[k] * b[k + 1] - (double)a[k + 1] * b[k];
+            }
+            sum[2 * (i * ny + j) + 0] += re;
+            sum[2 * (i * ny + j) + 1] += im;
+          }
+        }
+      });
+      for (int k = 0; k < nx * ny; k++) result[k] = Complex(result_[2 * k], result_[2 * k + 1]);
+    }
+
+#define INSTANTIATE(Float)                                                                                             \
+  template void ax<Float>(double, Float *, size_t);                                                                    \
+  template void axpy<Float>(double, const Float *, Float *, size_t);                                                   \
+  template void xpay<Float>(const Float *, double, Float *, size_t);                                                   \
+  template void mxpy<Float>(const Float *, Float *, size_t);                                                           \
+  template void caxpy<Float>(const Complex &, const Float *, Float *, size_t);                                         \
+  template void cxpay<Float>(const Float *, const Complex &, Float *, size_t);                                         \
+  template double norm2<Float>(const Float *, size_t);                                                                 \
+  template double reDotProduct<Float>(const Float *, const Float *, size_t);                                           \
+  template Complex cDotProduct<Float>(const Float *, const Float *, size_t);                                           \
+  template double axpyNorm<Float>(double, const Float *, Float *, size_t);                                             \
+  template double xmyNorm<Float>(const Float *, Float *, size_t);                                                      \
+  template Complex caxpyDotzy<Float>(const Complex &, const Float *, Float *, const Float *, size_t);                   \
+  template void reDotProduct<Float>(double *, const std::vector<Float *> &, const std::vector<Float *> &, size_t);     \
+  template void cDotProduct<Float>(Complex *, const std::vector<Float *> &, const std::vector<Float *> &, size_t);
+
+    INSTANTIATE(double)
+    INSTANTIATE(float)
+
+#undef INSTANTIATE
+
+  } // namespace host_blas
+
+} // namespace quda
+
+using namespace quda;
+
+void axpy(double a, void *x, void *y, int len, QudaPrecision precision)
+{
+  if (precision == QUDA_DOUBLE_PRECISION)
+    host_blas::axpy(a, (double *)x, (double *)y, len);
+  else
+    host_blas::axpy(a, (float *)x, (float *)y, len);
 }
 
-void ax(double a, void *x, int len, QudaPrecision precision) {
-  if (precision == QUDA_DOUBLE_PRECISION) aX(a, (double*)x, len);
-  else aX((float)a, (float*)x, len);
+// performs the operation x[i] *= a
+void ax(double a, void *x, int len, QudaPrecision precision)
+{
+  if (precision == QUDA_DOUBLE_PRECISION)
+    host_blas::ax(a, (double *)x, len);
+  else
+    host_blas::ax(a, (float *)x, len);
 }
 
 // performs the operation y[i] -= x[i] (minus x plus y)
-template <typename Float>
-inline void mXpY(Float *x, Float *y, int len) {
-  for (int i=0; i<len; i++) y[i] -= x[i];
+void mxpy(void *x, void *y, int len, QudaPrecision precision)
+{
+  if (precision == QUDA_DOUBLE_PRECISION)
+    host_blas::mxpy((double *)x, (double *)y, len);
+  else
+    host_blas::mxpy((float *)x, (float *)y, len);
 }
 
-void mxpy(void* x, void* y, int len, QudaPrecision precision) {
-  if (precision == QUDA_DOUBLE_PRECISION) mXpY((double*)x, (double*)y, len);
-  else mXpY((float*)x, (float*)y, len);
+// performs the operation y[i] -= x[i] and returns the square of the L2 norm of y
+double mxpy_norm_2(void *x, void *y, int len, QudaPrecision precision)
+{
+  if (precision == QUDA_DOUBLE_PRECISION)
+    return host_blas::axpyNorm(-1.0, (double *)x, (double *)y, len);
+  else
+    return host_blas::axpyNorm(-1.0, (float *)x, (float *)y, len);
 }
 
-
 // returns the square of the L2 norm of the vector
-template <typename Float>
-inline double norm2(Float *v, int len) {
-  double sum=0.0;
-  for (int i=0; i<len; i++) sum += v[i]*v[i];
-  comm_allreduce(&sum);
-  return sum;
-}
-
-double norm_2(void *v, int len, QudaPrecision precision) {
-  if (precision == QUDA_DOUBLE_PRECISION) return norm2((double*)v, len);
-  else return norm2((float*)v, len);
+double norm_2(void *v, int len, QudaPrecision precision)
+{
+  if (precision == QUDA_DOUBLE_PRECISION)
+    return host_blas::norm2((double *)v, len);
+  else
+    return host_blas::norm2((float *)v, len);
 }
 
 // performs the operation y[i] = x[i] + a*y[i]
-template <typename Float>
-static inline void xpay(Float *x, Float a, Float *y, int len) {
-  for (int i=0; i<len; i++) y[i] = x[i] + a*y[i];
-}
-
-void xpay(void *x, double a, void *y, int length, QudaPrecision precision) {
-  if (precision == QUDA_DOUBLE_PRECISION) xpay((double*)x, a, (double*)y, length);
-  else xpay((float*)x, (float)a, (float*)y, length);
+void xpay(void *x, double a, void *y, int length, QudaPrecision precision)
+{
+  if (precision == QUDA_DOUBLE_PRECISION)
+    host_blas::xpay((double *)x, a, (double *)y, length);
+  else
+    host_blas::xpay((float *)x, a, (float *)y, length);
 }
 
 void cxpay(void *x, double _Complex a, void *y, int length, QudaPrecision precision)
 {
-  if (precision == QUDA_DOUBLE_PRECISION) {
-    xpay((double _Complex *)x, (double _Complex)a, (double _Complex *)y, length / 2);
-  } else {
-    xpay((float _Complex *)x, (float _Complex)a, (float _Complex *)y, length / 2);
-  }
+  const Complex a_(__real__ a, __imag__ a);
+  if (precision == QUDA_DOUBLE_PRECISION)
+    host_blas::cxpay((double *)x, a_, (double *)y, length);
+  else
+    host_blas::cxpay((float *)x, a_, (float *)y, length);
 }
 
 // CPU-style BLAS routines for staggered
@@ -76,10 +381,16 @@ void cpu_axy(QudaPrecision prec, double a, void *x, void *y, int size)
   if (prec == QUDA_DOUBLE_PRECISION) {
     double *dst = (double *)y;
     double *src = (double *)x;
+#ifdef _OPENMP
+#pragma omp parallel for simd
+#endif
     for (int i = 0; i < size; i++) { dst[i] = a * src[i]; }
   } else { // QUDA_SINGLE_PRECISION
     float *dst = (float *)y;
     float *src = (float *)x;
+#ifdef _OPENMP
+#pragma omp parallel for simd
+#endif
     for (int i = 0; i < size; i++) { dst[i] = a * src[i]; }
   }
 }
@@ -87,12 +398,8 @@ void cpu_axy(QudaPrecision prec, double a, void *x, void *y, int size)
 void cpu_xpy(QudaPrecision prec, void *x, void *y, int size)
 {
   if (prec == QUDA_DOUBLE_PRECISION) {
-    double *dst = (double *)y;
-    double *src = (double *)x;
-    for (int i = 0; i < size; i++) { dst[i] += src[i]; }
+    host_blas::axpy(1.0, (double *)x, (double *)y, size);
   } else { // QUDA_SINGLE_PRECISION
-    float *dst = (float *)y;
-    float *src = (float *)x;
-    for (int i = 0; i < size; i++) { dst[i] += src[i]; }
+    host_blas::axpy(1.0, (float *)x, (float *)y, size);
   }
 }
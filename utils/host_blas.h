@@ -0,0 +1,108 @@
+#pragma once
+
+#include <complex>
+#include <vector>
+
+/**
+   @file host_blas.h
+
+   @brief BLAS routines for host fields, used by the reference
+   operators and the verification code.  The names follow blas_quda.h,
+   but the routines act on raw arrays of n real numbers, with complex
+   data stored as interleaved (real, imaginary) pairs.  The streaming
+   kernels are OpenMP parallel and vectorized.
+
+   Reductions are accumulated in double precision in fixed-size chunks
+   whose partial sums are combined with compensated summation, so the
+   result is accurate for very large fields and does not depend on the
+   number of threads.  All reductions are global, i.e., summed over all
+   processes.
+ */
+
+namespace quda
+{
+
+  namespace host_blas
+  {
+
+    using Complex = std::complex<double>;
+
+    /**
+       @brief x = a * x
+     */
+    template <typename Float> void ax(double a, Float *x, size_t n);
+
+    /**
+       @brief y += a * x
+     */
+    template <typename Float> void axpy(double a, const Float *x, Float *y, size_t n);
+
+    /**
+       @brief y = x + a * y
+     */
+    template <typename Float> void xpay(const Float *x, double a, Float *y, size_t n);
+
+    /**
+       @brief y -= x
+     */
+    template <typename Float> void mxpy(const Float *x, Float *y, size_t n);
+
+    /**
+       @brief y += a * x, for complex a, x and y
+     */
+    template <typename Float> void caxpy(const Complex &a, const Float *x, Float *y, size_t n);
+
+    /**
+       @brief y = x + a * y, for complex a, x and y
+     */
+    template <typename Float> void cxpay(const Float *x, const Complex &a, Float *y, size_t n);
+
+    /**
+       @brief Return ||x||^2
+     */
+    template <typename Float> double norm2(const Float *x, size_t n);
+
+    /**
+       @brief Return Re(x, y)
+     */
+    template <typename Float> double reDotProduct(const Float *x, const Float *y, size_t n);
+
+    /**
+       @brief Return (x, y) = sum conj(x_i) y_i
+     */
+    template <typename Float> Complex cDotProduct(const Float *x, const Float *y, size_t n);
+
+    /**
+       @brief y += a * x, returning ||y||^2
+     */
+    template <typename Float> double axpyNorm(double a, const Float *x, Float *y, size_t n);
+
+    /**
+       @brief y = x - y, returning ||y||^2
+     */
+    template <typename Float> double xmyNorm(const Float *x, Float *y, size_t n);
+
+    /**
+       @brief y += a * x, returning (z, y)
+     */
+    template <typename Float> Complex caxpyDotzy(const Complex &a, const Float *x, Float *y, const Float *z, size_t n);
+
+    /**
+       @brief Block real dot product, result[i * y.size() + j] =
+       Re(x_i, y_j).  All the products are accumulated in a single
+       pass over the vectors.
+     */
+    template <typename Float>
+    void reDotProduct(double *result, const std::vector<Float *> &x, const std::vector<Float *> &y, size_t n);
+
+    /**
+       @brief Block complex dot product, result[i * y.size() + j] =
+       (x_i, y_j).  All the products are accumulated in a single pass
+       over the vectors.
+     */
+    template <typename Float>
+    void cDotProduct(Complex *result, const std::vector<Float *> &x, const std::vector<Float *> &y, size_t n);
+
+  } // namespace host_blas
+
+} // namespace quda
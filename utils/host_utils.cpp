@@ -1,4 +1,5 @@
 #include <complex>
+#include <memory>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -285,6 +286,7 @@ void initComms(int argc, char **argv, int *const commDims)
 
 void finalizeComms()
 {
+  freeNeighborTables();
 #if defined(QMP_COMMS)
   QMP_finalize_msg_passing();
 #elif defined(MPI_COMMS)
@@ -555,6 +557,83 @@ int neighborIndexFullLattice_mg(int i, int dx4, int dx3, int dx2, int dx1)
   return ret;
 }
 
+NeighborTable::NeighborTable(const int X_[4], int parity, int nhop, const bool partitioned_[4]) :
+  parity(parity), nhop(nhop)
+{
+  for (int d = 0; d < 4; d++) {
+    X[d] = X_[d];
+    partitioned[d] = partitioned_[d];
+  }
+  const int volume_cb = X[0] * X[1] * X[2] * X[3] / 2;
+  for (int d = 0; d < 4; d++) face_volume_cb[d] = volume_cb / X[d];
+  table.resize(8 * volume_cb);
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (int i = 0; i < volume_cb; i++) {
+    int Y = fullLatticeIndex(X, i, parity);
+    int x[4] = {Y % X[0], (Y / X[0]) % X[1], (Y / (X[1] * X[0])) % X[2], Y / (X[2] * X[1] * X[0])};
+
+    for (int dir = 0; dir < 8; dir++) {
+      const int d = dir / 2;
+      int y[4] = {x[0], x[1], x[2], x[3]};
+      y[d] += (dir % 2 == 0) ? nhop : -nhop;
+
+      Neighbor &n = table[8 * i + dir];
+      if ((y[d] < 0 || y[d] >= X[d]) && partitioned[d]) {
+        // lexicographic index of the remaining coordinates within the face
+        int face_idx = 0;
+        for (int e = 3; e >= 0; e--)
+          if (e != d) face_idx = face_idx * X[e] + y[e];
+        n.idx = face_idx / 2;
+        n.depth = y[d] < 0 ? -y[d] - 1 : y[d] - X[d];
+      } else {
+        y[d] = ((y[d] % X[d]) + X[d]) % X[d];
+        n.idx = (((y[3] * X[2] + y[2]) * X[1] + y[1]) * X[0] + y[0]) / 2;
+        n.depth = -1;
+      }
+    }
+  }
+}
+
+bool NeighborTable::matches(const int X_[4], int parity_, int nhop_, const bool partitioned_[4]) const
+{
+  if (parity != parity_ || nhop != nhop_) return false;
+  for (int d = 0; d < 4; d++)
+    if (X[d] != X_[d] || partitioned[d] != partitioned_[d]) return false;
+  return true;
+}
+
+static std::vector<std::unique_ptr<NeighborTable>> neighbor_tables;
+
+const NeighborTable &getNeighborTable(const int X[4], int parity, int nhop, bool ghost)
+{
+  bool partitioned[4] = {false, false, false, false};
+#ifdef MULTI_GPU
+  if (ghost)
+    for (int d = 0; d < 4; d++) partitioned[d] = comm_dim_partitioned(d);
+#endif
+
+  for (auto &table : neighbor_tables)
+    if (table->matches(X, parity, nhop, partitioned)) return *table;
+
+  neighbor_tables.emplace_back(new NeighborTable(X, parity, nhop, partitioned));
+  if (getVerbosity() >= QUDA_DEBUG_VERBOSE)
+    printfQuda("Built neighbor table for X = %d %d %d %d, parity = %d, nhop = %d: %lu bytes (cache total %lu bytes)\n",
+               X[0], X[1], X[2], X[3], parity, nhop, neighbor_tables.back()->bytes(), neighborTableCacheBytes());
+  return *neighbor_tables.back();
+}
+
+size_t neighborTableCacheBytes()
+{
+  size_t bytes = 0;
+  for (auto &table : neighbor_tables) bytes += table->bytes();
+  return bytes;
+}
+
+void freeNeighborTables() { neighbor_tables.clear(); }
+
 // X indexes the lattice site
 void printSpinorElement(void *spinor, int X, QudaPrecision precision)
 {
@@ -922,7 +1001,6 @@ int fullLatticeIndex_4d(int i, int oddBit) {
 // to oddBit = {0, 1}), returns the corresponding full lattice index.
 // Cf. GPGPU code in dslash_core_ante.h.
 // There, i is the thread index sid.
-// This function is used by neighborIndex_5d in dslash_reference.cpp.
 //ok
 int fullLatticeIndex_5d(int i, int oddBit) {
   int boundaryCrossings = i/(Z[0]/2) + i/(Z[1]*Z[0]/2) + i/(Z[2]*Z[1]*Z[0]/2) + i/(Z[3]*Z[2]*Z[1]*Z[0]/2);
@@ -138,6 +138,117 @@ int neighborIndexFullLattice(int dim[], int index, int dx[]);
 int neighborIndex_mg(int i, int oddBit, int dx4, int dx3, int dx2, int dx1);
 int neighborIndexFullLattice_mg(int i, int dx4, int dx3, int dx2, int dx1);
 
+/**
+   @brief Precomputed neighbors of every checkerboard site of one
+   parity of a four-dimensional lattice, at a fixed hop distance, for
+   each of the eight hop directions (0/1 = +/-X, 2/3 = +/-Y, 4/5 =
+   +/-Z, 6/7 = +/-T).  A hop that leaves the lattice in a partitioned
+   dimension lands in the ghost zone of the forward (even dir) or
+   backward (odd dir) halo of that dimension; otherwise the lattice
+   is periodic.  Tables are obtained from getNeighborTable, which
+   builds each one once and caches it.
+ */
+class NeighborTable
+{
+
+public:
+  struct Neighbor {
+    int idx;   /** checkerboard index of the neighbor in the body, or within its ghost face */
+    int depth; /** -1 for a body neighbor, else how many faces into the ghost zone it lies */
+  };
+
+private:
+  int X[4];
+  int parity;
+  int nhop;
+  bool partitioned[4];
+  int face_volume_cb[4];
+  std::vector<Neighbor> table;
+
+public:
+  NeighborTable(const int X[4], int parity, int nhop, const bool partitioned[4]);
+
+  /**
+     @brief Whether this table was built for the given configuration
+   */
+  bool matches(const int X[4], int parity, int nhop, const bool partitioned[4]) const;
+
+  /**
+     @brief Neighbor of checkerboard site i in direction dir.  A body
+     neighbor has the opposite parity to i when nhop is odd.
+   */
+  const Neighbor &neighbor(int i, int dir) const { return table[8 * i + dir]; }
+
+  /**
+     @brief Offset in sites of a ghost neighbor within the halo buffer
+     of direction dir, where the buffer holds nFace faces each made of
+     Ls slices of checkerboarded face sites, ordered from the
+     outermost face inwards for the backward halo.
+     @param[in] n Neighbor as returned by neighbor(), with depth >= 0
+     @param[in] dir Hop direction
+     @param[in] nFace Number of faces in the halo buffer
+     @param[in] Ls Number of slices per face (fifth dimension or sources)
+     @param[in] s The slice of the site we are hopping from
+   */
+  int ghostOffset(const Neighbor &n, int dir, int nFace, int Ls = 1, int s = 0) const
+  {
+    int face = dir % 2 == 0 ? n.depth : nFace - 1 - n.depth;
+    return (face * Ls + s) * face_volume_cb[dir / 2] + n.idx;
+  }
+
+  size_t bytes() const { return table.size() * sizeof(Neighbor); }
+};
+
+/**
+   @brief Return the cached neighbor table for the given local lattice
+   dimensions, parity and hop distance, building it on first use.
+   @param[in] X Local lattice dimensions
+   @param[in] parity Parity of the sites we are hopping from
+   @param[in] nhop Hop distance
+   @param[in] ghost Whether hops that leave a partitioned dimension
+   should land in the ghost zone (MULTI_GPU builds only); if false the
+   lattice is always treated as periodic
+ */
+const NeighborTable &getNeighborTable(const int X[4], int parity, int nhop = 1, bool ghost = true);
+
+/**
+   @brief Return the memory in bytes used by all cached neighbor tables
+ */
+size_t neighborTableCacheBytes();
+
+/**
+   @brief Release all cached neighbor tables
+ */
+void freeNeighborTables();
+
+/**
+   @brief Periodic neighbors of the full (even sites followed by odd
+   sites) lattice, backed by the cached tables of both parities.
+ */
+class FullLatticeNeighborTable
+{
+  const NeighborTable *table[2];
+  int volume_cb;
+  int nhop;
+
+public:
+  FullLatticeNeighborTable(const int X[4], int nhop = 1) :
+    table {&getNeighborTable(X, 0, nhop, false), &getNeighborTable(X, 1, nhop, false)},
+    volume_cb(X[0] * X[1] * X[2] * X[3] / 2),
+    nhop(nhop)
+  {
+  }
+
+  /**
+     @brief Full-lattice index of the neighbor of full-lattice site i in direction dir
+   */
+  int operator()(int i, int dir) const
+  {
+    int parity = i >= volume_cb ? 1 : 0;
+    return table[parity]->neighbor(i - parity * volume_cb, dir).idx + (parity ^ (nhop & 1)) * volume_cb;
+  }
+};
+
 void printSpinorElement(void *spinor, int X, QudaPrecision precision);
 void printGaugeElement(void *gauge, int X, QudaPrecision precision);
 template <typename Float> void printVector(Float *v);
@@ -195,6 +306,7 @@ void exchange_llfat_cleanup(void);
 // Implemented in host_blas.cpp
 double norm_2(void *vector, int len, QudaPrecision precision);
 void mxpy(void *x, void *y, int len, QudaPrecision precision);
+double mxpy_norm_2(void *x, void *y, int len, QudaPrecision precision);
 void ax(double a, void *x, int len, QudaPrecision precision);
 void axpy(double a, void *x, void *y, int len, QudaPrecision precision);
 void xpay(void *x, double a, void *y, int len, QudaPrecision precision);
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <host_su3.h>
+
 template <typename real> struct su3_matrix {
   std::complex<real> e[3][3];
 };
@@ -24,46 +26,24 @@ void llfat_scalar_mult_add_su3_matrix(su3_matrix *a, su3_matrix *b, Real s, su3_
     for (int j = 0; j < 3; j++) { c->e[i][j] = a->e[i][j] + s * b->e[i][j]; }
 }
 
+// std::complex is layout compatible with the interleaved complex
+// storage of the host_su3.h primitives
 template <typename su3_matrix> void llfat_mult_su3_na(su3_matrix *a, su3_matrix *b, su3_matrix *c)
 {
-  typename std::remove_reference<decltype(a->e[0][0])>::type x, y;
-  for (int i = 0; i < 3; i++)
-    for (int j = 0; j < 3; j++) {
-      x = 0.0;
-      for (int k = 0; k < 3; k++) {
-        y = a->e[i][k] * conj(b->e[j][k]);
-        x += y;
-      }
-      c->e[i][j] = x;
-    }
+  using Float = typename std::remove_reference<decltype(a->e[0][0])>::type::value_type;
+  su3MatMat<false, true>((Float *)c, (Float *)a, (Float *)b);
 }
 
 template <typename su3_matrix> void llfat_mult_su3_nn(su3_matrix *a, su3_matrix *b, su3_matrix *c)
 {
-  typename std::remove_reference<decltype(a->e[0][0])>::type x, y;
-  for (int i = 0; i < 3; i++)
-    for (int j = 0; j < 3; j++) {
-      x = 0.0;
-      for (int k = 0; k < 3; k++) {
-        y = a->e[i][k] * b->e[k][j];
-        x += y;
-      }
-      c->e[i][j] = x;
-    }
+  using Float = typename std::remove_reference<decltype(a->e[0][0])>::type::value_type;
+  su3MatMat<false, false>((Float *)c, (Float *)a, (Float *)b);
 }
 
 template <typename su3_matrix> void llfat_mult_su3_an(su3_matrix *a, su3_matrix *b, su3_matrix *c)
 {
-  typename std::remove_reference<decltype(a->e[0][0])>::type x, y;
-  for (int i = 0; i < 3; i++)
-    for (int j = 0; j < 3; j++) {
-      x = 0.0;
-      for (int k = 0; k < 3; k++) {
-        y = conj(a->e[k][i]) * b->e[k][j];
-        x += y;
-      }
-      c->e[i][j] = x;
-    }
+  using Float = typename std::remove_reference<decltype(a->e[0][0])>::type::value_type;
+  su3MatMat<true, false>((Float *)c, (Float *)a, (Float *)b);
 }
 
 template <typename su3_matrix> void llfat_add_su3_matrix(su3_matrix *a, su3_matrix *b, su3_matrix *c)
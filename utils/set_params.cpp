@@ -1250,7 +1250,8 @@ void setQudaStaggeredInvTestParams()
 
   } else {
 
-    if (test_type == 0 && (inv_type == QUDA_CG_INVERTER || inv_type == QUDA_PCG_INVERTER)
+    if (test_type == 0
+        && (inv_type == QUDA_CG_INVERTER || inv_type == QUDA_PCG_INVERTER || inv_type == QUDA_PIPELINED_CG_INVERTER)
         && solve_type != QUDA_NORMOP_SOLVE && solve_type != QUDA_DIRECT_PC_SOLVE) {
       warningQuda("The full spinor staggered operator (test 0) can't be inverted with (P)CG. Switching to BiCGstab.\n");
       inv_type = QUDA_BICGSTAB_INVERTER;